@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "ad_mathematics.h"
+#include "CancellationToken.h"
+#include "DesignMatrix.h"
+#include "GaussianDistribution.h"
+#include "GeneralizedLinearModel.h"
+#include "PoissonDistribution.h"
+
+struct adm_design {
+    DesignMatrix matrix;
+};
+
+struct adm_glm {
+    std::unique_ptr<RegressionModels::GeneralizedLinearModel> model;
+};
+
+namespace {
+    thread_local std::string lastError;
+
+    template<typename TBody>
+    adm_status Guard(const TBody &body)
+    {
+        try {
+            body();
+            lastError.clear();
+            return ADM_OK;
+        }
+        catch (const Threading::OperationCanceledException &exception) {
+            lastError = exception.what();
+            return ADM_ERROR_CANCELED;
+        }
+        catch (const std::invalid_argument &exception) {
+            lastError = exception.what();
+            return ADM_ERROR_ARGUMENT;
+        }
+        catch (const std::out_of_range &exception) {
+            lastError = exception.what();
+            return ADM_ERROR_ARGUMENT;
+        }
+        catch (const std::domain_error &exception) {
+            lastError = exception.what();
+            return ADM_ERROR_NUMERIC;
+        }
+        catch (const std::exception &exception) {
+            lastError = exception.what();
+            return ADM_ERROR_INTERNAL;
+        }
+        catch (...) {
+            lastError = "Unknown error.";
+            return ADM_ERROR_INTERNAL;
+        }
+    }
+
+    std::vector<double> Gather(const double *data, const ptrdiff_t stride, const size_t count, const double fallback)
+    {
+        if (data == nullptr) {
+            return std::vector<double>(count, fallback);
+        }
+
+        std::vector<double> result(count);
+
+        for (size_t i = 0; i < count; i++) {
+            result[i] = data[static_cast<ptrdiff_t>(i) * stride];
+        }
+
+        return result;
+    }
+}
+
+uint32_t adm_abi_version(void)
+{
+    return ADM_ABI_VERSION;
+}
+
+const char *adm_last_error(void)
+{
+    return lastError.c_str();
+}
+
+adm_status adm_design_create(const size_t rows, const size_t columns, const double *const *column_data, const ptrdiff_t *strides, const int add_constant, adm_design **out)
+{
+    return Guard(
+            [&]() {
+                if (out == nullptr || (columns != 0 && column_data == nullptr)) {
+                    throw std::invalid_argument("Arguments must not be null.");
+                }
+
+                std::vector<const double *> pointers(column_data, column_data + columns);
+                std::vector<std::ptrdiff_t> steps(columns, 1);
+
+                if (strides != nullptr) {
+                    steps.assign(strides, strides + columns);
+                }
+
+                *out = new adm_design{DesignMatrix::Wrap(rows, std::move(pointers), std::move(steps), add_constant != 0)};
+            });
+}
+
+adm_status adm_design_create_strided(const size_t rows, const size_t columns, const double *data, const ptrdiff_t row_stride, const ptrdiff_t column_stride, const int add_constant, adm_design **out)
+{
+    return Guard(
+            [&]() {
+                if (out == nullptr || (rows != 0 && columns != 0 && data == nullptr)) {
+                    throw std::invalid_argument("Arguments must not be null.");
+                }
+
+                std::vector<const double *> pointers(columns);
+                std::vector<std::ptrdiff_t> steps(columns, row_stride);
+
+                for (size_t j = 0; j < columns; j++) {
+                    pointers[j] = data + static_cast<ptrdiff_t>(j) * column_stride;
+                }
+
+                *out = new adm_design{DesignMatrix::Wrap(rows, std::move(pointers), std::move(steps), add_constant != 0)};
+            });
+}
+
+void adm_design_free(adm_design *design)
+{
+    delete design;
+}
+
+adm_status adm_glm_fit(const adm_design *design, const double *response, const ptrdiff_t response_stride, const double *weights, const ptrdiff_t weight_stride, const adm_family family, const size_t max_iterations, const double tolerance, adm_glm **out)
+{
+    return Guard(
+            [&]() {
+                if (design == nullptr || response == nullptr || out == nullptr) {
+                    throw std::invalid_argument("Arguments must not be null.");
+                }
+
+                std::unique_ptr<IDistribution> distribution;
+
+                switch (family) {
+                    case ADM_FAMILY_GAUSSIAN:
+                        distribution = std::make_unique<Distributions::GaussianDistribution>();
+                        break;
+                    case ADM_FAMILY_POISSON:
+                        distribution = std::make_unique<Distributions::PoissonDistribution>();
+                        break;
+                    default:
+                        throw std::invalid_argument("Unknown family.");
+                }
+
+                RegressionModels::FitOptions options;
+
+                if (max_iterations != 0) {
+                    options.MaxIterations = max_iterations;
+                }
+                if (tolerance > 0.0) {
+                    options.Tolerance = tolerance;
+                }
+
+                const size_t rows = design->matrix.RowCount();
+
+                // Response and weights are copied once: every IRLS iteration allocates vectors of this length anyway.
+                const std::vector<double> y = Gather(response, response_stride, rows, 0.0);
+                const std::vector<double> w = Gather(weights, weight_stride, rows, 1.0);
+
+                auto model = std::make_unique<RegressionModels::GeneralizedLinearModel>(design->matrix, y, w, std::move(distribution), options);
+
+                *out = new adm_glm{std::move(model)};
+            });
+}
+
+void adm_glm_free(adm_glm *model)
+{
+    delete model;
+}
+
+size_t adm_glm_observation_count(const adm_glm *model)
+{
+    return model == nullptr ? 0 : model->model->ObservationCount();
+}
+
+size_t adm_glm_variable_count(const adm_glm *model)
+{
+    return model == nullptr ? 0 : model->model->VariableCount();
+}
+
+size_t adm_glm_iterations(const adm_glm *model)
+{
+    return model == nullptr ? 0 : model->model->Iterations();
+}
+
+int adm_glm_converged(const adm_glm *model)
+{
+    return model != nullptr && model->model->Converged() ? 1 : 0;
+}
+
+double adm_glm_deviance(const adm_glm *model)
+{
+    return model == nullptr ? 0.0 : model->model->Deviance();
+}
+
+adm_status adm_glm_coefficients(const adm_glm *model, double *out, const size_t length)
+{
+    return Guard(
+            [&]() {
+                if (model == nullptr || out == nullptr) {
+                    throw std::invalid_argument("Arguments must not be null.");
+                }
+
+                const std::vector<double> coefficients = model->model->Coefficients();
+
+                if (length < coefficients.size()) {
+                    throw std::out_of_range("Output array is too short.");
+                }
+
+                std::copy(coefficients.begin(), coefficients.end(), out);
+            });
+}
+
+adm_status adm_glm_standard_errors(const adm_glm *model, double *out, const size_t length)
+{
+    return Guard(
+            [&]() {
+                if (model == nullptr || out == nullptr) {
+                    throw std::invalid_argument("Arguments must not be null.");
+                }
+
+                const std::vector<double> errors = model->model->StandardErrorsOls();
+
+                if (errors.empty()) {
+                    throw std::domain_error("The model has no covariance.");
+                }
+                if (length < errors.size()) {
+                    throw std::out_of_range("Output array is too short.");
+                }
+
+                std::copy(errors.begin(), errors.end(), out);
+            });
+}
+
+adm_status adm_glm_covariance(const adm_glm *model, double *out, const size_t length)
+{
+    return Guard(
+            [&]() {
+                if (model == nullptr || out == nullptr) {
+                    throw std::invalid_argument("Arguments must not be null.");
+                }
+
+                const std::vector<double> covariance = model->model->Covariance();
+                const double dispersion = model->model->Dispersion();
+
+                if (covariance.empty()) {
+                    throw std::domain_error("The model has no covariance.");
+                }
+                if (length < covariance.size()) {
+                    throw std::out_of_range("Output array is too short.");
+                }
+
+                std::transform(covariance.begin(), covariance.end(), out, [dispersion](const double value) { return dispersion * value; });
+            });
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+/*
+ * A stable C interface to the library for foreign-language callers.
+ *
+ * All objects are opaque handles created and destroyed through this interface. Designs wrap caller-owned buffers
+ * without copying them, so those buffers must stay alive and unmodified until the design is freed. Results are written
+ * into arrays provided by the caller. No function lets a C++ exception escape; failures are reported through
+ * adm_status and described by adm_last_error().
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* The library is built with ADM_BUILDING defined, so it exports the functions that its callers import. */
+#if defined(_WIN32) && defined(ADM_BUILDING)
+#define ADM_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define ADM_API __declspec(dllimport)
+#else
+#define ADM_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Incremented whenever a declaration in this header changes incompatibly. */
+#define ADM_ABI_VERSION 1
+
+typedef enum adm_status {
+    ADM_OK = 0,
+    ADM_ERROR_ARGUMENT = 1,
+    ADM_ERROR_NUMERIC = 2,
+    ADM_ERROR_CANCELED = 3,
+    ADM_ERROR_INTERNAL = 4
+} adm_status;
+
+typedef enum adm_family {
+    ADM_FAMILY_GAUSSIAN = 0,
+    ADM_FAMILY_POISSON = 1
+} adm_family;
+
+typedef struct adm_design adm_design;
+
+typedef struct adm_glm adm_glm;
+
+/* Returns ADM_ABI_VERSION as compiled into the library. */
+ADM_API uint32_t adm_abi_version(void);
+
+/* Describes the last failure on the calling thread. The string is valid until the next call on that thread. */
+ADM_API const char *adm_last_error(void);
+
+/*
+ * Wraps column buffers: column j of observation i is columns[j][i * strides[j]]. Strides are in elements and may be
+ * NULL for contiguous columns. A non-zero add_constant prepends a column of ones.
+ */
+ADM_API adm_status adm_design_create(size_t rows, size_t columns, const double *const *column_data, const ptrdiff_t *strides, int add_constant, adm_design **out);
+
+/*
+ * Wraps a single two-dimensional buffer: element (i, j) is data[i * row_stride + j * column_stride], in elements.
+ * This covers both row-major and column-major arrays, including non-contiguous slices.
+ */
+ADM_API adm_status adm_design_create_strided(size_t rows, size_t columns, const double *data, ptrdiff_t row_stride, ptrdiff_t column_stride, int add_constant, adm_design **out);
+
+ADM_API void adm_design_free(adm_design *design);
+
+/*
+ * Fits a generalized linear model. The response and weights are read with the given strides (in elements); weights
+ * may be NULL for unit weights. A max_iterations of zero and a tolerance of zero select the defaults.
+ */
+ADM_API adm_status adm_glm_fit(const adm_design *design, const double *response, ptrdiff_t response_stride, const double *weights, ptrdiff_t weight_stride, adm_family family, size_t max_iterations, double tolerance, adm_glm **out);
+
+ADM_API void adm_glm_free(adm_glm *model);
+
+ADM_API size_t adm_glm_observation_count(const adm_glm *model);
+
+ADM_API size_t adm_glm_variable_count(const adm_glm *model);
+
+ADM_API size_t adm_glm_iterations(const adm_glm *model);
+
+ADM_API int adm_glm_converged(const adm_glm *model);
+
+ADM_API double adm_glm_deviance(const adm_glm *model);
+
+/* Writes the coefficients into out, which must hold at least adm_glm_variable_count() values. */
+ADM_API adm_status adm_glm_coefficients(const adm_glm *model, double *out, size_t length);
+
+/*
+ * Writes the standard errors of the coefficients into out, which must hold at least adm_glm_variable_count() values.
+ * Fails with ADM_ERROR_NUMERIC if the fit ran no iteration.
+ */
+ADM_API adm_status adm_glm_standard_errors(const adm_glm *model, double *out, size_t length);
+
+/*
+ * Writes the estimated covariance of the coefficients, the dispersion times (X'WX)^-1, row-major into out, which must
+ * hold at least the square of adm_glm_variable_count() values. Its diagonal is the square of adm_glm_standard_errors().
+ * Fails with ADM_ERROR_NUMERIC if the fit ran no iteration.
+ */
+ADM_API adm_status adm_glm_covariance(const adm_glm *model, double *out, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,44 @@
+#include <math.h>
+#include "c_caller.h"
+
+adm_status c_caller_fit(const double *design, size_t rows, size_t columns, const double *response, adm_family family, double *coefficients, double *standard_errors, double *covariance)
+{
+    adm_design *matrix = NULL;
+    adm_glm *model = NULL;
+    size_t k = columns + 1;
+    size_t j;
+    adm_status status;
+
+    if (adm_abi_version() != ADM_ABI_VERSION) {
+        return ADM_ERROR_INTERNAL;
+    }
+
+    status = adm_design_create_strided(rows, columns, design, (ptrdiff_t) columns, 1, 1, &matrix);
+
+    if (status == ADM_OK) {
+        status = adm_glm_fit(matrix, response, 1, NULL, 0, family, 0, 0.0, &model);
+    }
+    if (status == ADM_OK && adm_glm_variable_count(model) != k) {
+        status = ADM_ERROR_INTERNAL;
+    }
+    if (status == ADM_OK) {
+        status = adm_glm_coefficients(model, coefficients, k);
+    }
+    if (status == ADM_OK) {
+        status = adm_glm_standard_errors(model, standard_errors, k);
+    }
+    if (status == ADM_OK) {
+        status = adm_glm_covariance(model, covariance, k * k);
+    }
+
+    for (j = 0; status == ADM_OK && j < k; j++) {
+        if (fabs(covariance[j * k + j] - standard_errors[j] * standard_errors[j]) > 1e-12 * covariance[j * k + j]) {
+            status = ADM_ERROR_NUMERIC;
+        }
+    }
+
+    adm_glm_free(model);
+    adm_design_free(matrix);
+
+    return status;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+/*
+ * A caller of the C interface written in C, so that the build compiles the header as C and main.cpp can compare what a
+ * foreign-language caller sees with the C++ result.
+ */
+
+#include "ad_mathematics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Fits a model with a constant to a row-major design through the C interface. The outputs hold columns + 1 values,
+ * and (columns + 1)^2 for the covariance. Returns the first failure, or ADM_ERROR_NUMERIC if the diagonal of the
+ * covariance is not the square of the standard errors.
+ */
+adm_status c_caller_fit(const double *design, size_t rows, size_t columns, const double *response, adm_family family, double *coefficients, double *standard_errors, double *covariance);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,9 +1,21 @@
+#include <algorithm>
 #include <limits>
+#include <numeric>
 #include <random>
+#include <stdexcept>
 #include "GaussianDistribution.h"
 #include "IdentityLinkFunction.h"
+#include "Kernels.h"
+#include "ThreadPool.h"
 
 namespace Distributions {
+    namespace {
+        /// <summary>
+        /// The number of deviance terms summed by one call of the kernel.
+        /// </summary>
+        const std::size_t ReductionBlock = 256;
+    }
+
     GaussianDistribution::GaussianDistribution(const double mean, const double standardDeviation, std::unique_ptr<ILinkFunction> link)
             : _entropy(0.5 * (1.0 + log(2.0 * M_PI * standardDeviation * standardDeviation))),
               _kurtosis(0),
@@ -21,18 +33,50 @@ namespace Distributions {
 
     const double GaussianDistribution::Deviance(const std::vector<double> &response, const std::vector<double> &meanResponse, const std::vector<double> &weights, const double scale) const
     {
-        if (response.size() != meanResponse.size() || response.size() != weights.size()) {
+        return Deviance(response, meanResponse, weights, scale, ValidityMask());
+    }
+
+    const double GaussianDistribution::Deviance(const std::vector<double> &response, const std::vector<double> &meanResponse, const std::vector<double> &weights, const double scale, const ValidityMask &valid) const
+    {
+        if (response.size() != meanResponse.size() || response.size() != weights.size() || (valid.RowCount() != 0 && valid.RowCount() != response.size())) {
             throw std::out_of_range("Argument vectors differ in length.");
         }
         if (scale <= 0.0) {
             throw std::out_of_range("Scale must be greater than zero.");
         }
 
-        double result = 0.0;
+        const bool masked = valid.RowCount() != 0;
 
-        for (auto r = response.begin(), m = meanResponse.begin(); r != response.end(); ++r, ++m) {
-            result += *r * pow(*r - *m, 2);
-        }
+        const double result = Threading::ThreadPool::Instance().ParallelReduce(
+                0,
+                response.size(),
+                Threading::ThreadPool::DefaultGrain,
+                0.0,
+                [&](std::size_t first, std::size_t last) -> double {
+                    const Kernels::KernelTable &kernels = Kernels::Active();
+
+                    double terms[ReductionBlock];
+                    double sum = 0.0;
+
+                    for (std::size_t row = first; row < last; row += ReductionBlock) {
+                        const std::size_t count = std::min(ReductionBlock, last - row);
+
+                        if (masked && valid.CountValid(row, count) == 0) {
+                            continue;
+                        }
+
+                        for (std::size_t i = 0, j = row; i < count; i++, j++) {
+                            const double residual = response[j] - meanResponse[j];
+
+                            terms[i] = masked && !valid[j] ? 0.0 : weights[j] * residual * residual;
+                        }
+
+                        sum += kernels.Sum(terms, count);
+                    }
+
+                    return sum;
+                },
+                std::plus<double>());
 
         return result / scale;
     }
@@ -43,20 +87,35 @@ namespace Distributions {
     }
 
     const std::vector<double> GaussianDistribution::InitialMean(const std::vector<double> &response) const
+    {
+        return InitialMean(response, ValidityMask());
+    }
+
+    const std::vector<double> GaussianDistribution::InitialMean(const std::vector<double> &response, const ValidityMask &valid) const
     {
         if (response.empty()) {
             throw std::out_of_range("Argument vector is empty.");
         }
+        if (valid.RowCount() != 0 && valid.RowCount() != response.size()) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        const bool masked = valid.RowCount() != 0;
 
-        double mean = std::accumulate(response.begin(), response.end(), 0.0) / response.size();
+        double sum = 0.0;
+        for (std::size_t i = 0; i < response.size(); i++) {
+            if (!masked || valid[i]) {
+                sum += response[i];
+            }
+        }
+
+        const double mean = sum / (masked ? valid.ValidCount() : response.size());
 
         std::vector<double> initialMean(response.size());
 
-        std::transform(
-                response.begin(),
-                response.end(),
-                initialMean.begin(),
-                [mean](double x) -> double { return 0.5 * (x + mean); });
+        for (std::size_t i = 0; i < response.size(); i++) {
+            initialMean[i] = !masked || valid[i] ? 0.5 * (response[i] + mean) : mean;
+        }
 
         return initialMean;
     }
@@ -82,11 +141,15 @@ namespace Distributions {
 
         std::vector<double> derivative = _link->FirstDerivative(meanResponse);
 
-        std::transform(
-                derivative.begin(),
-                derivative.end(),
-                weight.begin(),
-                [inverseVariance = 1.0 / Variance()](double x) -> double { return inverseVariance * pow(x, 2); });
+        Threading::ThreadPool::Instance().ParallelFor(
+                0,
+                derivative.size(),
+                Threading::ThreadPool::DefaultGrain,
+                [&, inverseVariance = 1.0 / Variance()](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; i++) {
+                        weight[i] = inverseVariance / pow(derivative[i], 2);
+                    }
+                });
 
         return weight;
     }
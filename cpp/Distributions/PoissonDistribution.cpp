@@ -1,12 +1,24 @@
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <numeric>
 #include <random>
+#include <stdexcept>
 #include <utility>
 #include "PoissonDistribution.h"
 #include "LogLinkFunction.h"
 #include "Factorial.h"
+#include "Kernels.h"
+#include "ThreadPool.h"
 
 namespace Distributions {
+    namespace {
+        /// <summary>
+        /// The number of deviance terms evaluated by one call of each kernel.
+        /// </summary>
+        const std::size_t ReductionBlock = 256;
+    }
+
     PoissonDistribution::PoissonDistribution(const double mean, std::unique_ptr<ILinkFunction> link)
             : _entropy(0.5 * log(2 * M_PI * M_E * mean)
                        - 1.0 / (12.0 * mean)
@@ -28,17 +40,52 @@ namespace Distributions {
     const double
     PoissonDistribution::Deviance(const std::vector<double> &response, const std::vector<double> &meanResponse, const std::vector<double> &weights, double scale) const
     {
-        if (response.size() != meanResponse.size() || response.size() != weights.size()) {
+        return Deviance(response, meanResponse, weights, scale, ValidityMask());
+    }
+
+    const double
+    PoissonDistribution::Deviance(const std::vector<double> &response, const std::vector<double> &meanResponse, const std::vector<double> &weights, double scale, const ValidityMask &valid) const
+    {
+        if (response.size() != meanResponse.size() || response.size() != weights.size() || (valid.RowCount() != 0 && valid.RowCount() != response.size())) {
             throw std::out_of_range("Argument vectors differ in length.");
         }
 
-        double result = 0.0;
+        const bool masked = valid.RowCount() != 0;
 
-        for (auto w = weights.begin(), r = response.begin(), m = meanResponse.begin(); w != weights.end(); ++w, ++r, ++m) {
-            const double d = log(*r <= 0 ? std::numeric_limits<double>::epsilon() : *r / *m);
+        const double result = Threading::ThreadPool::Instance().ParallelReduce(
+                0,
+                response.size(),
+                Threading::ThreadPool::DefaultGrain,
+                0.0,
+                [&](std::size_t first, std::size_t last) -> double {
+                    const Kernels::KernelTable &kernels = Kernels::Active();
 
-            result += *w * (*r * d - *r - *m);
-        }
+                    double terms[ReductionBlock];
+                    double sum = 0.0;
+
+                    for (std::size_t row = first; row < last; row += ReductionBlock) {
+                        const std::size_t count = std::min(ReductionBlock, last - row);
+
+                        if (masked && valid.CountValid(row, count) == 0) {
+                            continue;
+                        }
+
+                        for (std::size_t i = 0; i < count; i++) {
+                            terms[i] = response[row + i] <= 0 ? std::numeric_limits<double>::epsilon() : response[row + i] / meanResponse[row + i];
+                        }
+
+                        kernels.Logarithm(terms, count, terms);
+
+                        for (std::size_t i = 0, j = row; i < count; i++, j++) {
+                            terms[i] = masked && !valid[j] ? 0.0 : weights[j] * (response[j] * terms[i] - (response[j] - meanResponse[j]));
+                        }
+
+                        sum += kernels.Sum(terms, count);
+                    }
+
+                    return sum;
+                },
+                std::plus<double>());
 
         return 2.0 * result / scale;
     }
@@ -49,22 +96,35 @@ namespace Distributions {
     }
 
     const std::vector<double> PoissonDistribution::InitialMean(const std::vector<double> &response) const
+    {
+        return InitialMean(response, ValidityMask());
+    }
+
+    const std::vector<double> PoissonDistribution::InitialMean(const std::vector<double> &response, const ValidityMask &valid) const
     {
         if (response.empty()) {
             throw std::out_of_range("Argument vector is empty.");
         }
+        if (valid.RowCount() != 0 && valid.RowCount() != response.size()) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        const bool masked = valid.RowCount() != 0;
 
-        double mean = std::accumulate(response.begin(), response.end(), 0.0) / response.size();
+        double sum = 0.0;
+        for (std::size_t i = 0; i < response.size(); i++) {
+            if (!masked || valid[i]) {
+                sum += response[i];
+            }
+        }
+
+        const double mean = sum / (masked ? valid.ValidCount() : response.size());
 
         std::vector<double> initialMean(response.size());
 
-        std::transform(
-                response.begin(),
-                response.end(),
-                initialMean.begin(),
-                [mean](double x) -> double {
-                    return 0.5 * (x + mean);
-                });
+        for (std::size_t i = 0; i < response.size(); i++) {
+            initialMean[i] = !masked || valid[i] ? 0.5 * (response[i] + mean) : mean;
+        }
 
         return initialMean;
     }
@@ -104,9 +164,15 @@ namespace Distributions {
 
         std::vector<double> derivative = _link->FirstDerivative(weight);
 
-        for (auto w = weight.begin(), d = derivative.begin(); w != weight.end(); ++w, ++d) {
-            *w = 1.0 / (*w * pow(*d, 2));
-        }
+        Threading::ThreadPool::Instance().ParallelFor(
+                0,
+                weight.size(),
+                Threading::ThreadPool::DefaultGrain,
+                [&](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; i++) {
+                        weight[i] = 1.0 / (weight[i] * pow(derivative[i], 2));
+                    }
+                });
 
         return weight;
     }
@@ -10,6 +10,9 @@ namespace Distributions {
 
         explicit PoissonDistribution(double mean = 1.0, std::unique_ptr<ILinkFunction> link = nullptr);
 
+        const ILinkFunction &LinkFunction() const override
+        { return *_link; }
+
         const double Entropy() const override
         { return _entropy; }
 
@@ -60,6 +63,11 @@ namespace Distributions {
         /// </returns>
         const double Deviance(const std::vector<double> &response, const std::vector<double> &meanResponse, const std::vector<double> &weights, double scale) const override;
 
+        /// <summary>
+        /// Calculates the deviance over the valid observations only.
+        /// </summary>
+        const double Deviance(const std::vector<double> &response, const std::vector<double> &meanResponse, const std::vector<double> &weights, double scale, const ValidityMask &valid) const override;
+
         /// <summary>
         /// Provides an initial mean response array for the Iteratively Reweighted Least Squares (IRLS) algorithm.
         /// </summary>
@@ -71,6 +79,11 @@ namespace Distributions {
         /// </returns>
         const std::vector<double> InitialMean(const std::vector<double> &response) const override;
 
+        /// <summary>
+        /// Provides an initial mean response array from the valid observations only.
+        /// </summary>
+        const std::vector<double> InitialMean(const std::vector<double> &response, const ValidityMask &valid) const override;
+
         /// <summary>
         /// Calculates the weight for a step of the Iteratively Reweighted Least Squares (IRLS) algorithm.
         /// </summary>
@@ -0,0 +1,587 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include "ColumnPlan.h"
+#include "GaussianDistribution.h"
+#include "IdentityLinkFunction.h"
+#include "InteractionColumns.h"
+#include "PolynomialBasis.h"
+#include "SplineBasis.h"
+
+namespace Formulas {
+
+    namespace {
+        enum class Transform {
+            Identity,
+            Log,
+            Log1p,
+            Exp,
+            Sqrt,
+            Abs
+        };
+
+        struct Source {
+            const double *Values;
+
+            Transform Function;
+        };
+
+        inline double Apply(const Transform function, const double x)
+        {
+            switch (function) {
+                case Transform::Log:
+                    return log(x);
+                case Transform::Log1p:
+                    return log1p(x);
+                case Transform::Exp:
+                    return exp(x);
+                case Transform::Sqrt:
+                    return sqrt(x);
+                case Transform::Abs:
+                    return fabs(x);
+                default:
+                    return x;
+            }
+        }
+
+        /// <summary>
+        /// Columns that are products of transformed variables, evaluated for every column in one pass over a block.
+        /// </summary>
+        class ProductColumns : public IColumnGenerator {
+        public:
+
+            explicit ProductColumns(std::vector<std::vector<Source>> columns)
+                    : _columns(std::move(columns))
+            {
+            }
+
+            const std::size_t Width() const override
+            { return _columns.size(); }
+
+            /// <summary>
+            /// True if some column applies a function that may leave its domain, such as the log of zero.
+            /// </summary>
+            const bool IsTransformed() const
+            {
+                for (const std::vector<Source> &column : _columns) {
+                    for (const Source &source : column) {
+                        if (source.Function != Transform::Identity) {
+                            return true;
+                        }
+                    }
+                }
+
+                return false;
+            }
+
+            void Generate(const std::size_t first, const std::size_t count, double *block, const std::size_t stride) const override
+            {
+                for (std::size_t i = 0; i < count; i++) {
+                    double *row = block + i * stride;
+
+                    for (std::size_t j = 0; j < _columns.size(); j++) {
+                        double value = 1.0;
+
+                        for (const Source &source : _columns[j]) {
+                            value *= Apply(source.Function, source.Values[first + i]);
+                        }
+
+                        row[j] = value;
+                    }
+                }
+            }
+
+        private:
+
+            std::vector<std::vector<Source>> _columns;
+        };
+
+        /// <summary>
+        /// The columns of a design less their weighted means within the groups of a factor.
+        /// </summary>
+        class AbsorbedColumns : public IColumnGenerator {
+        public:
+
+            AbsorbedColumns(DesignMatrix design, std::vector<std::uint32_t> codes, std::vector<double> means)
+                    : _design(std::move(design)),
+                      _codes(std::move(codes)),
+                      _means(std::move(means))
+            {
+            }
+
+            const std::size_t Width() const override
+            { return _design.ColumnCount(); }
+
+            void Generate(const std::size_t first, const std::size_t count, double *block, const std::size_t stride) const override
+            {
+                const std::size_t k = _design.ColumnCount();
+
+                std::vector<double> scratch;
+
+                const double *rows = _design.Rows(first, count, scratch);
+
+                for (std::size_t i = 0; i < count; i++) {
+                    const double *mean = _means.data() + _codes[first + i] * k;
+
+                    for (std::size_t j = 0; j < k; j++) {
+                        block[i * stride + j] = rows[i * k + j] - mean[j];
+                    }
+                }
+            }
+
+        private:
+
+            DesignMatrix _design;
+
+            std::vector<std::uint32_t> _codes;
+
+            std::vector<double> _means;
+        };
+
+        Transform Parse(const Factor &factor)
+        {
+            static const std::vector<std::pair<std::string, Transform>> transforms = {
+                    {"",      Transform::Identity},
+                    {"log",   Transform::Log},
+                    {"log1p", Transform::Log1p},
+                    {"exp",   Transform::Exp},
+                    {"sqrt",  Transform::Sqrt},
+                    {"abs",   Transform::Abs}};
+
+            for (const std::pair<std::string, Transform> &transform : transforms) {
+                if (transform.first == factor.Function) {
+                    if (!factor.Arguments.empty()) {
+                        throw std::invalid_argument("Function '" + factor.Function + "' takes no arguments.");
+                    }
+
+                    return transform.second;
+                }
+            }
+
+            throw std::invalid_argument("Unknown function '" + factor.Function + "'.");
+        }
+
+        /// <summary>
+        /// Recodes a factor over the valid observations, dropping the levels that only invalid ones have. Invalid
+        /// observations take the first level.
+        /// </summary>
+        CategoricalColumn Restrict(const CategoricalColumn &column, const ValidityMask &valid)
+        {
+            if (valid.AllValid()) {
+                return column;
+            }
+
+            std::vector<bool> used(column.LevelCount(), false);
+
+            for (std::size_t i = 0; i < column.RowCount(); i++) {
+                if (valid[i]) {
+                    used[column[i]] = true;
+                }
+            }
+
+            std::vector<std::uint32_t> recoded(column.LevelCount(), 0);
+            std::vector<std::string> levels;
+
+            for (std::size_t level = 0; level < used.size(); level++) {
+                if (used[level]) {
+                    recoded[level] = static_cast<std::uint32_t>(levels.size());
+                    levels.push_back(column.Levels()[level]);
+                }
+            }
+
+            std::vector<std::uint32_t> codes(column.RowCount(), 0);
+
+            for (std::size_t i = 0; i < codes.size(); i++) {
+                if (valid[i]) {
+                    codes[i] = recoded[column[i]];
+                }
+            }
+
+            return CategoricalColumn(std::move(codes), std::move(levels));
+        }
+
+        bool IsBasis(const Factor &factor)
+        {
+            return factor.Function == "bs" || factor.Function == "ns" || factor.Function == "poly";
+        }
+
+        /// <summary>
+        /// The interior knots of a spline at evenly spaced quantiles of the valid values, and the boundary knots at the
+        /// extremes.
+        /// </summary>
+        std::vector<double> Knots(const std::vector<double> &values, const ValidityMask &valid, const std::size_t interior, double &lower, double &upper)
+        {
+            std::vector<double> sorted;
+            sorted.reserve(valid.ValidCount());
+
+            for (std::size_t i = 0; i < values.size(); i++) {
+                if (valid[i]) {
+                    sorted.push_back(values[i]);
+                }
+            }
+
+            if (sorted.empty()) {
+                throw std::invalid_argument("No observation is valid.");
+            }
+
+            std::sort(sorted.begin(), sorted.end());
+
+            lower = sorted.front();
+            upper = sorted.back();
+
+            std::vector<double> result;
+
+            for (std::size_t k = 1; k <= interior; k++) {
+                const double h = static_cast<double>(sorted.size() - 1) * static_cast<double>(k) / static_cast<double>(interior + 1);
+                const std::size_t below = static_cast<std::size_t>(h);
+                const double fraction = h - static_cast<double>(below);
+
+                result.push_back(below + 1 < sorted.size() ? sorted[below] + fraction * (sorted[below + 1] - sorted[below]) : sorted[below]);
+            }
+
+            return result;
+        }
+
+        std::shared_ptr<const IColumnGenerator> Basis(const Factor &factor, const std::vector<double> &values, const ValidityMask &valid, Threading::ThreadPool &pool)
+        {
+            if (factor.Arguments.size() != 1 || factor.Arguments[0] < 1.0 || factor.Arguments[0] != std::trunc(factor.Arguments[0])) {
+                throw std::invalid_argument("Function '" + factor.Function + "' takes a positive integral degree or degrees of freedom.");
+            }
+
+            const auto size = static_cast<std::size_t>(factor.Arguments[0]);
+
+            if (factor.Function == "poly") {
+                return std::make_shared<OrthogonalPolynomialBasis>(values.data(), 1, values.size(), size, valid, pool);
+            }
+
+            // A cubic B-spline without intercept has three columns more than interior knots, a natural spline one.
+            const std::size_t excess = factor.Function == "bs" ? 3 : 1;
+
+            if (size < excess) {
+                throw std::invalid_argument("Function '" + factor.Function + "' takes at least " + std::to_string(excess) + " degrees of freedom.");
+            }
+
+            double lower;
+            double upper;
+
+            const std::vector<double> knots = Knots(values, valid, size - excess, lower, upper);
+
+            if (factor.Function == "bs") {
+                return std::make_shared<BSplineBasis>(values.data(), 1, knots, lower, upper);
+            }
+
+            return std::make_shared<NaturalSplineBasis>(values.data(), 1, knots, lower, upper);
+        }
+    }
+
+    ColumnPlan::ColumnPlan(const Formula &formula, const Dataset &data, Threading::ThreadPool &pool)
+            : _absorbedLevels(0),
+              _design(Compile(formula, data, pool))
+    {
+    }
+
+    ColumnPlan::ColumnPlan(const std::string &formula, const Dataset &data, Threading::ThreadPool &pool)
+            : ColumnPlan(Formula::Parse(formula), data, pool)
+    {
+    }
+
+    DesignMatrix ColumnPlan::Compile(const Formula &formula, const Dataset &data, Threading::ThreadPool &pool)
+    {
+        const std::size_t n = data.RowCount();
+
+        if (formula.Absorb.size() > 1) {
+            throw std::invalid_argument("Only one absorbed factor is supported.");
+        }
+
+        const bool absorbed = !formula.Absorb.empty();
+        const bool constant = formula.Constant && !absorbed;
+
+        // Listwise deletion: the observations missing in any variable the formula references.
+        ValidityMask valid(n);
+
+        valid &= data.Validity(formula.Response.Variable);
+
+        if (!formula.Weight.empty()) {
+            valid &= data.Validity(formula.Weight);
+        }
+
+        for (const std::string &name : formula.Absorb) {
+            valid &= data.Validity(name);
+        }
+
+        for (const Term &term : formula.Terms) {
+            for (const Factor &factor : term.Factors) {
+                valid &= data.Validity(factor.Variable);
+            }
+        }
+
+        _weights = formula.Weight.empty() ? std::vector<double>(n, 1.0) : data.Numeric(formula.Weight);
+
+        const Transform responseTransform = Parse(formula.Response);
+        const std::vector<double> &responseValues = data.Numeric(formula.Response.Variable);
+
+        _response.resize(n);
+
+        for (std::size_t i = 0; i < n; i++) {
+            _response[i] = Apply(responseTransform, responseValues[i]);
+
+            if (!std::isfinite(_response[i])) {
+                valid.Clear(i);
+            }
+        }
+
+        // Transforms that leave their domain, such as the log of zero, delete the observation too. This is settled
+        // before any knot, polynomial or level is fitted to the valid observations.
+        for (const Term &term : formula.Terms) {
+            for (const Factor &factor : term.Factors) {
+                if (factor.Categorical || IsBasis(factor) || Parse(factor) == Transform::Identity) {
+                    continue;
+                }
+
+                const Transform transform = Parse(factor);
+                const std::vector<double> &values = data.Numeric(factor.Variable);
+
+                for (std::size_t i = 0; i < n; i++) {
+                    if (valid[i] && !std::isfinite(Apply(transform, values[i]))) {
+                        valid.Clear(i);
+                    }
+                }
+            }
+        }
+
+        if (valid.ValidCount() == 0) {
+            throw std::invalid_argument("No observation is valid.");
+        }
+
+        // The keys of the continuous terms that stand on their own, whose interactions keep every level.
+        std::vector<std::string> mainEffects;
+
+        for (const Term &term : formula.Terms) {
+            if (std::none_of(term.Factors.begin(), term.Factors.end(), [](const Factor &factor) { return factor.Categorical; })) {
+                mainEffects.push_back(term.ToString());
+            }
+        }
+
+        std::vector<std::vector<Source>> products;
+        std::vector<std::string> productNames;
+        std::vector<std::shared_ptr<const ProductColumns>> transformed;
+        std::vector<std::shared_ptr<const IColumnGenerator>> generators;
+        std::vector<std::string> generatorNames;
+
+        for (const Term &term : formula.Terms) {
+            std::vector<CategoricalColumn> factors;
+            std::vector<const Factor *> categorical;
+            std::vector<Source> sources;
+            Term continuous;
+            std::shared_ptr<const IColumnGenerator> basis;
+
+            for (const Factor &factor : term.Factors) {
+                if (factor.Categorical) {
+                    factors.push_back(Restrict(data.Categorical(factor.Variable), valid));
+                    categorical.push_back(&factor);
+                } else if (IsBasis(factor)) {
+                    if (basis != nullptr) {
+                        throw std::invalid_argument("A term may have only one basis expansion.");
+                    }
+
+                    basis = Basis(factor, data.Numeric(factor.Variable), valid, pool);
+                    continuous.Factors.push_back(factor);
+                } else {
+                    sources.push_back(Source{data.Numeric(factor.Variable).data(), Parse(factor)});
+                    continuous.Factors.push_back(factor);
+                }
+            }
+
+            if (basis != nullptr && !sources.empty()) {
+                throw std::invalid_argument("A basis expansion may not be multiplied by another continuous variable.");
+            }
+
+            const std::string continuousName = continuous.ToString();
+
+            std::vector<std::string> termNames;
+
+            if (basis != nullptr) {
+                for (std::size_t j = 1; j <= basis->Width(); j++) {
+                    termNames.push_back(continuousName + "[" + std::to_string(j) + "]");
+                }
+            } else if (!sources.empty()) {
+                termNames.push_back(continuousName);
+            }
+
+            if (factors.empty()) {
+                if (basis != nullptr) {
+                    generators.push_back(basis);
+                    generatorNames.insert(generatorNames.end(), termNames.begin(), termNames.end());
+                } else {
+                    products.push_back(std::move(sources));
+                    productNames.push_back(continuousName);
+                }
+
+                continue;
+            }
+
+            const bool dropReference = continuous.Factors.empty()
+                                       ? constant || absorbed
+                                       : std::find(mainEffects.begin(), mainEffects.end(), continuousName) != mainEffects.end();
+
+            std::shared_ptr<const InteractionColumns> interaction;
+
+            if (basis != nullptr) {
+                interaction = std::make_shared<InteractionColumns>(basis, std::move(factors), dropReference);
+            } else if (!sources.empty()) {
+                const std::shared_ptr<const ProductColumns> product = std::make_shared<ProductColumns>(std::vector<std::vector<Source>>{sources});
+
+                if (product->IsTransformed()) {
+                    transformed.push_back(product);
+                }
+
+                interaction = std::make_shared<InteractionColumns>(product, std::move(factors), dropReference);
+            } else {
+                interaction = std::make_shared<InteractionColumns>(std::move(factors), dropReference);
+            }
+
+            for (std::size_t cell = 0; cell < interaction->CellCount(); cell++) {
+                const std::vector<std::uint32_t> codes = interaction->Levels(cell);
+
+                std::string cellName;
+
+                for (std::size_t f = 0; f < codes.size(); f++) {
+                    cellName += (f == 0 ? "" : "#") + categorical[f]->Variable + "=" + interaction->Factors()[f].Levels()[codes[f]];
+                }
+
+                if (termNames.empty()) {
+                    generatorNames.push_back(cellName);
+                }
+
+                for (const std::string &name : termNames) {
+                    generatorNames.push_back(cellName + "#" + name);
+                }
+            }
+
+            generators.push_back(interaction);
+        }
+
+        if (!products.empty()) {
+            const std::shared_ptr<const ProductColumns> product = std::make_shared<ProductColumns>(std::move(products));
+
+            if (product->IsTransformed()) {
+                transformed.push_back(product);
+            }
+
+            generators.insert(generators.begin(), product);
+        }
+
+        // A product of transforms may still overflow; only the transformed columns are evaluated to find out.
+        for (const std::shared_ptr<const ProductColumns> &product : transformed) {
+            const std::size_t width = product->Width();
+
+            std::vector<double> block(DesignMatrix::BlockRows * width);
+
+            for (std::size_t first = 0; first < n; first += DesignMatrix::BlockRows) {
+                const std::size_t count = std::min(DesignMatrix::BlockRows, n - first);
+
+                product->Generate(first, count, block.data(), width);
+
+                for (std::size_t i = 0; i < count; i++) {
+                    if (valid[first + i] && !std::all_of(block.begin() + i * width, block.begin() + (i + 1) * width, [](double value) { return std::isfinite(value); })) {
+                        valid.Clear(first + i);
+                    }
+                }
+            }
+        }
+
+        if (valid.ValidCount() == 0) {
+            throw std::invalid_argument("No observation is valid.");
+        }
+
+        for (std::size_t i = 0; i < n; i++) {
+            if (!valid[i]) {
+                _response[i] = 0.0;
+                _weights[i] = 0.0;
+            }
+        }
+
+        if (constant) {
+            _columnNames.emplace_back("_cons");
+        }
+
+        _columnNames.insert(_columnNames.end(), productNames.begin(), productNames.end());
+        _columnNames.insert(_columnNames.end(), generatorNames.begin(), generatorNames.end());
+
+        DesignMatrix design = DesignMatrix::Wrap(n, {}, {}, generators, constant, pool);
+
+        design.SetMask(valid);
+
+        if (!absorbed) {
+            return design;
+        }
+
+        const CategoricalColumn groups = Restrict(data.Categorical(formula.Absorb[0]), valid);
+        const std::size_t k = design.ColumnCount();
+        const std::size_t g = groups.LevelCount();
+
+        std::vector<double> means(g * k, 0.0);
+        std::vector<double> responseMeans(g, 0.0);
+        std::vector<double> totals(g, 0.0);
+        std::vector<double> scratch;
+
+        for (std::size_t first = 0; first < n; first += DesignMatrix::BlockRows) {
+            const std::size_t count = std::min(DesignMatrix::BlockRows, n - first);
+            const double *rows = design.Rows(first, count, scratch);
+
+            for (std::size_t i = 0; i < count; i++) {
+                const std::size_t group = groups[first + i];
+                const double weight = _weights[first + i];
+
+                for (std::size_t j = 0; j < k; j++) {
+                    means[group * k + j] += weight * rows[i * k + j];
+                }
+
+                responseMeans[group] += weight * _response[first + i];
+                totals[group] += weight;
+            }
+        }
+
+        for (std::size_t group = 0; group < g; group++) {
+            const double scale = totals[group] > 0.0 ? 1.0 / totals[group] : 0.0;
+
+            for (std::size_t j = 0; j < k; j++) {
+                means[group * k + j] *= scale;
+            }
+
+            responseMeans[group] *= scale;
+        }
+
+        for (std::size_t i = 0; i < n; i++) {
+            _response[i] -= responseMeans[groups[i]];
+        }
+
+        _absorbedLevels = g;
+
+        DesignMatrix result = DesignMatrix::Wrap(n, {}, {}, {std::make_shared<AbsorbedColumns>(std::move(design), groups.Codes(), std::move(means))}, false, pool);
+
+        result.SetMask(std::move(valid));
+
+        return result;
+    }
+
+    RegressionModels::GeneralizedLinearModel ColumnPlan::Fit(std::unique_ptr<IDistribution> distribution, RegressionModels::FitOptions options) const
+    {
+        if (_absorbedLevels != 0) {
+            const bool linear = distribution == nullptr
+                                || (dynamic_cast<const Distributions::GaussianDistribution *>(distribution.get()) != nullptr
+                                    && dynamic_cast<const LinkFunctions::IdentityLinkFunction *>(&distribution->LinkFunction()) != nullptr);
+
+            if (!linear || options.Robust != nullptr) {
+                throw std::invalid_argument("Absorbed factors require a linear model without robust weights.");
+            }
+        }
+
+        options.AbsorbedLevels = _absorbedLevels;
+
+        return RegressionModels::GeneralizedLinearModel(_design, _response, _weights, std::move(distribution), options);
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Dataset.h"
+#include "DesignMatrix.h"
+#include "FitOptions.h"
+#include "Formula.h"
+#include "GeneralizedLinearModel.h"
+#include "IDistribution.h"
+#include "ThreadPool.h"
+
+namespace Formulas {
+
+    /// <summary>
+    /// A <see cref="Formula"/> compiled over a <see cref="Dataset"/> into a design of generated columns.
+    /// </summary>
+    /// <remarks>
+    /// No design column is materialized. The continuous terms, with their transforms and products, share one
+    /// generator that evaluates them in a single fused pass over each block of rows the kernels read; splines become
+    /// basis generators (see <see cref="BSplineBasis"/>); and terms with categorical factors become
+    /// <see cref="InteractionColumns"/> indexed by the factors' codes. The columns are the constant, the continuous
+    /// terms, and then the other terms in the order written.
+    ///
+    /// Categorical terms omit the reference level of each factor when the design has a constant or an absorbed
+    /// factor; a continuous variable by categorical term keeps every level unless the continuous part is also a term
+    /// of its own. An absorbed factor is swept out by weighted group demeaning: one pass over the design finds the
+    /// group means of every column, and the generated rows subtract them, so fits of the plan are within estimates.
+    /// Only a linear model, with a Gaussian response and identity link, may be fitted with an absorbed factor.
+    ///
+    /// Observations missing in any referenced variable, or whose transforms leave their domain, are deleted listwise:
+    /// the validity masks of the variables are combined word by word, and the design is masked (see
+    /// <see cref="DesignMatrix::SetMask"/>) rather than compacted. Deleted observations have zero weight and response.
+    /// </remarks>
+    class ColumnPlan {
+    public:
+
+        /// <param name="formula">
+        /// The formula.
+        /// </param>
+        /// <param name="data">
+        /// The variables named by the formula, which must outlive the plan.
+        /// </param>
+        /// <param name="pool">
+        /// The pool whose workers process the rows of the design.
+        /// </param>
+        /// <exception cref="std::invalid_argument">
+        /// The formula names a missing variable or an unknown function, or absorbs more than one factor.
+        /// </exception>
+        ColumnPlan(const Formula &formula, const Dataset &data, Threading::ThreadPool &pool = Threading::ThreadPool::Instance());
+
+        /// <summary>
+        /// Parses and compiles a formula.
+        /// </summary>
+        ColumnPlan(const std::string &formula, const Dataset &data, Threading::ThreadPool &pool = Threading::ThreadPool::Instance());
+
+        const DesignMatrix &Design() const
+        { return _design; }
+
+        const std::vector<double> &Response() const
+        { return _response; }
+
+        const std::vector<double> &Weights() const
+        { return _weights; }
+
+        /// <summary>
+        /// The name of each design column, such as log(dist) or exp=FRA#year=2001.
+        /// </summary>
+        const std::vector<std::string> &ColumnNames() const
+        { return _columnNames; }
+
+        /// <summary>
+        /// The number of observations left after listwise deletion.
+        /// </summary>
+        const std::size_t ValidRowCount() const
+        { return _design.ValidRowCount(); }
+
+        /// <summary>
+        /// The number of levels of the absorbed factor with a valid observation, or zero.
+        /// </summary>
+        const std::size_t AbsorbedLevels() const
+        { return _absorbedLevels; }
+
+        /// <summary>
+        /// Fits a generalized linear model to the plan, setting <see cref="FitOptions::AbsorbedLevels"/>.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">
+        /// A factor is absorbed but the model is not linear or has robust weights.
+        /// </exception>
+        RegressionModels::GeneralizedLinearModel Fit(
+                std::unique_ptr<IDistribution> distribution = nullptr,
+                RegressionModels::FitOptions options = RegressionModels::FitOptions()) const;
+
+    private:
+
+        DesignMatrix Compile(const Formula &formula, const Dataset &data, Threading::ThreadPool &pool);
+
+        std::vector<double> _response;
+
+        std::vector<double> _weights;
+
+        std::vector<std::string> _columnNames;
+
+        std::size_t _absorbedLevels;
+
+        /// <summary>
+        /// Declared last, so that compiling it may set the other members.
+        /// </summary>
+        DesignMatrix _design;
+    };
+}
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "Dataset.h"
+
+namespace Formulas {
+
+    void Dataset::Resize(const std::string &name, const std::size_t rowCount)
+    {
+        const std::size_t others = _numeric.size() + _categorical.size() - _numeric.count(name) - _categorical.count(name);
+
+        if (others != 0 && rowCount != _rowCount) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        _numeric.erase(name);
+        _categorical.erase(name);
+        _validity.erase(name);
+        _rowCount = rowCount;
+    }
+
+    void Dataset::Add(const std::string &name, std::vector<double> values)
+    {
+        Resize(name, values.size());
+
+        _validity.emplace(name, ValidityMask::Of(values));
+        _numeric.emplace(name, std::move(values));
+    }
+
+    void Dataset::Add(const std::string &name, CategoricalColumn values, ValidityMask validity)
+    {
+        if (validity.RowCount() == 0) {
+            validity = ValidityMask(values.RowCount());
+        }
+
+        if (validity.RowCount() != values.RowCount()) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        Resize(name, values.RowCount());
+
+        _validity.emplace(name, std::move(validity));
+        _categorical.emplace(name, std::move(values));
+    }
+
+    const ValidityMask &Dataset::Validity(const std::string &name) const
+    {
+        const auto found = _validity.find(name);
+
+        if (found == _validity.end()) {
+            throw std::invalid_argument("No variable '" + name + "'.");
+        }
+
+        return found->second;
+    }
+
+    const std::vector<double> &Dataset::Numeric(const std::string &name) const
+    {
+        const auto found = _numeric.find(name);
+
+        if (found == _numeric.end()) {
+            throw std::invalid_argument("No numeric variable '" + name + "'.");
+        }
+
+        return found->second;
+    }
+
+    CategoricalColumn Dataset::Categorical(const std::string &name) const
+    {
+        const auto found = _categorical.find(name);
+
+        if (found != _categorical.end()) {
+            return found->second;
+        }
+
+        if (!IsNumeric(name)) {
+            throw std::invalid_argument("No variable '" + name + "'.");
+        }
+
+        const std::vector<double> &values = Numeric(name);
+
+        std::vector<long> codes(values.size());
+
+        // Missing values take the smallest value, the first level, so that they add no level of their own.
+        double placeholder = std::numeric_limits<double>::infinity();
+
+        for (double value : values) {
+            placeholder = std::isnan(value) ? placeholder : std::min(placeholder, value);
+        }
+
+        placeholder = std::isinf(placeholder) ? 0.0 : placeholder;
+
+        for (std::size_t i = 0; i < values.size(); i++) {
+            if (std::isnan(values[i])) {
+                codes[i] = static_cast<long>(placeholder);
+                continue;
+            }
+
+            if (!std::isfinite(values[i]) || values[i] != std::trunc(values[i])) {
+                throw std::invalid_argument("Variable '" + name + "' is not integral.");
+            }
+
+            codes[i] = static_cast<long>(values[i]);
+        }
+
+        return CategoricalColumn(codes);
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+#include "CategoricalColumn.h"
+#include "ValidityMask.h"
+
+namespace Formulas {
+
+    /// <summary>
+    /// Named columns of equal length, numeric or categorical, over which a <see cref="ColumnPlan"/> is compiled.
+    /// </summary>
+    /// <remarks>
+    /// Plans view the numeric columns in place, so a dataset must outlive the plans compiled over it and must not gain
+    /// or replace columns while they are in use.
+    ///
+    /// Every column carries a <see cref="ValidityMask"/>. A numeric value is missing if it is NaN; a categorical
+    /// column is given its mask. A plan deletes the observations missing in any column it references, by masking
+    /// them rather than copying the rest.
+    /// </remarks>
+    class Dataset {
+    public:
+
+        Dataset() = default;
+
+        Dataset(const Dataset &) = delete;
+
+        Dataset &operator=(const Dataset &) = delete;
+
+        /// <summary>
+        /// Adds or replaces a numeric column.
+        /// </summary>
+        /// <exception cref="std::out_of_range">
+        /// The column differs in length from the others.
+        /// </exception>
+        void Add(const std::string &name, std::vector<double> values);
+
+        /// <summary>
+        /// Adds or replaces a categorical column.
+        /// </summary>
+        /// <param name="name">
+        /// The name of the variable.
+        /// </param>
+        /// <param name="values">
+        /// The codes and levels. The code of a missing observation is arbitrary.
+        /// </param>
+        /// <param name="validity">
+        /// The observations that are not missing, or an empty mask if none is.
+        /// </param>
+        /// <exception cref="std::out_of_range">
+        /// The column or its mask differs in length from the others.
+        /// </exception>
+        void Add(const std::string &name, CategoricalColumn values, ValidityMask validity = ValidityMask());
+
+        const std::size_t RowCount() const
+        { return _rowCount; }
+
+        const bool IsNumeric(const std::string &name) const
+        { return _numeric.count(name) != 0; }
+
+        const bool IsCategorical(const std::string &name) const
+        { return _categorical.count(name) != 0; }
+
+        /// <summary>
+        /// Returns a numeric column.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">
+        /// There is no numeric column of that name.
+        /// </exception>
+        const std::vector<double> &Numeric(const std::string &name) const;
+
+        /// <summary>
+        /// Returns the observations of a column that are not missing.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">
+        /// There is no column of that name.
+        /// </exception>
+        const ValidityMask &Validity(const std::string &name) const;
+
+        /// <summary>
+        /// Returns a categorical column, encoding a numeric column of integral values if need be. Missing values are
+        /// given the code of the first level.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">
+        /// There is no column of that name, or a numeric column has a value that is not integral.
+        /// </exception>
+        CategoricalColumn Categorical(const std::string &name) const;
+
+    private:
+
+        void Resize(const std::string &name, std::size_t rowCount);
+
+        std::size_t _rowCount = 0;
+
+        std::map<std::string, std::vector<double>> _numeric;
+
+        std::map<std::string, CategoricalColumn> _categorical;
+
+        std::map<std::string, ValidityMask> _validity;
+    };
+}
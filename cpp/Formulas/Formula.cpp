@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+#include "Formula.h"
+
+namespace Formulas {
+
+    namespace {
+        class Parser {
+        public:
+
+            explicit Parser(const std::string &text)
+                    : _text(text),
+                      _position(0)
+            {
+            }
+
+            Formula Parse()
+            {
+                Formula result;
+
+                result.Response = ParseFactor();
+
+                if (result.Response.Categorical) {
+                    Fail("The response must be continuous");
+                }
+
+                Expect("~");
+
+                do {
+                    for (Term &term : ParseTerm()) {
+                        const std::string key = term.ToString();
+
+                        if (std::none_of(result.Terms.begin(), result.Terms.end(), [&](const Term &other) { return other.ToString() == key; })) {
+                            result.Terms.push_back(std::move(term));
+                        }
+                    }
+                } while (Accept("+"));
+
+                if (Accept(",")) {
+                    while (!AtEnd()) {
+                        ParseOption(result);
+                    }
+                }
+
+                if (!AtEnd()) {
+                    Fail("Unexpected input");
+                }
+
+                return result;
+            }
+
+        private:
+
+            [[noreturn]] void Fail(const std::string &message) const
+            {
+                throw std::invalid_argument(message + " at position " + std::to_string(_position) + ".");
+            }
+
+            void SkipSpace()
+            {
+                while (_position < _text.size() && std::isspace(static_cast<unsigned char>(_text[_position]))) {
+                    _position++;
+                }
+            }
+
+            bool AtEnd()
+            {
+                SkipSpace();
+
+                return _position == _text.size();
+            }
+
+            bool Accept(const std::string &symbol)
+            {
+                SkipSpace();
+
+                if (_text.compare(_position, symbol.size(), symbol) != 0) {
+                    return false;
+                }
+
+                _position += symbol.size();
+
+                return true;
+            }
+
+            void Expect(const std::string &symbol)
+            {
+                if (!Accept(symbol)) {
+                    Fail("Expected '" + symbol + "'");
+                }
+            }
+
+            std::string Name()
+            {
+                SkipSpace();
+
+                const std::size_t start = _position;
+
+                if (_position < _text.size() && (std::isalpha(static_cast<unsigned char>(_text[_position])) || _text[_position] == '_')) {
+                    while (_position < _text.size() && (std::isalnum(static_cast<unsigned char>(_text[_position])) || _text[_position] == '_')) {
+                        _position++;
+                    }
+                }
+
+                if (_position == start) {
+                    Fail("Expected a name");
+                }
+
+                return _text.substr(start, _position - start);
+            }
+
+            double Number()
+            {
+                SkipSpace();
+
+                const char *start = _text.c_str() + _position;
+                char *end = nullptr;
+                const double result = std::strtod(start, &end);
+
+                if (end == start) {
+                    Fail("Expected a number");
+                }
+
+                _position += end - start;
+
+                return result;
+            }
+
+            Factor ParseFactor()
+            {
+                Factor result;
+
+                const std::string name = Name();
+
+                if ((name == "i" || name == "c") && Accept(".")) {
+                    result.Categorical = name == "i";
+                    result.Variable = Name();
+                } else if (Accept("(")) {
+                    result.Function = name;
+                    result.Variable = Name();
+
+                    while (Accept(",")) {
+                        result.Arguments.push_back(Number());
+                    }
+
+                    Expect(")");
+                } else {
+                    result.Variable = name;
+                }
+
+                return result;
+            }
+
+            std::vector<Term> ParseTerm()
+            {
+                std::vector<Factor> factors{ParseFactor()};
+
+                bool factorial = false;
+
+                while (true) {
+                    if (Accept("##")) {
+                        factorial = true;
+                    } else if (!Accept("#")) {
+                        break;
+                    }
+
+                    factors.push_back(ParseFactor());
+                }
+
+                if (!factorial) {
+                    return {Term{factors}};
+                }
+
+                if (factors.size() >= 8 * sizeof(unsigned long) - 1) {
+                    Fail("Too many factors");
+                }
+
+                // Every nonempty subset of the factors, main effects first, in the order written.
+                std::vector<Term> result;
+
+                for (std::size_t size = 1; size <= factors.size(); size++) {
+                    for (unsigned long mask = 1; mask < 1ul << factors.size(); mask++) {
+                        if (static_cast<std::size_t>(__builtin_popcountl(mask)) != size) {
+                            continue;
+                        }
+
+                        Term term;
+
+                        for (std::size_t f = 0; f < factors.size(); f++) {
+                            if (mask & 1ul << f) {
+                                term.Factors.push_back(factors[f]);
+                            }
+                        }
+
+                        result.push_back(std::move(term));
+                    }
+                }
+
+                return result;
+            }
+
+            void ParseOption(Formula &formula)
+            {
+                const std::string name = Name();
+
+                if (name == "absorb") {
+                    Expect("(");
+
+                    do {
+                        formula.Absorb.push_back(Name());
+                    } while (!Accept(")"));
+                } else if (name == "weight") {
+                    Expect("(");
+                    formula.Weight = Name();
+                    Expect(")");
+                } else if (name == "noconstant") {
+                    formula.Constant = false;
+                } else {
+                    Fail("Unknown option '" + name + "'");
+                }
+            }
+
+            const std::string &_text;
+
+            std::size_t _position;
+        };
+    }
+
+    std::string Factor::ToString() const
+    {
+        if (Categorical) {
+            return "i." + Variable;
+        }
+
+        if (Function.empty()) {
+            return Variable;
+        }
+
+        std::ostringstream result;
+
+        result << Function << '(' << Variable;
+
+        for (double argument : Arguments) {
+            result << ", " << argument;
+        }
+
+        result << ')';
+
+        return result.str();
+    }
+
+    std::string Term::ToString() const
+    {
+        std::string result;
+
+        for (const Factor &factor : Factors) {
+            result += (result.empty() ? "" : "#") + factor.ToString();
+        }
+
+        return result;
+    }
+
+    Formula Formula::Parse(const std::string &text)
+    {
+        return Parser(text).Parse();
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Formulas {
+
+    /// <summary>
+    /// A variable in a term: a categorical variable, a continuous variable, or a function of a continuous variable.
+    /// </summary>
+    struct Factor {
+        /// <summary>
+        /// The variable.
+        /// </summary>
+        std::string Variable;
+
+        /// <summary>
+        /// True for a categorical variable, written i.name.
+        /// </summary>
+        bool Categorical = false;
+
+        /// <summary>
+        /// The function applied to a continuous variable, such as log or ns, or empty for the variable itself.
+        /// </summary>
+        std::string Function;
+
+        /// <summary>
+        /// The numeric arguments of the function after the variable, such as the degrees of freedom of a spline.
+        /// </summary>
+        std::vector<double> Arguments;
+
+        /// <summary>
+        /// Writes the factor as it is written in a formula.
+        /// </summary>
+        std::string ToString() const;
+    };
+
+    /// <summary>
+    /// A term of the right-hand side: the interaction of its factors, or a main effect if there is only one.
+    /// </summary>
+    struct Term {
+        std::vector<Factor> Factors;
+
+        /// <summary>
+        /// Writes the term as it is written in a formula, with factors joined by #.
+        /// </summary>
+        std::string ToString() const;
+    };
+
+    /// <summary>
+    /// A parsed model formula in the syntax of Stata's factor variables, such as
+    /// <c>trade ~ log(dist) + contig + i.exp#i.year, absorb(pair)</c>.
+    /// </summary>
+    /// <remarks>
+    /// Terms are separated by +. Within a term, # interacts factors and ## interacts every nonempty subset of them, so
+    /// i.a##c.x expands to i.a + c.x + i.a#c.x. A factor is i.name for a categorical variable, name or c.name for a
+    /// continuous variable, or function(name, arguments...) with the functions log, log1p, exp, sqrt and abs, the
+    /// cubic B-spline bs(name, df), the natural spline ns(name, df) and the orthogonal polynomial poly(name, degree).
+    /// After a comma, the options are absorb(names...), weight(name) and noconstant.
+    /// </remarks>
+    struct Formula {
+        /// <summary>
+        /// The response: a continuous variable or a function of one.
+        /// </summary>
+        Factor Response;
+
+        /// <summary>
+        /// The terms, without duplicates, in the order written.
+        /// </summary>
+        std::vector<Term> Terms;
+
+        /// <summary>
+        /// The categorical variables whose fixed effects are absorbed.
+        /// </summary>
+        std::vector<std::string> Absorb;
+
+        /// <summary>
+        /// The variable holding the observation weights, or empty if every weight is one.
+        /// </summary>
+        std::string Weight;
+
+        /// <summary>
+        /// False if the formula has the noconstant option.
+        /// </summary>
+        bool Constant = true;
+
+        /// <summary>
+        /// Parses a formula.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">
+        /// The formula is malformed; the message gives the offending position.
+        /// </exception>
+        static Formula Parse(const std::string &text);
+    };
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+/// <summary>
+/// A bidirectional, message-oriented connection between two processes. Messages arrive whole and in order.
+/// </summary>
+class IChannel {
+public:
+    virtual ~IChannel() = default;
+
+    virtual void Send(const std::vector<double> &message) = 0;
+
+    /// <summary>
+    /// Waits for the next message.
+    /// </summary>
+    /// <exception cref="std::runtime_error">
+    /// The peer closed the channel.
+    /// </exception>
+    virtual std::vector<double> Receive() = 0;
+};
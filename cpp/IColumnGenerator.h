@@ -0,0 +1,30 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+class IColumnGenerator {
+public:
+    virtual ~IColumnGenerator() = default;
+
+    virtual const std::size_t Width() const = 0;
+
+    virtual void Generate(std::size_t first, std::size_t count, double *block, std::size_t stride) const = 0;
+
+    /// <summary>
+    /// The number of adjacent columns that hold every nonzero value of a row, which is less than <see cref="Width"/>
+    /// for a generator whose rows are sparse.
+    /// </summary>
+    virtual const std::size_t SpanWidth() const
+    { return Width(); }
+
+    /// <summary>
+    /// Writes the first column of the span of each row to offsets, and the <see cref="SpanWidth"/> values of the span
+    /// to consecutive rows of values. A row that is entirely zero may have any offset.
+    /// </summary>
+    virtual void GenerateSpans(std::size_t first, std::size_t count, std::size_t *offsets, double *values) const
+    {
+        std::fill(offsets, offsets + count, 0);
+        Generate(first, count, values, Width());
+    }
+};
@@ -1,9 +1,14 @@
 #pragma once
 
 #include <vector>
+#include "ILinkFunction.h"
+#include "ValidityMask.h"
 
 class IDistribution {
 public:
+    virtual ~IDistribution() = default;
+
+    virtual const ILinkFunction &LinkFunction() const = 0;
 
     virtual const double Entropy() const = 0;
 
@@ -31,8 +36,20 @@ public:
 
     virtual const double Deviance(const std::vector<double> &response, const std::vector<double> &meanResponse, const std::vector<double> &weights, double scale) const = 0;
 
+    /// <summary>
+    /// The deviance of the valid observations, or of all of them given an empty mask. Invalid observations are never
+    /// read, so they may be NaN.
+    /// </summary>
+    virtual const double Deviance(const std::vector<double> &response, const std::vector<double> &meanResponse, const std::vector<double> &weights, double scale, const ValidityMask &valid) const = 0;
+
     virtual const std::vector<double> InitialMean(const std::vector<double> &response) const = 0;
 
+    /// <summary>
+    /// The initial mean from the valid observations, or from all of them given an empty mask. Invalid observations
+    /// are never read and start at the mean of the valid ones.
+    /// </summary>
+    virtual const std::vector<double> InitialMean(const std::vector<double> &response, const ValidityMask &valid) const = 0;
+
     virtual const std::vector<double> Weight(const std::vector<double> &meanResponse) const = 0;
 
     virtual const std::vector<double> Fit(const std::vector<double> &linearPrediction) const = 0;
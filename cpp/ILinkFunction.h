@@ -4,6 +4,8 @@
 
 class ILinkFunction {
 public:
+    virtual ~ILinkFunction() = default;
+
     virtual const std::vector<double> Evaluate(const std::vector<double> &x) const = 0;
 
     virtual const std::vector<double> Inverse(const std::vector<double> &x) const = 0;
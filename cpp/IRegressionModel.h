@@ -4,6 +4,8 @@
 
 class IRegressionModel {
 public:
+    virtual ~IRegressionModel() = default;
+
 
     virtual const unsigned long ObservationCount() const = 0;
 
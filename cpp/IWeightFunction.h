@@ -0,0 +1,16 @@
+#pragma once
+
+#include <vector>
+
+class IWeightFunction {
+public:
+    virtual ~IWeightFunction() = default;
+
+    virtual const double Tuning() const = 0;
+
+    virtual const std::vector<double> Psi(const std::vector<double> &residuals) const = 0;
+
+    virtual const std::vector<double> PsiDerivative(const std::vector<double> &residuals) const = 0;
+
+    virtual const std::vector<double> Weight(const std::vector<double> &residuals) const = 0;
+};
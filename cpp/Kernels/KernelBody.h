@@ -0,0 +1,352 @@
+// The kernels, written once against GCC/Clang vector extensions and compiled by each Kernels*.cpp translation unit with
+// its own target flags and ADM_KERNEL_VECTOR_BYTES. This file is deliberately included once per build rather than
+// guarded, and everything in it has internal linkage, so the linker can never substitute a wider build of a function
+// into a narrower one.
+//
+// Reductions are blocked eight values at a time and combined in a fixed order whatever the vector width, and the
+// kernel files are compiled without floating-point contraction, so every build produces the same bits.
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef ADM_KERNEL_VECTOR_BYTES
+#error "ADM_KERNEL_VECTOR_BYTES must be defined before including KernelBody.h."
+#endif
+
+namespace {
+    typedef double Vector __attribute__((vector_size(ADM_KERNEL_VECTOR_BYTES)));
+
+    typedef long long Integers __attribute__((vector_size(ADM_KERNEL_VECTOR_BYTES)));
+
+    typedef std::uint64_t Words __attribute__((vector_size(ADM_KERNEL_VECTOR_BYTES)));
+
+    const std::size_t Lanes = ADM_KERNEL_VECTOR_BYTES / sizeof(double);
+
+    /// <summary>
+    /// The number of partial sums a dot product keeps, independent of <see cref="Lanes"/>.
+    /// </summary>
+    const std::size_t Block = 8;
+
+    static_assert(Block % Lanes == 0, "The vector width must divide the reduction block.");
+
+    inline Vector Load(const double *values)
+    {
+        Vector vector;
+        __builtin_memcpy(&vector, values, sizeof(vector));
+        return vector;
+    }
+
+    inline void Store(double *values, const Vector vector)
+    {
+        __builtin_memcpy(values, &vector, sizeof(vector));
+    }
+
+    inline Vector Broadcast(const double value)
+    {
+        return Vector{} + value;
+    }
+
+    void AccumulateGram(const double *rows, const std::size_t count, const std::size_t k, const double *weights, const double *responses, double *gram, double *moment)
+    {
+        for (std::size_t r = 0; r < count; r++) {
+            const double *x = rows + r * k;
+
+            for (std::size_t a = 0; a < k; a++) {
+                const double wx = weights[r] * x[a];
+                const Vector scaled = Broadcast(wx);
+
+                double *row = gram + a * k;
+
+                moment[a] += wx * responses[r];
+
+                std::size_t b = a;
+
+                for (; b + Lanes <= k; b += Lanes) {
+                    Store(row + b, Load(row + b) + scaled * Load(x + b));
+                }
+                for (; b < k; b++) {
+                    row[b] += wx * x[b];
+                }
+            }
+        }
+    }
+
+    void AccumulateGramSparse(const double *values, const std::size_t *columns, const std::size_t count, const std::size_t width, const std::size_t k, const double *weights, const double *responses, double *gram, double *moment)
+    {
+        for (std::size_t r = 0; r < count; r++) {
+            const double *x = values + r * width;
+            const std::size_t *c = columns + r * width;
+
+            for (std::size_t a = 0; a < width; a++) {
+                const double wx = weights[r] * x[a];
+
+                double *row = gram + c[a] * k;
+
+                moment[c[a]] += wx * responses[r];
+
+                for (std::size_t b = a; b < width; b++) {
+                    row[c[b]] += wx * x[b];
+                }
+            }
+        }
+    }
+
+    void MultiplyRows(const double *rows, const std::size_t count, const std::size_t k, const double *coefficients, double *result)
+    {
+        for (std::size_t r = 0; r < count; r++) {
+            const double *x = rows + r * k;
+
+            Vector partial[Block / Lanes] = {};
+
+            std::size_t j = 0;
+
+            for (; j + Block <= k; j += Block) {
+                for (std::size_t v = 0; v < Block / Lanes; v++) {
+                    partial[v] += Load(x + j + v * Lanes) * Load(coefficients + j + v * Lanes);
+                }
+            }
+
+            double sums[Block];
+
+            for (std::size_t v = 0; v < Block / Lanes; v++) {
+                Store(sums + v * Lanes, partial[v]);
+            }
+
+            double sum = 0.0;
+
+            for (std::size_t i = 0; i < Block; i++) {
+                sum += sums[i];
+            }
+            for (; j < k; j++) {
+                sum += x[j] * coefficients[j];
+            }
+
+            result[r] = sum;
+        }
+    }
+
+    inline Vector Exponentiate(Vector x)
+    {
+        // Beyond these bounds exp(x) overflows to infinity or underflows to zero; NaN passes through the comparisons.
+        x = x > Broadcast(710.0) ? Broadcast(710.0) : x;
+        x = x < Broadcast(-746.0) ? Broadcast(-746.0) : x;
+
+        // x = n ln 2 + r with |r| <= ln 2 / 2, rounding n with the 1.5 * 2^52 shifter.
+        const Vector shifter = Broadcast(6755399441055744.0);
+        Vector n = (x * Broadcast(1.4426950408889634) + shifter) - shifter;
+        const Vector r = (x - n * Broadcast(6.93147180369123816490e-01)) - n * Broadcast(1.90821492927058770002e-10);
+
+        // Taylor series of exp(r) to the 13th power; the remainder is below 2^-56 on the reduced interval.
+        Vector p = Broadcast(1.0 / 6227020800.0);
+        p = p * r + Broadcast(1.0 / 479001600.0);
+        p = p * r + Broadcast(1.0 / 39916800.0);
+        p = p * r + Broadcast(1.0 / 3628800.0);
+        p = p * r + Broadcast(1.0 / 362880.0);
+        p = p * r + Broadcast(1.0 / 40320.0);
+        p = p * r + Broadcast(1.0 / 5040.0);
+        p = p * r + Broadcast(1.0 / 720.0);
+        p = p * r + Broadcast(1.0 / 120.0);
+        p = p * r + Broadcast(1.0 / 24.0);
+        p = p * r + Broadcast(1.0 / 6.0);
+        p = p * r + Broadcast(0.5);
+        p = p * r + Broadcast(1.0);
+        p = p * r + Broadcast(1.0);
+
+        // Scale by 2^n in two steps so that subnormal results and n = 1024 stay representable.
+        // A NaN lane keeps its NaN through p; its exponent only needs to be a valid integer.
+        n = n == n ? n : Broadcast(0.0);
+
+        const Integers exponent = __builtin_convertvector(n, Integers);
+        const Integers half = exponent >> 1;
+
+        Vector first;
+        Vector second;
+
+        const Integers firstBits = (half + 1023) << 52;
+        const Integers secondBits = (exponent - half + 1023) << 52;
+
+        __builtin_memcpy(&first, &firstBits, sizeof(first));
+        __builtin_memcpy(&second, &secondBits, sizeof(second));
+
+        return p * first * second;
+    }
+
+    void Exponentiate(const double *values, const std::size_t count, double *result)
+    {
+        std::size_t i = 0;
+
+        for (; i + Lanes <= count; i += Lanes) {
+            Store(result + i, Exponentiate(Load(values + i)));
+        }
+
+        if (i < count) {
+            double tail[Lanes] = {};
+
+            for (std::size_t j = i; j < count; j++) {
+                tail[j - i] = values[j];
+            }
+
+            Store(tail, Exponentiate(Load(tail)));
+
+            for (std::size_t j = i; j < count; j++) {
+                result[j] = tail[j - i];
+            }
+        }
+    }
+
+    inline Vector Logarithm(Vector x)
+    {
+        // Subnormal arguments are scaled into the normal range by 2^54 and the exponent corrected below.
+        const Integers subnormal = x < Broadcast(2.2250738585072014e-308);
+        const Vector scaled = subnormal ? x * Broadcast(18014398509481984.0) : x;
+
+        Integers bits;
+        __builtin_memcpy(&bits, &scaled, sizeof(bits));
+
+        // x = 2^k * m with m in [sqrt(2) / 2, sqrt(2)), so that f = m - 1 is small in both directions.
+        Integers k = ((bits >> 52) & 0x7ff) - 1023 + (subnormal & -54);
+        Integers mantissaBits = (bits & 0x000fffffffffffffLL) | (1023LL << 52);
+
+        Vector m;
+        __builtin_memcpy(&m, &mantissaBits, sizeof(m));
+
+        const Integers large = m > Broadcast(1.4142135623730951);
+        m = large ? m * Broadcast(0.5) : m;
+        k -= large;
+
+        // log(1 + f) = f - f^2 / 2 + s * (f^2 / 2 + R(s^2)) with s = f / (2 + f) (fdlibm's e_log.c).
+        const Vector f = m - Broadcast(1.0);
+        const Vector s = f / (Broadcast(2.0) + f);
+        const Vector z = s * s;
+        const Vector halfSquare = Broadcast(0.5) * f * f;
+
+        Vector r = Broadcast(1.479819860511658591e-01);
+        r = r * z + Broadcast(1.531383769920937332e-01);
+        r = r * z + Broadcast(1.818357216161805012e-01);
+        r = r * z + Broadcast(2.222219843214978396e-01);
+        r = r * z + Broadcast(2.857142874366239149e-01);
+        r = r * z + Broadcast(3.999999999940941908e-01);
+        r = r * z + Broadcast(6.666666666666735130e-01);
+        r = r * z;
+
+        const Vector n = __builtin_convertvector(k, Vector);
+        Vector result = n * Broadcast(6.93147180369123816490e-01) - ((halfSquare - (s * (halfSquare + r) + n * Broadcast(1.90821492927058770002e-10))) - f);
+
+        // log(0) = -inf, log(x < 0) = NaN, log(inf) = inf, and NaN passes through.
+        result = x == Broadcast(0.0) ? Broadcast(-__builtin_inf()) : result;
+        result = x < Broadcast(0.0) ? Broadcast(__builtin_nan("")) : result;
+        result = x == Broadcast(__builtin_inf()) ? x : result;
+        result = x != x ? x : result;
+
+        return result;
+    }
+
+    void Logarithm(const double *values, const std::size_t count, double *result)
+    {
+        std::size_t i = 0;
+
+        for (; i + Lanes <= count; i += Lanes) {
+            Store(result + i, Logarithm(Load(values + i)));
+        }
+
+        if (i < count) {
+            double tail[Lanes];
+
+            for (std::size_t j = 0; j < Lanes; j++) {
+                tail[j] = i + j < count ? values[i + j] : 1.0;
+            }
+
+            Store(tail, Logarithm(Load(tail)));
+
+            for (std::size_t j = i; j < count; j++) {
+                result[j] = tail[j - i];
+            }
+        }
+    }
+
+    double Sum(const double *values, const std::size_t count)
+    {
+        Vector partial[Block / Lanes] = {};
+
+        std::size_t i = 0;
+
+        for (; i + Block <= count; i += Block) {
+            for (std::size_t v = 0; v < Block / Lanes; v++) {
+                partial[v] += Load(values + i + v * Lanes);
+            }
+        }
+
+        double sums[Block];
+
+        for (std::size_t v = 0; v < Block / Lanes; v++) {
+            Store(sums + v * Lanes, partial[v]);
+        }
+
+        double sum = 0.0;
+
+        for (std::size_t j = 0; j < Block; j++) {
+            sum += sums[j];
+        }
+        for (; i < count; i++) {
+            sum += values[i];
+        }
+
+        return sum;
+    }
+
+    void MarkValid(const double *values, const std::size_t count, std::uint64_t *words)
+    {
+        for (std::size_t first = 0; first < count; first += 64) {
+            std::uint64_t word = 0;
+
+            std::size_t i = first;
+
+            if (first + 64 <= count) {
+                for (; i < first + 64; i += Lanes) {
+                    const Vector vector = Load(values + i);
+                    const Integers valid = vector == vector;
+
+                    for (std::size_t l = 0; l < Lanes; l++) {
+                        word |= static_cast<std::uint64_t>(valid[l] & 1) << (i - first + l);
+                    }
+                }
+            } else {
+                for (; i < count; i++) {
+                    word |= static_cast<std::uint64_t>(values[i] == values[i]) << (i - first);
+                }
+            }
+
+            words[first / 64] = word;
+        }
+    }
+
+    std::size_t CombineMasks(std::uint64_t *target, const std::uint64_t *source, const std::size_t count)
+    {
+        const std::size_t lanes = sizeof(Words) / sizeof(std::uint64_t);
+
+        std::size_t result = 0;
+        std::size_t i = 0;
+
+        for (; i + lanes <= count; i += lanes) {
+            Words a;
+            Words b;
+
+            __builtin_memcpy(&a, target + i, sizeof(a));
+            __builtin_memcpy(&b, source + i, sizeof(b));
+
+            a &= b;
+
+            __builtin_memcpy(target + i, &a, sizeof(a));
+
+            for (std::size_t l = 0; l < lanes; l++) {
+                result += static_cast<std::size_t>(__builtin_popcountll(a[l]));
+            }
+        }
+        for (; i < count; i++) {
+            target[i] &= source[i];
+            result += static_cast<std::size_t>(__builtin_popcountll(target[i]));
+        }
+
+        return result;
+    }
+}
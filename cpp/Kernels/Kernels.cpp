@@ -0,0 +1,108 @@
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include "Kernels.h"
+
+namespace Kernels {
+    extern const KernelTable GenericKernels;
+
+#if defined(ADM_DISPATCH_X86)
+    extern const KernelTable Sse42Kernels;
+
+    extern const KernelTable Avx2Kernels;
+
+    extern const KernelTable Avx512Kernels;
+#endif
+
+    namespace {
+        InstructionSet Detect()
+        {
+#if defined(ADM_DISPATCH_X86)
+            // The checks include operating system support for the wider register state.
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx512f")) {
+                return InstructionSet::Avx512;
+            }
+            if (__builtin_cpu_supports("avx2")) {
+                return InstructionSet::Avx2;
+            }
+            if (__builtin_cpu_supports("sse4.2")) {
+                return InstructionSet::Sse42;
+            }
+#endif
+            return InstructionSet::Generic;
+        }
+
+        InstructionSet Select()
+        {
+            const InstructionSet supported = SupportedInstructionSet();
+            const char *requested = std::getenv("ADM_ISA");
+
+            if (requested == nullptr) {
+                return supported;
+            }
+
+            for (const InstructionSet set : {InstructionSet::Generic, InstructionSet::Sse42, InstructionSet::Avx2, InstructionSet::Avx512}) {
+                if (std::strcmp(requested, Name(set)) == 0) {
+                    return set < supported ? set : supported;
+                }
+            }
+
+            return supported;
+        }
+    }
+
+    const InstructionSet SupportedInstructionSet()
+    {
+        static const InstructionSet supported = Detect();
+
+        return supported;
+    }
+
+    const KernelTable &Active()
+    {
+        static const KernelTable &active = ForInstructionSet(Select());
+
+        return active;
+    }
+
+    const KernelTable &ForInstructionSet(const InstructionSet set)
+    {
+        if (set > SupportedInstructionSet()) {
+            throw std::invalid_argument("The instruction set is not supported on this processor.");
+        }
+
+        switch (set) {
+#if defined(ADM_DISPATCH_X86)
+            case InstructionSet::Avx512:
+                return Avx512Kernels;
+
+            case InstructionSet::Avx2:
+                return Avx2Kernels;
+
+            case InstructionSet::Sse42:
+                return Sse42Kernels;
+#endif
+            default:
+                return GenericKernels;
+        }
+    }
+
+    const char *Name(const InstructionSet set)
+    {
+        switch (set) {
+            case InstructionSet::Sse42:
+                return "sse4.2";
+
+            case InstructionSet::Avx2:
+                return "avx2";
+
+            case InstructionSet::Avx512:
+                return "avx512";
+
+            default:
+                return "generic";
+        }
+    }
+}
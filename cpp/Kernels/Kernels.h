@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Kernels {
+
+    /// <summary>
+    /// The instruction sets the numeric kernels are compiled for, in increasing order of capability.
+    /// </summary>
+    enum class InstructionSet {
+        Generic = 0,
+
+        Sse42 = 1,
+
+        Avx2 = 2,
+
+        Avx512 = 3
+    };
+
+    /// <summary>
+    /// One build of the hot numeric kernels. Every build evaluates the same operations in the same order, so all builds
+    /// return bitwise identical results and differ only in speed.
+    /// </summary>
+    struct KernelTable {
+        InstructionSet Set;
+
+        /// <summary>
+        /// Adds w * x * xᵀ to the upper triangle of a k x k Gram matrix and w * z * x to a moment vector for each of the
+        /// given rows (see <see cref="WeightedGram"/>).
+        /// </summary>
+        void (*AccumulateGram)(const double *rows, std::size_t count, std::size_t k, const double *weights, const double *responses, double *gram, double *moment);
+
+        /// <summary>
+        /// Does the same for rows given as width values each, whose columns, ascending within a row, are in columns. Only
+        /// the entries of the Gram matrix at pairs of those columns are updated.
+        /// </summary>
+        void (*AccumulateGramSparse)(const double *values, const std::size_t *columns, std::size_t count, std::size_t width, std::size_t k, const double *weights, const double *responses, double *gram, double *moment);
+
+        /// <summary>
+        /// Computes the dot product of each of the given rows with a coefficient vector.
+        /// </summary>
+        void (*MultiplyRows)(const double *rows, std::size_t count, std::size_t k, const double *coefficients, double *result);
+
+        /// <summary>
+        /// Computes exp(x) elementwise, with an error of at most 1.18 units in the last place against an extended-precision
+        /// reference. Results may alias the input.
+        /// </summary>
+        void (*Exponentiate)(const double *values, std::size_t count, double *result);
+
+        /// <summary>
+        /// Computes log(x) elementwise, with an error of at most 0.86 units in the last place against an extended-precision
+        /// reference. Results may alias the input.
+        /// </summary>
+        void (*Logarithm)(const double *values, std::size_t count, double *result);
+
+        /// <summary>
+        /// Sums the values in eight interleaved partial sums, combined in a fixed order.
+        /// </summary>
+        double (*Sum)(const double *values, std::size_t count);
+
+        /// <summary>
+        /// Sets bit i % 64 of word i / 64 if the i-th value is not NaN, clearing the bits past the last value (see
+        /// <see cref="ValidityMask"/>).
+        /// </summary>
+        void (*MarkValid)(const double *values, std::size_t count, std::uint64_t *words);
+
+        /// <summary>
+        /// Replaces each target word by its conjunction with the source word, returning the number of bits set in the
+        /// result.
+        /// </summary>
+        std::size_t (*CombineMasks)(std::uint64_t *target, const std::uint64_t *source, std::size_t count);
+    };
+
+    /// <summary>
+    /// The best instruction set that both the processor and the operating system support and that the library was
+    /// built with.
+    /// </summary>
+    const InstructionSet SupportedInstructionSet();
+
+    /// <summary>
+    /// The kernels selected for this process, chosen once on first use.
+    /// </summary>
+    /// <remarks>
+    /// The ADM_ISA environment variable (generic, sse4.2, avx2 or avx512) caps the selection, e.g. to exercise an older
+    /// code path on a newer host. A request beyond <see cref="SupportedInstructionSet"/> selects the supported set.
+    /// </remarks>
+    const KernelTable &Active();
+
+    /// <summary>
+    /// The kernels built for the given instruction set.
+    /// </summary>
+    /// <exception cref="std::invalid_argument">
+    /// The instruction set exceeds <see cref="SupportedInstructionSet"/>.
+    /// </exception>
+    const KernelTable &ForInstructionSet(InstructionSet set);
+
+    const char *Name(InstructionSet set);
+}
@@ -0,0 +1,8 @@
+#define ADM_KERNEL_VECTOR_BYTES 32
+
+#include "KernelBody.h"
+#include "Kernels.h"
+
+namespace Kernels {
+    extern const KernelTable Avx2Kernels = {InstructionSet::Avx2, AccumulateGram, AccumulateGramSparse, MultiplyRows, Exponentiate, Logarithm, Sum, MarkValid, CombineMasks};
+}
@@ -0,0 +1,8 @@
+#define ADM_KERNEL_VECTOR_BYTES 64
+
+#include "KernelBody.h"
+#include "Kernels.h"
+
+namespace Kernels {
+    extern const KernelTable Avx512Kernels = {InstructionSet::Avx512, AccumulateGram, AccumulateGramSparse, MultiplyRows, Exponentiate, Logarithm, Sum, MarkValid, CombineMasks};
+}
@@ -0,0 +1,8 @@
+#define ADM_KERNEL_VECTOR_BYTES 16
+
+#include "KernelBody.h"
+#include "Kernels.h"
+
+namespace Kernels {
+    extern const KernelTable Sse42Kernels = {InstructionSet::Sse42, AccumulateGram, AccumulateGramSparse, MultiplyRows, Exponentiate, Logarithm, Sum, MarkValid, CombineMasks};
+}
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <stdexcept>
 #include "ILinkFunction.h"
 
 namespace LinkFunctions {
@@ -15,15 +16,7 @@ namespace LinkFunctions {
 
         const std::vector<double> Inverse(const std::vector<double> &x) const override
         {
-            std::vector<double> result(x.size());
-
-            std::transform(
-                    x.begin(),
-                    x.end(),
-                    result.begin(),
-                    [](double y) -> double { return 1.0 / y; });
-
-            return result;
+            return std::vector<double>(x);
         }
 
         const std::vector<double> FirstDerivative(const std::vector<double> &x) const override
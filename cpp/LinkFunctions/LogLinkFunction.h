@@ -2,7 +2,9 @@
 
 #include <vector>
 #include <algorithm>
+#include <stdexcept>
 #include "ILinkFunction.h"
+#include "Kernels.h"
 
 namespace LinkFunctions {
     class LogLinkFunction : public ILinkFunction {
@@ -24,11 +26,7 @@ namespace LinkFunctions {
         {
             std::vector<double> result(x.size());
 
-            std::transform(
-                    x.begin(),
-                    x.end(),
-                    result.begin(),
-                    log);
+            Kernels::Active().Logarithm(x.data(), x.size(), result.data());
 
             return result;
         }
@@ -37,11 +35,7 @@ namespace LinkFunctions {
         {
             std::vector<double> result(x.size());
 
-            std::transform(
-                    x.begin(),
-                    x.end(),
-                    result.begin(),
-                    exp);
+            Kernels::Active().Exponentiate(x.data(), x.size(), result.data());
 
             return result;
         }
@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include "CategoricalColumn.h"
+
+namespace {
+    template<typename T>
+    std::vector<std::uint32_t> Encode(const std::vector<T> &values, std::vector<T> &levels)
+    {
+        std::vector<std::size_t> order(values.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return values[a] < values[b]; });
+
+        std::vector<std::uint32_t> codes(values.size());
+
+        levels.clear();
+
+        for (std::size_t i = 0; i < order.size(); i++) {
+            if (i == 0 || values[order[i - 1]] < values[order[i]]) {
+                if (levels.size() == std::numeric_limits<std::uint32_t>::max()) {
+                    throw std::out_of_range("Too many levels.");
+                }
+
+                levels.push_back(values[order[i]]);
+            }
+
+            codes[order[i]] = static_cast<std::uint32_t>(levels.size() - 1);
+        }
+
+        return codes;
+    }
+}
+
+CategoricalColumn::CategoricalColumn(const std::vector<std::string> &values)
+{
+    _codes = Encode(values, _levels);
+}
+
+CategoricalColumn::CategoricalColumn(const std::vector<long> &values)
+{
+    std::vector<long> levels;
+
+    _codes = Encode(values, levels);
+    _levels.reserve(levels.size());
+
+    for (long level : levels) {
+        _levels.push_back(std::to_string(level));
+    }
+}
+
+CategoricalColumn::CategoricalColumn(std::vector<std::uint32_t> codes, std::vector<std::string> levels)
+        : _codes(std::move(codes)),
+          _levels(std::move(levels))
+{
+    for (std::uint32_t code : _codes) {
+        if (code >= _levels.size()) {
+            throw std::out_of_range("A code does not index a level.");
+        }
+    }
+}
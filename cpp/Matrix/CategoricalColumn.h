@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// A categorical variable: one integer code per observation indexing a table of level labels.
+/// </summary>
+/// <remarks>
+/// Levels are sorted, so equal data give equal codes whatever the order of the observations. Models read the codes
+/// directly (for example, as the grouping of a random effect) instead of expanding them into indicator columns.
+/// </remarks>
+class CategoricalColumn {
+public:
+
+    CategoricalColumn() = default;
+
+    /// <summary>
+    /// Encodes labels; the levels are the distinct labels in lexicographic order.
+    /// </summary>
+    explicit CategoricalColumn(const std::vector<std::string> &values);
+
+    /// <summary>
+    /// Encodes integer labels; the levels are the distinct labels in ascending order.
+    /// </summary>
+    explicit CategoricalColumn(const std::vector<long> &values);
+
+    /// <summary>
+    /// Wraps existing codes.
+    /// </summary>
+    /// <exception cref="std::out_of_range">
+    /// A code does not index a level.
+    /// </exception>
+    CategoricalColumn(std::vector<std::uint32_t> codes, std::vector<std::string> levels);
+
+    const std::size_t RowCount() const
+    { return _codes.size(); }
+
+    const std::size_t LevelCount() const
+    { return _levels.size(); }
+
+    const std::vector<std::uint32_t> &Codes() const
+    { return _codes; }
+
+    const std::vector<std::string> &Levels() const
+    { return _levels; }
+
+    const std::uint32_t operator[](std::size_t row) const
+    { return _codes[row]; }
+
+private:
+
+    std::vector<std::uint32_t> _codes;
+
+    std::vector<std::string> _levels;
+};
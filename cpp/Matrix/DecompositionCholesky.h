@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+/// <summary>
+/// Decomposes a symmetric positive definite array A into L * Lᵀ.
+/// </summary>
+struct DecompositionCholesky {
+    /// <summary>
+    /// Decomposes a symmetric positive definite array.
+    /// </summary>
+    /// <param name="a">
+    /// The n x n input array, stored row-major. Only the lower triangle is read.
+    /// </param>
+    /// <param name="n">
+    /// The dimension of the array.
+    /// </param>
+    /// <returns>
+    /// The lower triangular factor L, stored row-major with zeros above the diagonal.
+    /// </returns>
+    std::vector<double> operator()(const std::vector<double> &a, const std::size_t n) const
+    {
+        if (a.size() != n * n) {
+            throw std::out_of_range("Input array should be square.");
+        }
+
+        std::vector<double> lower(n * n, 0.0);
+
+        for (std::size_t j = 0; j < n; j++) {
+            double diagonal = a[j * n + j];
+
+            for (std::size_t k = 0; k < j; k++) {
+                diagonal -= lower[j * n + k] * lower[j * n + k];
+            }
+
+            if (!(diagonal > 0.0)) {
+                throw std::domain_error("Input array is not positive definite.");
+            }
+
+            const double pivot = std::sqrt(diagonal);
+
+            lower[j * n + j] = pivot;
+
+            for (std::size_t i = j + 1; i < n; i++) {
+                double sum = a[i * n + j];
+
+                for (std::size_t k = 0; k < j; k++) {
+                    sum -= lower[i * n + k] * lower[j * n + k];
+                }
+
+                lower[i * n + j] = sum / pivot;
+            }
+        }
+
+        return lower;
+    }
+};
+
+static const DecompositionCholesky decompositionCholesky = {};
@@ -0,0 +1,406 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "DesignMatrix.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+DesignMatrix::DesignMatrix(const std::size_t rowCount, const std::size_t columnCount, const MemoryPlacement placement, Threading::ThreadPool &pool)
+        : _data(nullptr),
+          _rowCount(rowCount),
+          _columnCount(columnCount),
+          _bytes(rowCount * columnCount * sizeof(double)),
+          _placement(placement),
+          _pool(&pool)
+{
+    Allocate();
+    Place();
+}
+
+DesignMatrix::DesignMatrix(const std::size_t rowCount, std::vector<const double *> columns, std::vector<std::ptrdiff_t> strides, Threading::ThreadPool &pool)
+        : _data(nullptr),
+          _rowCount(rowCount),
+          _columnCount(columns.size()),
+          _bytes(0),
+          _placement(MemoryPlacement::Default),
+          _pool(&pool),
+          _columns(std::move(columns)),
+          _strides(std::move(strides))
+{
+}
+
+DesignMatrix DesignMatrix::Wrap(const std::size_t rowCount, std::vector<const double *> columns, std::vector<std::ptrdiff_t> strides, const bool addConstant, Threading::ThreadPool &pool)
+{
+    // A zero stride repeats the same element down the column, so the constant is a view of a single one.
+    static const double one = 1.0;
+
+    if (columns.size() != strides.size()) {
+        throw std::out_of_range("Argument vectors differ in length.");
+    }
+    if (rowCount != 0 && std::find(columns.begin(), columns.end(), nullptr) != columns.end()) {
+        throw std::invalid_argument("Column buffers must not be null.");
+    }
+
+    if (addConstant) {
+        columns.insert(columns.begin(), &one);
+        strides.insert(strides.begin(), 0);
+    }
+
+    if (columns.empty()) {
+        throw std::out_of_range("Argument vector is empty.");
+    }
+
+    return DesignMatrix(rowCount, std::move(columns), std::move(strides), pool);
+}
+
+DesignMatrix DesignMatrix::Wrap(const std::size_t rowCount, std::vector<const double *> columns, std::vector<std::ptrdiff_t> strides, const std::vector<std::shared_ptr<const IColumnGenerator>> &generators, const bool addConstant, Threading::ThreadPool &pool)
+{
+    if (std::find(generators.begin(), generators.end(), nullptr) != generators.end()) {
+        throw std::invalid_argument("Column generators must not be null.");
+    }
+
+    if (generators.empty()) {
+        return Wrap(rowCount, std::move(columns), std::move(strides), addConstant, pool);
+    }
+
+    DesignMatrix result = columns.empty() && !addConstant
+                          ? DesignMatrix(rowCount, std::move(columns), std::move(strides), pool)
+                          : Wrap(rowCount, std::move(columns), std::move(strides), addConstant, pool);
+
+    for (const std::shared_ptr<const IColumnGenerator> &generator : generators) {
+        result._generators.emplace_back(result._columnCount, generator);
+        result._columnCount += generator->Width();
+        result._columns.resize(result._columnCount, nullptr);
+        result._strides.resize(result._columnCount, 0);
+    }
+
+    if (result._columnCount == 0) {
+        throw std::out_of_range("Argument vector is empty.");
+    }
+
+    return result;
+}
+
+DesignMatrix::DesignMatrix(const std::vector<std::vector<double>> &design, const bool addConstant, const MemoryPlacement placement, Threading::ThreadPool &pool)
+        : DesignMatrix(design.size(), design.empty() ? 0 : design[0].size() + (addConstant ? 1 : 0), placement, pool)
+{
+    const std::size_t offset = addConstant ? 1 : 0;
+
+    for (const std::vector<double> &row : design) {
+        if (row.size() + offset != _columnCount) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+    }
+
+    const auto copy = [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; i++) {
+            double *target = Row(i);
+
+            if (addConstant) {
+                target[0] = 1.0;
+            }
+
+            std::copy(design[i].begin(), design[i].end(), target + offset);
+        }
+    };
+
+    if (_placement == MemoryPlacement::Default) {
+        copy(0, _rowCount);
+    }
+    else {
+        ForEachPartition([&copy](unsigned, std::size_t first, std::size_t last) { copy(first, last); });
+    }
+}
+
+DesignMatrix::DesignMatrix(DesignMatrix &&other) noexcept
+        : _data(other._data),
+          _rowCount(other._rowCount),
+          _columnCount(other._columnCount),
+          _bytes(other._bytes),
+          _placement(other._placement),
+          _pool(other._pool),
+          _columns(std::move(other._columns)),
+          _strides(std::move(other._strides)),
+          _generators(std::move(other._generators)),
+          _mask(std::move(other._mask))
+{
+    other._data = nullptr;
+    other._bytes = 0;
+}
+
+DesignMatrix &DesignMatrix::operator=(DesignMatrix &&other) noexcept
+{
+    // The previous storage is released when the moved-from matrix is destroyed.
+    std::swap(_data, other._data);
+    std::swap(_rowCount, other._rowCount);
+    std::swap(_columnCount, other._columnCount);
+    std::swap(_bytes, other._bytes);
+    std::swap(_placement, other._placement);
+    std::swap(_pool, other._pool);
+    std::swap(_columns, other._columns);
+    std::swap(_strides, other._strides);
+    std::swap(_generators, other._generators);
+    std::swap(_mask, other._mask);
+
+    return *this;
+}
+
+DesignMatrix::~DesignMatrix()
+{
+    if (_data == nullptr) {
+        return;
+    }
+
+#ifdef __linux__
+    munmap(_data, _bytes);
+#else
+    std::free(_data);
+#endif
+
+    _data = nullptr;
+}
+
+std::pair<std::size_t, std::size_t> DesignMatrix::RowPartition(const unsigned worker) const
+{
+    const std::size_t parts = _pool->WorkerCount();
+
+    return std::make_pair(_rowCount * worker / parts, _rowCount * (worker + 1) / parts);
+}
+
+const double *DesignMatrix::Rows(const std::size_t first, const std::size_t count, std::vector<double> &scratch) const
+{
+    const double *rows = IsBorrowed() ? Gather(first, count, scratch) : _data + first * _columnCount;
+
+    if (!IsMasked()) {
+        return rows;
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        if (_mask[first + i]) {
+            continue;
+        }
+
+        // Owned rows are copied before the first invalid one is zeroed; gathered rows are zeroed in place.
+        if (rows != scratch.data()) {
+            scratch.assign(rows, rows + count * _columnCount);
+            rows = scratch.data();
+        }
+
+        std::fill(scratch.begin() + i * _columnCount, scratch.begin() + (i + 1) * _columnCount, 0.0);
+    }
+
+    return rows;
+}
+
+const std::size_t DesignMatrix::SpanWidth() const
+{
+    std::size_t result = _columnCount;
+
+    for (const std::pair<std::size_t, std::shared_ptr<const IColumnGenerator>> &generator : _generators) {
+        result -= generator.second->Width() - generator.second->SpanWidth();
+    }
+
+    return result;
+}
+
+const double *DesignMatrix::Spans(const std::size_t first, const std::size_t count, std::vector<double> &values, std::vector<std::size_t> &columns) const
+{
+    const std::size_t width = SpanWidth();
+
+    values.resize(count * width);
+    columns.resize(count * width);
+
+    // Wrapped and owned columns precede every generated column, so they are the first of each row.
+    std::size_t position = 0;
+
+    for (std::size_t j = 0; j < _columnCount; j++) {
+        if (IsBorrowed() && _columns[j] == nullptr) {
+            continue;
+        }
+
+        for (std::size_t i = 0; i < count; i++) {
+            values[i * width + position] = IsBorrowed() ? _columns[j][static_cast<std::ptrdiff_t>(first + i) * _strides[j]] : _data[(first + i) * _columnCount + j];
+            columns[i * width + position] = j;
+        }
+
+        position++;
+    }
+
+    std::vector<double> spans;
+    std::vector<std::size_t> offsets(count);
+
+    for (const std::pair<std::size_t, std::shared_ptr<const IColumnGenerator>> &generator : _generators) {
+        const std::size_t spanWidth = generator.second->SpanWidth();
+
+        spans.resize(count * spanWidth);
+        generator.second->GenerateSpans(first, count, offsets.data(), spans.data());
+
+        for (std::size_t i = 0; i < count; i++) {
+            for (std::size_t m = 0; m < spanWidth; m++) {
+                values[i * width + position + m] = spans[i * spanWidth + m];
+                columns[i * width + position + m] = generator.first + offsets[i] + m;
+            }
+        }
+
+        position += spanWidth;
+    }
+
+    if (IsMasked()) {
+        for (std::size_t i = 0; i < count; i++) {
+            if (!_mask[first + i]) {
+                std::fill(values.begin() + i * width, values.begin() + (i + 1) * width, 0.0);
+            }
+        }
+    }
+
+    return values.data();
+}
+
+void DesignMatrix::SetMask(ValidityMask mask)
+{
+    if (mask.RowCount() != _rowCount) {
+        throw std::out_of_range("Argument vectors differ in length.");
+    }
+
+    _mask = mask.AllValid() ? ValidityMask() : std::move(mask);
+}
+
+const bool DesignMatrix::HasConstant() const
+{
+    if (_columnCount == 0) {
+        return false;
+    }
+
+    // A zero stride repeats one element down the column, as in the constant added by Wrap.
+    if (IsBorrowed() && _columns[0] != nullptr && _strides[0] == 0) {
+        return _columns[0][0] == 1.0;
+    }
+
+    for (std::size_t i = 0; i < _rowCount; i++) {
+        if ((!IsMasked() || _mask[i]) && (*this)(i, 0) != 1.0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const double *DesignMatrix::Gather(const std::size_t first, const std::size_t count, std::vector<double> &scratch) const
+{
+    scratch.resize(count * _columnCount);
+
+    for (std::size_t j = 0; j < _columnCount; j++) {
+        if (_columns[j] == nullptr) {
+            continue;
+        }
+
+        const double *column = _columns[j] + static_cast<std::ptrdiff_t>(first) * _strides[j];
+        const std::ptrdiff_t stride = _strides[j];
+
+        for (std::size_t i = 0; i < count; i++) {
+            scratch[i * _columnCount + j] = column[static_cast<std::ptrdiff_t>(i) * stride];
+        }
+    }
+
+    for (const std::pair<std::size_t, std::shared_ptr<const IColumnGenerator>> &generator : _generators) {
+        generator.second->Generate(first, count, scratch.data() + generator.first, _columnCount);
+    }
+
+    return scratch.data();
+}
+
+double DesignMatrix::Generated(const std::size_t row, const std::size_t column) const
+{
+    for (const std::pair<std::size_t, std::shared_ptr<const IColumnGenerator>> &generator : _generators) {
+        const std::size_t width = generator.second->Width();
+
+        if (column >= generator.first && column < generator.first + width) {
+            std::vector<double> values(width);
+
+            generator.second->Generate(row, 1, values.data(), width);
+
+            return values[column - generator.first];
+        }
+    }
+
+    throw std::out_of_range("Column index out of range.");
+}
+
+void DesignMatrix::Allocate()
+{
+    if (_bytes == 0) {
+        return;
+    }
+
+#ifdef __linux__
+    // Anonymous mappings are reserved without being touched, so no page is placed until a worker first writes it.
+    void *data = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (data == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+#else
+    void *data = std::calloc(_rowCount * _columnCount, sizeof(double));
+
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+#endif
+
+    _data = static_cast<double *>(data);
+}
+
+void DesignMatrix::Place()
+{
+    if (_bytes == 0 || _placement == MemoryPlacement::Default) {
+        return;
+    }
+
+    if (_placement == MemoryPlacement::Partitioned) {
+        ForEachPartition(
+                [this](unsigned, std::size_t first, std::size_t last) {
+                    std::memset(Row(first), 0, (last - first) * _columnCount * sizeof(double));
+                });
+        return;
+    }
+
+#ifdef __linux__
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    const std::size_t pageSize = 4096;
+#endif
+
+    const std::size_t pageCount = (_bytes + pageSize - 1) / pageSize;
+
+    std::vector<unsigned> nodes;
+    for (unsigned worker = 0; worker < _pool->WorkerCount(); worker++) {
+        nodes.push_back(_pool->WorkerNode(worker));
+    }
+
+    std::vector<unsigned> distinctNodes(nodes);
+    std::sort(distinctNodes.begin(), distinctNodes.end());
+    distinctNodes.erase(std::unique(distinctNodes.begin(), distinctNodes.end()), distinctNodes.end());
+
+    _pool->ForEachWorker(
+            [&](unsigned worker) {
+                const auto slot = static_cast<std::size_t>(std::lower_bound(distinctNodes.begin(), distinctNodes.end(), nodes[worker]) - distinctNodes.begin());
+
+                // Workers sharing a node split that node's pages among themselves by rank.
+                const auto rank = static_cast<std::size_t>(std::count(nodes.begin(), nodes.begin() + worker, nodes[worker]));
+                const auto peers = static_cast<std::size_t>(std::count(nodes.begin(), nodes.end(), nodes[worker]));
+
+                auto *bytes = reinterpret_cast<volatile char *>(_data);
+
+                for (std::size_t page = slot; page < pageCount; page += distinctNodes.size()) {
+                    if ((page / distinctNodes.size()) % peers == rank) {
+                        bytes[page * pageSize] = 0;
+                    }
+                }
+            });
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "IColumnGenerator.h"
+#include "ThreadPool.h"
+#include "ValidityMask.h"
+
+/// <summary>
+/// Describes where the pages of a <see cref="DesignMatrix"/> are placed on a NUMA machine.
+/// </summary>
+/// <remarks>
+/// Placement relies on the first-touch policy of the operating system: the storage is reserved without being touched,
+/// and the workers of the thread pool then write the pages they are responsible for. The placement only follows the
+/// NUMA layout when the pool was configured with <see cref="Threading::WorkerAffinity::Core"/> or
+/// <see cref="Threading::WorkerAffinity::Node"/>.
+/// </remarks>
+enum class MemoryPlacement {
+    /// <summary>
+    /// Pages are placed on the node of the thread that first writes them (typically the loader).
+    /// </summary>
+    Default,
+
+    /// <summary>
+    /// Pages are spread round-robin across the nodes of the pool's workers.
+    /// </summary>
+    Interleaved,
+
+    /// <summary>
+    /// The rows of each partition (see <see cref="DesignMatrix::RowPartition"/>) are placed on the node of the worker
+    /// that processes them.
+    /// </summary>
+    Partitioned
+};
+
+/// <summary>
+/// Contiguous, row-major storage for a design array, or a view over caller-owned column buffers and generated columns.
+/// </summary>
+class DesignMatrix {
+public:
+
+    /// <summary>
+    /// The number of rows that kernels process as one block (see <see cref="Rows"/>).
+    /// </summary>
+    static constexpr std::size_t BlockRows = 256;
+
+    DesignMatrix(std::size_t rowCount, std::size_t columnCount, MemoryPlacement placement = MemoryPlacement::Default, Threading::ThreadPool &pool = Threading::ThreadPool::Instance());
+
+    /// <summary>
+    /// Copies a design array into contiguous storage.
+    /// </summary>
+    /// <param name="design">
+    /// The design array, one vector per observation.
+    /// </param>
+    /// <param name="addConstant">
+    /// True to prepend a column of ones.
+    /// </param>
+    /// <param name="placement">
+    /// The NUMA placement of the storage.
+    /// </param>
+    /// <param name="pool">
+    /// The pool whose workers process the rows of the design.
+    /// </param>
+    explicit DesignMatrix(const std::vector<std::vector<double>> &design, bool addConstant = false, MemoryPlacement placement = MemoryPlacement::Default, Threading::ThreadPool &pool = Threading::ThreadPool::Instance());
+
+    /// <summary>
+    /// Wraps caller-owned column buffers without copying them. The buffers must outlive the returned matrix.
+    /// </summary>
+    /// <param name="rowCount">
+    /// The number of observations.
+    /// </param>
+    /// <param name="columns">
+    /// The first element of each column.
+    /// </param>
+    /// <param name="strides">
+    /// The distance, in elements, between consecutive observations of each column.
+    /// </param>
+    /// <param name="addConstant">
+    /// True to prepend a column of ones, which is not materialized.
+    /// </param>
+    /// <param name="pool">
+    /// The pool whose workers process the rows of the design.
+    /// </param>
+    static DesignMatrix Wrap(std::size_t rowCount, std::vector<const double *> columns, std::vector<std::ptrdiff_t> strides, bool addConstant = false, Threading::ThreadPool &pool = Threading::ThreadPool::Instance());
+
+    /// <summary>
+    /// Wraps caller-owned column buffers followed by the columns of generators, such as spline bases, which are
+    /// evaluated a block of rows at a time whenever a kernel reads the design (see <see cref="Rows"/>). No generated
+    /// column is ever materialized in full.
+    /// </summary>
+    /// <param name="rowCount">
+    /// The number of observations.
+    /// </param>
+    /// <param name="columns">
+    /// The first element of each column.
+    /// </param>
+    /// <param name="strides">
+    /// The distance, in elements, between consecutive observations of each column.
+    /// </param>
+    /// <param name="generators">
+    /// The generators of the remaining columns, in order. Their data must outlive the returned matrix.
+    /// </param>
+    /// <param name="addConstant">
+    /// True to prepend a column of ones, which is not materialized.
+    /// </param>
+    /// <param name="pool">
+    /// The pool whose workers process the rows of the design.
+    /// </param>
+    static DesignMatrix Wrap(std::size_t rowCount, std::vector<const double *> columns, std::vector<std::ptrdiff_t> strides, const std::vector<std::shared_ptr<const IColumnGenerator>> &generators, bool addConstant = false, Threading::ThreadPool &pool = Threading::ThreadPool::Instance());
+
+    DesignMatrix(const DesignMatrix &) = delete;
+
+    DesignMatrix &operator=(const DesignMatrix &) = delete;
+
+    DesignMatrix(DesignMatrix &&other) noexcept;
+
+    DesignMatrix &operator=(DesignMatrix &&other) noexcept;
+
+    ~DesignMatrix();
+
+    const std::size_t RowCount() const
+    { return _rowCount; }
+
+    const std::size_t ColumnCount() const
+    { return _columnCount; }
+
+    const MemoryPlacement Placement() const
+    { return _placement; }
+
+    /// <summary>
+    /// True if the matrix views caller-owned buffers or generated columns, in which case <see cref="Data"/> and
+    /// <see cref="Row"/> are unavailable and kernels read through <see cref="Rows"/>.
+    /// </summary>
+    const bool IsBorrowed() const
+    { return !_columns.empty(); }
+
+    Threading::ThreadPool &Pool() const
+    { return *_pool; }
+
+    double *Data()
+    { return _data; }
+
+    const double *Data() const
+    { return _data; }
+
+    double *Row(std::size_t row)
+    { return _data + row * _columnCount; }
+
+    const double *Row(std::size_t row) const
+    { return _data + row * _columnCount; }
+
+    double &operator()(std::size_t row, std::size_t column)
+    { return _data[row * _columnCount + column]; }
+
+    const double operator()(std::size_t row, std::size_t column) const
+    {
+        return IsMasked() && !_mask[row]
+               ? 0.0
+               : IsBorrowed()
+               ? (_columns[column] != nullptr ? _columns[column][static_cast<std::ptrdiff_t>(row) * _strides[column]] : Generated(row, column))
+               : _data[row * _columnCount + column];
+    }
+
+    /// <summary>
+    /// Returns the rows [first, first + count) as a contiguous row-major block. Owned storage is returned in place;
+    /// borrowed columns are gathered, and generated columns evaluated, into the scratch buffer. Rows masked out (see
+    /// <see cref="SetMask"/>) read as zeros.
+    /// </summary>
+    const double *Rows(std::size_t first, std::size_t count, std::vector<double> &scratch) const;
+
+    /// <summary>
+    /// The number of values per row that <see cref="Spans"/> returns: one per wrapped or owned column and the span of
+    /// each generator (see <see cref="IColumnGenerator::SpanWidth"/>).
+    /// </summary>
+    const std::size_t SpanWidth() const;
+
+    /// <summary>
+    /// True if some generator is sparse, so that <see cref="Spans"/> returns fewer values per row than
+    /// <see cref="Rows"/>.
+    /// </summary>
+    const bool IsSparse() const
+    { return SpanWidth() < _columnCount; }
+
+    /// <summary>
+    /// Returns the rows [first, first + count) as <see cref="SpanWidth"/> values per row, row-major, each with its
+    /// column in columns. The columns of a row ascend, and every column not listed is zero in that row. Rows masked
+    /// out read as zeros.
+    /// </summary>
+    const double *Spans(std::size_t first, std::size_t count, std::vector<double> &values, std::vector<std::size_t> &columns) const;
+
+    /// <summary>
+    /// Masks out the invalid observations, such as those with a missing value in some column, without moving any
+    /// row: through <see cref="Rows"/> and the const element accessor their rows read as zeros, so kernels skip them
+    /// at no cost beyond a test of one bit per row. <see cref="Data"/> and <see cref="Row"/> ignore the mask.
+    /// </summary>
+    /// <exception cref="std::out_of_range">
+    /// The mask differs in length from the design.
+    /// </exception>
+    void SetMask(ValidityMask mask);
+
+    /// <summary>
+    /// True if some observation is masked out.
+    /// </summary>
+    const bool IsMasked() const
+    { return _mask.RowCount() != 0; }
+
+    /// <summary>
+    /// The mask set by <see cref="SetMask"/>, or an empty mask if every observation is valid.
+    /// </summary>
+    const ValidityMask &Mask() const
+    { return _mask; }
+
+    /// <summary>
+    /// The number of observations not masked out.
+    /// </summary>
+    const std::size_t ValidRowCount() const
+    { return IsMasked() ? _mask.ValidCount() : _rowCount; }
+
+    /// <summary>
+    /// True if every valid observation has a one in the first column, as when the design adds a constant.
+    /// </summary>
+    const bool HasConstant() const;
+
+    /// <summary>
+    /// The rows [first, last) assigned to the given worker. Kernels that run through <see cref="ForEachPartition"/>
+    /// read exactly the rows that a <see cref="MemoryPlacement::Partitioned"/> matrix placed on that worker's node.
+    /// </summary>
+    std::pair<std::size_t, std::size_t> RowPartition(unsigned worker) const;
+
+    /// <summary>
+    /// Invokes body(worker, first, last) once per worker of the pool with that worker's row partition.
+    /// </summary>
+    template<typename TBody>
+    void ForEachPartition(const TBody &body) const
+    {
+        _pool->ForEachWorker(
+                [this, &body](unsigned worker) {
+                    const std::pair<std::size_t, std::size_t> rows = RowPartition(worker);
+                    body(worker, rows.first, rows.second);
+                });
+    }
+
+private:
+
+    DesignMatrix(std::size_t rowCount, std::vector<const double *> columns, std::vector<std::ptrdiff_t> strides, Threading::ThreadPool &pool);
+
+    void Allocate();
+
+    void Place();
+
+    double Generated(std::size_t row, std::size_t column) const;
+
+    const double *Gather(std::size_t first, std::size_t count, std::vector<double> &scratch) const;
+
+    double *_data;
+
+    std::size_t _rowCount;
+
+    std::size_t _columnCount;
+
+    std::size_t _bytes;
+
+    MemoryPlacement _placement;
+
+    Threading::ThreadPool *_pool;
+
+    /// <summary>
+    /// One entry per column of a view; null for a generated column.
+    /// </summary>
+    std::vector<const double *> _columns;
+
+    std::vector<std::ptrdiff_t> _strides;
+
+    /// <summary>
+    /// The generators of a view, with the index of the first column of each.
+    /// </summary>
+    std::vector<std::pair<std::size_t, std::shared_ptr<const IColumnGenerator>>> _generators;
+
+    /// <summary>
+    /// Empty unless some observation is masked out.
+    /// </summary>
+    ValidityMask _mask;
+};
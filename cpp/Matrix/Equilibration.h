@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+/// <summary>
+/// Scales a symmetric positive definite system A * x = b to unit diagonal: (D * A * D) * y = D * b with
+/// D = diag(1 / sqrt(Aᵢᵢ)), and x = D * y.
+/// </summary>
+/// <remarks>
+/// For normal equations A = Xᵀ * W * X this is exactly the system of the design X * D, whose columns all have unit
+/// weighted norm, so a design that mixes values in the billions with indicators is solved as if its columns had been
+/// rescaled, without copying or reading the design again: the scale factors come from the diagonal of the Gram matrix.
+/// The same D maps solutions and inverses back: x = D * y and A⁻¹ = D * (D * A * D)⁻¹ * D.
+/// </remarks>
+class Equilibration {
+public:
+
+    /// <param name="a">
+    /// The n x n symmetric array, stored row-major. Columns with a non-positive diagonal are left unscaled.
+    /// </param>
+    /// <param name="n">
+    /// The dimension of the array.
+    /// </param>
+    Equilibration(const std::vector<double> &a, const std::size_t n)
+            : _scale(n, 1.0)
+    {
+        if (a.size() != n * n) {
+            throw std::out_of_range("Input array should be square.");
+        }
+
+        for (std::size_t i = 0; i < n; i++) {
+            if (a[i * n + i] > 0.0) {
+                _scale[i] = 1.0 / std::sqrt(a[i * n + i]);
+            }
+        }
+    }
+
+    const std::vector<double> &Scale() const
+    { return _scale; }
+
+    /// <summary>
+    /// Returns D * v for a vector of length n: the scaled right-hand side D * b, or the solution x = D * y.
+    /// </summary>
+    std::vector<double> ApplyToVector(const std::vector<double> &v) const
+    {
+        const std::size_t n = _scale.size();
+
+        if (v.size() != n) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        std::vector<double> result(v);
+
+        for (std::size_t i = 0; i < n; i++) {
+            result[i] *= _scale[i];
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// Returns D * a * D for an n x n array, stored row-major: the scaled system D * A * D, or the inverse
+    /// A⁻¹ = D * (D * A * D)⁻¹ * D.
+    /// </summary>
+    std::vector<double> ApplyToMatrix(const std::vector<double> &a) const
+    {
+        const std::size_t n = _scale.size();
+
+        if (a.size() != n * n) {
+            throw std::out_of_range("Input array should be square.");
+        }
+
+        std::vector<double> result(a);
+
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t j = 0; j < n; j++) {
+                result[i * n + j] *= _scale[i] * _scale[j];
+            }
+        }
+
+        return result;
+    }
+
+private:
+
+    std::vector<double> _scale;
+};
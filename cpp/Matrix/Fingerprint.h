@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "DesignMatrix.h"
+
+/// <summary>
+/// The 64-bit xxHash (XXH64) of a byte stream, computed incrementally.
+/// </summary>
+class Xxh64 {
+public:
+
+    explicit Xxh64(const std::uint64_t seed = 0)
+            : _accumulators{seed + Prime1 + Prime2, seed + Prime2, seed, seed - Prime1},
+              _seed(seed),
+              _length(0),
+              _buffered(0)
+    {
+    }
+
+    void Update(const void *data, std::size_t length)
+    {
+        const auto *bytes = static_cast<const unsigned char *>(data);
+
+        _length += length;
+
+        if (_buffered > 0) {
+            const std::size_t count = std::min(length, sizeof(_buffer) - _buffered);
+
+            std::memcpy(_buffer + _buffered, bytes, count);
+            _buffered += count;
+            bytes += count;
+            length -= count;
+
+            if (_buffered < sizeof(_buffer)) {
+                return;
+            }
+
+            Stripe(_buffer);
+            _buffered = 0;
+        }
+
+        for (; length >= sizeof(_buffer); bytes += sizeof(_buffer), length -= sizeof(_buffer)) {
+            Stripe(bytes);
+        }
+
+        std::memcpy(_buffer, bytes, length);
+        _buffered = length;
+    }
+
+    void Update(const std::uint64_t value)
+    { Update(&value, sizeof(value)); }
+
+    const std::uint64_t Digest() const
+    {
+        std::uint64_t hash;
+
+        if (_length >= sizeof(_buffer)) {
+            hash = Rotate(_accumulators[0], 1) + Rotate(_accumulators[1], 7) + Rotate(_accumulators[2], 12) + Rotate(_accumulators[3], 18);
+
+            for (const std::uint64_t accumulator : _accumulators) {
+                hash = (hash ^ Round(0, accumulator)) * Prime1 + Prime4;
+            }
+        }
+        else {
+            hash = _seed + Prime5;
+        }
+
+        hash += _length;
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= _buffered; i += 8) {
+            hash = Rotate(hash ^ Round(0, Read64(_buffer + i)), 27) * Prime1 + Prime4;
+        }
+        if (i + 4 <= _buffered) {
+            hash = Rotate(hash ^ Read32(_buffer + i) * Prime1, 23) * Prime2 + Prime3;
+            i += 4;
+        }
+        for (; i < _buffered; i++) {
+            hash = Rotate(hash ^ _buffer[i] * Prime5, 11) * Prime1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= Prime2;
+        hash ^= hash >> 29;
+        hash *= Prime3;
+        hash ^= hash >> 32;
+
+        return hash;
+    }
+
+private:
+
+    static constexpr std::uint64_t Prime1 = 11400714785074694791ULL;
+
+    static constexpr std::uint64_t Prime2 = 14029467366897019727ULL;
+
+    static constexpr std::uint64_t Prime3 = 1609587929392839161ULL;
+
+    static constexpr std::uint64_t Prime4 = 9650029242287828579ULL;
+
+    static constexpr std::uint64_t Prime5 = 2870177450012600261ULL;
+
+    static std::uint64_t Rotate(const std::uint64_t x, const int bits)
+    { return (x << bits) | (x >> (64 - bits)); }
+
+    static std::uint64_t Round(const std::uint64_t accumulator, const std::uint64_t input)
+    { return Rotate(accumulator + input * Prime2, 31) * Prime1; }
+
+    static std::uint64_t Read64(const unsigned char *bytes)
+    {
+        std::uint64_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    static std::uint64_t Read32(const unsigned char *bytes)
+    {
+        std::uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    void Stripe(const unsigned char *bytes)
+    {
+        for (std::size_t lane = 0; lane < 4; lane++) {
+            _accumulators[lane] = Round(_accumulators[lane], Read64(bytes + 8 * lane));
+        }
+    }
+
+    std::uint64_t _accumulators[4];
+
+    std::uint64_t _seed;
+
+    std::uint64_t _length;
+
+    unsigned char _buffer[32];
+
+    std::size_t _buffered;
+};
+
+/// <summary>
+/// Computes content fingerprints of designs and vectors on the library thread pool.
+/// </summary>
+/// <remarks>
+/// The data is cut into chunks of a fixed size, each chunk is hashed with <see cref="Xxh64"/> on a pool worker, and the
+/// fingerprint is the hash of the shape followed by the chunk digests in order. The chunking depends only on the shape,
+/// so a fingerprint is the same for any number of workers and for owned and borrowed designs with equal values. A
+/// masked design also hashes its validity mask, since its masked rows read as zeros and would otherwise collide with a
+/// design whose rows really are zero.
+/// </remarks>
+struct Fingerprint {
+    /// <summary>
+    /// The approximate number of bytes hashed by one task.
+    /// </summary>
+    static constexpr std::size_t ChunkBytes = 1 << 20;
+
+    const std::uint64_t operator()(const DesignMatrix &design) const
+    {
+        const std::size_t k = std::max<std::size_t>(design.ColumnCount(), 1);
+        const std::size_t blocks = std::max<std::size_t>(ChunkBytes / (k * sizeof(double) * DesignMatrix::BlockRows), 1);
+        const std::size_t chunkRows = blocks * DesignMatrix::BlockRows;
+        const std::size_t chunks = (design.RowCount() + chunkRows - 1) / chunkRows;
+
+        std::vector<std::uint64_t> digests(chunks);
+
+        design.Pool().ParallelFor(
+                0,
+                chunks,
+                1,
+                [&](std::size_t first, std::size_t last) {
+                    std::vector<double> scratch;
+
+                    for (std::size_t chunk = first; chunk < last; chunk++) {
+                        const std::size_t end = std::min(design.RowCount(), (chunk + 1) * chunkRows);
+
+                        Xxh64 hash;
+
+                        for (std::size_t row = chunk * chunkRows; row < end; row += DesignMatrix::BlockRows) {
+                            const std::size_t count = std::min(DesignMatrix::BlockRows, end - row);
+                            hash.Update(design.Rows(row, count, scratch), count * design.ColumnCount() * sizeof(double));
+                        }
+
+                        digests[chunk] = hash.Digest();
+                    }
+                });
+
+        const std::uint64_t digest = Combine(design.RowCount(), design.ColumnCount(), digests);
+
+        if (!design.IsMasked()) {
+            return digest;
+        }
+
+        std::vector<std::uint64_t> words = design.Mask().Words();
+
+        if (design.RowCount() % 64 != 0) {
+            words.back() &= (std::uint64_t{1} << (design.RowCount() % 64)) - 1;
+        }
+
+        Xxh64 hash(digest);
+        hash.Update(words.data(), words.size() * sizeof(std::uint64_t));
+
+        return hash.Digest();
+    }
+
+    const std::uint64_t operator()(const std::vector<double> &values, Threading::ThreadPool &pool = Threading::ThreadPool::Instance()) const
+    {
+        const std::size_t chunkValues = ChunkBytes / sizeof(double);
+        const std::size_t chunks = (values.size() + chunkValues - 1) / chunkValues;
+
+        std::vector<std::uint64_t> digests(chunks);
+
+        pool.ParallelFor(
+                0,
+                chunks,
+                1,
+                [&](std::size_t first, std::size_t last) {
+                    for (std::size_t chunk = first; chunk < last; chunk++) {
+                        const std::size_t begin = chunk * chunkValues;
+                        const std::size_t count = std::min(chunkValues, values.size() - begin);
+
+                        Xxh64 hash;
+                        hash.Update(values.data() + begin, count * sizeof(double));
+
+                        digests[chunk] = hash.Digest();
+                    }
+                });
+
+        return Combine(values.size(), 1, digests);
+    }
+
+private:
+
+    static std::uint64_t Combine(const std::uint64_t rows, const std::uint64_t columns, const std::vector<std::uint64_t> &digests)
+    {
+        Xxh64 hash;
+
+        hash.Update(rows);
+        hash.Update(columns);
+        hash.Update(digests.data(), digests.size() * sizeof(std::uint64_t));
+
+        return hash.Digest();
+    }
+};
+
+static const Fingerprint fingerprint = {};
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <stdexcept>
+#include "InteractionColumns.h"
+
+InteractionColumns::InteractionColumns(std::vector<CategoricalColumn> factors, const bool dropReference)
+        : InteractionColumns(nullptr, 0, std::move(factors), dropReference)
+{
+}
+
+InteractionColumns::InteractionColumns(const double *values, const std::ptrdiff_t stride, std::vector<CategoricalColumn> factors, const bool dropReference)
+        : _factors(std::move(factors)),
+          _dropReference(dropReference),
+          _cellCount(1),
+          _values(values),
+          _stride(stride),
+          _termWidth(1)
+{
+    if (_factors.empty()) {
+        throw std::out_of_range("Argument vector is empty.");
+    }
+
+    for (const CategoricalColumn &factor : _factors) {
+        if (factor.RowCount() != _factors[0].RowCount()) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        const std::size_t levels = factor.LevelCount() - (dropReference && factor.LevelCount() > 0 ? 1 : 0);
+
+        if (levels != 0 && _cellCount > std::numeric_limits<std::size_t>::max() / levels) {
+            throw std::out_of_range("Too many cells.");
+        }
+
+        _cellCount *= levels;
+    }
+}
+
+InteractionColumns::InteractionColumns(std::shared_ptr<const IColumnGenerator> term, std::vector<CategoricalColumn> factors, const bool dropReference)
+        : InteractionColumns(nullptr, 0, std::move(factors), dropReference)
+{
+    if (term == nullptr) {
+        throw std::invalid_argument("Column generators must not be null.");
+    }
+
+    _termWidth = term->Width();
+    _term = std::move(term);
+}
+
+const std::size_t InteractionColumns::Cell(const std::size_t row) const
+{
+    const std::size_t reference = _dropReference ? 1 : 0;
+
+    std::size_t cell = 0;
+
+    for (const CategoricalColumn &factor : _factors) {
+        const std::uint32_t code = factor[row];
+
+        if (code < reference) {
+            return NoCell;
+        }
+
+        cell = cell * (factor.LevelCount() - reference) + (code - reference);
+    }
+
+    return cell;
+}
+
+std::vector<std::uint32_t> InteractionColumns::Levels(std::size_t cell) const
+{
+    const std::size_t reference = _dropReference ? 1 : 0;
+
+    std::vector<std::uint32_t> result(_factors.size());
+
+    for (std::size_t f = _factors.size(); f-- > 0;) {
+        const std::size_t radix = _factors[f].LevelCount() - reference;
+
+        result[f] = static_cast<std::uint32_t>(cell % radix + reference);
+        cell /= radix;
+    }
+
+    return result;
+}
+
+void InteractionColumns::GenerateTerms(const std::size_t first, const std::size_t count, std::size_t *cells, double *terms) const
+{
+    if (_term != nullptr) {
+        _term->Generate(first, count, terms, _termWidth);
+    }
+
+    for (std::size_t i = 0; i < count; i++) {
+        cells[i] = Cell(first + i);
+
+        if (cells[i] == NoCell) {
+            std::fill(terms + i * _termWidth, terms + (i + 1) * _termWidth, 0.0);
+        } else if (_term == nullptr) {
+            terms[i] = _values != nullptr ? _values[static_cast<std::ptrdiff_t>(first + i) * _stride] : 1.0;
+        }
+    }
+}
+
+void InteractionColumns::Generate(const std::size_t first, const std::size_t count, double *block, const std::size_t stride) const
+{
+    const std::size_t width = Width();
+
+    std::vector<std::size_t> cells(count);
+    std::vector<double> terms(count * _termWidth);
+
+    GenerateTerms(first, count, cells.data(), terms.data());
+
+    for (std::size_t i = 0; i < count; i++) {
+        double *row = block + i * stride;
+
+        std::fill(row, row + width, 0.0);
+
+        if (cells[i] != NoCell) {
+            std::copy(terms.begin() + i * _termWidth, terms.begin() + (i + 1) * _termWidth, row + cells[i] * _termWidth);
+        }
+    }
+}
+
+void InteractionColumns::GenerateSpans(const std::size_t first, const std::size_t count, std::size_t *offsets, double *values) const
+{
+    GenerateTerms(first, count, offsets, values);
+
+    for (std::size_t i = 0; i < count; i++) {
+        offsets[i] = offsets[i] == NoCell ? 0 : offsets[i] * _termWidth;
+    }
+}
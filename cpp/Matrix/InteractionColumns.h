@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "CategoricalColumn.h"
+#include "IColumnGenerator.h"
+
+/// <summary>
+/// The interaction of a term with one or more factors, generated on the fly (see <see cref="DesignMatrix::Wrap"/>).
+/// </summary>
+/// <remarks>
+/// The combinations of the factors' levels, the cells, are indexed combinatorially: the codes of the factors are the
+/// digits of a mixed-radix number whose place values are the level counts. A row of the generated block is zero
+/// except at its own cell, which holds the row of the term (one, a continuous variable, or the columns of another
+/// generator, such as a spline basis). Neither the indicators nor the products are ever stored, unlike the output of
+/// the C# Indicators.Indicate, and kernels that read the design through <see cref="DesignMatrix::Spans"/> see only the
+/// cell's columns, so a row costs the square of the term's width rather than of the whole block.
+/// </remarks>
+class InteractionColumns : public IColumnGenerator {
+public:
+
+    /// <summary>
+    /// The indicators of the cells of the factors, such as exporter by sector.
+    /// </summary>
+    /// <param name="factors">
+    /// The factors, whose first varies slowest across the columns.
+    /// </param>
+    /// <param name="dropReference">
+    /// True to omit the cells at the first level of any factor, which are collinear with a constant and the lower
+    /// order terms. A row in an omitted cell is zero.
+    /// </param>
+    /// <exception cref="std::out_of_range">
+    /// The factors differ in length, or there are too many cells.
+    /// </exception>
+    explicit InteractionColumns(std::vector<CategoricalColumn> factors, bool dropReference = false);
+
+    /// <summary>
+    /// The interaction of a continuous variable with the cells of the factors, such as distance by year.
+    /// </summary>
+    /// <param name="values">
+    /// The first value of the variable, which must outlive the generator.
+    /// </param>
+    /// <param name="stride">
+    /// The distance, in elements, between consecutive values.
+    /// </param>
+    /// <param name="factors">
+    /// The factors, whose first varies slowest across the columns.
+    /// </param>
+    /// <param name="dropReference">
+    /// True to omit the cells at the first level of any factor.
+    /// </param>
+    InteractionColumns(const double *values, std::ptrdiff_t stride, std::vector<CategoricalColumn> factors, bool dropReference = false);
+
+    /// <summary>
+    /// The interaction of the columns of a generator with the cells of the factors, such as a spline of distance by
+    /// year. The columns of each cell are adjacent.
+    /// </summary>
+    /// <param name="term">
+    /// The generator of the columns interacted.
+    /// </param>
+    /// <param name="factors">
+    /// The factors, whose first varies slowest across the cells.
+    /// </param>
+    /// <param name="dropReference">
+    /// True to omit the cells at the first level of any factor.
+    /// </param>
+    InteractionColumns(std::shared_ptr<const IColumnGenerator> term, std::vector<CategoricalColumn> factors, bool dropReference = false);
+
+    /// <summary>
+    /// Indicates a row in an omitted cell.
+    /// </summary>
+    static constexpr std::size_t NoCell = std::numeric_limits<std::size_t>::max();
+
+    const std::size_t Width() const override
+    { return _cellCount * _termWidth; }
+
+    /// <summary>
+    /// The number of cells, excluding any omitted.
+    /// </summary>
+    const std::size_t CellCount() const
+    { return _cellCount; }
+
+    const std::vector<CategoricalColumn> &Factors() const
+    { return _factors; }
+
+    /// <summary>
+    /// The number of columns of each cell.
+    /// </summary>
+    const std::size_t TermWidth() const
+    { return _termWidth; }
+
+    /// <summary>
+    /// Returns the cell of a row, or <see cref="NoCell"/> if it is omitted.
+    /// </summary>
+    const std::size_t Cell(std::size_t row) const;
+
+    /// <summary>
+    /// Returns the level of each factor at a cell.
+    /// </summary>
+    std::vector<std::uint32_t> Levels(std::size_t cell) const;
+
+    /// <summary>
+    /// Writes the cell of each row, or <see cref="NoCell"/>, to cells and the <see cref="TermWidth"/> values of the
+    /// term to consecutive rows of terms. These are all the nonzero values of the generated rows.
+    /// </summary>
+    void GenerateTerms(std::size_t first, std::size_t count, std::size_t *cells, double *terms) const;
+
+    void Generate(std::size_t first, std::size_t count, double *block, std::size_t stride) const override;
+
+    const std::size_t SpanWidth() const override
+    { return _termWidth; }
+
+    void GenerateSpans(std::size_t first, std::size_t count, std::size_t *offsets, double *values) const override;
+
+private:
+
+    std::vector<CategoricalColumn> _factors;
+
+    bool _dropReference;
+
+    std::size_t _cellCount;
+
+    const double *_values;
+
+    std::ptrdiff_t _stride;
+
+    std::shared_ptr<const IColumnGenerator> _term;
+
+    std::size_t _termWidth;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "DesignMatrix.h"
+#include "Kernels.h"
+#include "ValidityMask.h"
+
+/// <summary>
+/// Multiplies a design array by a coefficient vector.
+/// </summary>
+struct MatrixProduct {
+    /// <param name="valid">
+    /// The observations to compute, or an empty mask to compute those of the design (see
+    /// <see cref="DesignMatrix::Mask"/>). Blocks with no valid row are not read and their results are zero.
+    /// </param>
+    std::vector<double> operator()(const DesignMatrix &design, const std::vector<double> &coefficients, const ValidityMask &valid = ValidityMask()) const
+    {
+        if (design.ColumnCount() != coefficients.size() || (valid.RowCount() != 0 && valid.RowCount() != design.RowCount())) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        const ValidityMask &mask = valid.RowCount() != 0 ? valid : design.Mask();
+
+        const Kernels::KernelTable &kernels = Kernels::Active();
+
+        std::vector<double> result(design.RowCount());
+
+        design.ForEachPartition(
+                [&](unsigned, std::size_t first, std::size_t last) {
+                    const std::size_t k = coefficients.size();
+
+                    std::vector<double> scratch;
+
+                    for (std::size_t block = first; block < last; block += DesignMatrix::BlockRows) {
+                        const std::size_t count = std::min(DesignMatrix::BlockRows, last - block);
+
+                        if (mask.RowCount() != 0 && mask.CountValid(block, count) == 0) {
+                            continue;
+                        }
+
+                        const double *x = design.Rows(block, count, scratch);
+
+                        kernels.MultiplyRows(x, count, k, coefficients.data(), result.data() + block);
+                    }
+                });
+
+        return result;
+    }
+};
+
+static const MatrixProduct matrixProduct = {};
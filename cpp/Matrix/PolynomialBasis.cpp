@@ -0,0 +1,96 @@
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include "PolynomialBasis.h"
+
+OrthogonalPolynomialBasis::OrthogonalPolynomialBasis(
+        const double *values,
+        const std::ptrdiff_t stride,
+        const std::size_t rowCount,
+        const std::size_t degree,
+        const ValidityMask &valid,
+        Threading::ThreadPool &pool)
+        : _values(values),
+          _stride(stride)
+{
+    // Pass k evaluates Pₖ from the coefficients of the earlier passes and accumulates ‖Pₖ‖² and Σ x * Pₖ(x)².
+    for (std::size_t k = 0; k <= degree; k++) {
+        const std::array<double, 2> sums = pool.ParallelReduce(
+                0,
+                rowCount,
+                Threading::ThreadPool::DefaultGrain,
+                std::array<double, 2>{0.0, 0.0},
+                [&](std::size_t first, std::size_t last) {
+                    std::array<double, 2> partial{0.0, 0.0};
+
+                    for (std::size_t i = first; i < last; i++) {
+                        if (valid.RowCount() != 0 && !valid[i]) {
+                            continue;
+                        }
+
+                        const double x = values[static_cast<std::ptrdiff_t>(i) * stride];
+
+                        double previous = 0.0;
+                        double current = 1.0;
+
+                        for (std::size_t j = 0; j < k; j++) {
+                            const double next = (x - _alpha[j]) * current - (j == 0 ? 0.0 : _norms[j] / _norms[j - 1]) * previous;
+
+                            previous = current;
+                            current = next;
+                        }
+
+                        partial[0] += current * current;
+                        partial[1] += x * current * current;
+                    }
+
+                    return partial;
+                },
+                [](const std::array<double, 2> &a, const std::array<double, 2> &b) {
+                    return std::array<double, 2>{a[0] + b[0], a[1] + b[1]};
+                });
+
+        // A polynomial that vanishes on every value has a norm that is zero up to rounding, relative to the norm of
+        // its predecessor times the spread of the values.
+        const double scale = k == 0 ? 0.0 : k == 1 ? _norms[0] * _alpha[0] * _alpha[0] : _norms[k - 1] * _norms[1] / _norms[0];
+
+        if (!(sums[0] > 1e-12 * scale)) {
+            throw std::domain_error("Degree must be less than the number of distinct values.");
+        }
+
+        _norms.push_back(sums[0]);
+
+        if (k < degree) {
+            _alpha.push_back(sums[1] / sums[0]);
+        }
+    }
+}
+
+OrthogonalPolynomialBasis::OrthogonalPolynomialBasis(const double *values, const std::ptrdiff_t stride, const OrthogonalPolynomialBasis &fitted)
+        : _values(values),
+          _stride(stride),
+          _alpha(fitted._alpha),
+          _norms(fitted._norms)
+{
+}
+
+void OrthogonalPolynomialBasis::Generate(const std::size_t first, const std::size_t count, double *block, const std::size_t stride) const
+{
+    const std::size_t degree = _alpha.size();
+
+    for (std::size_t i = 0; i < count; i++) {
+        const double x = _values[static_cast<std::ptrdiff_t>(first + i) * _stride];
+
+        double *row = block + i * stride;
+        double previous = 0.0;
+        double current = 1.0;
+
+        for (std::size_t j = 0; j < degree; j++) {
+            const double next = (x - _alpha[j]) * current - (j == 0 ? 0.0 : _norms[j] / _norms[j - 1]) * previous;
+
+            previous = current;
+            current = next;
+            row[j] = current / sqrt(_norms[j + 1]);
+        }
+    }
+}
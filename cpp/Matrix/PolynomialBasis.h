@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "IColumnGenerator.h"
+#include "ThreadPool.h"
+#include "ValidityMask.h"
+
+/// <summary>
+/// The orthogonal polynomial basis of a variable, generated on the fly (see <see cref="DesignMatrix::Wrap"/>).
+/// </summary>
+/// <remarks>
+/// The columns are the polynomials of degree 1 through d that are orthonormal over the observed values, as R's poly
+/// does. They satisfy the three-term recurrence Pₖ₊₁(x) = (x - αₖ) * Pₖ(x) - (‖Pₖ‖² / ‖Pₖ₋₁‖²) * Pₖ₋₁(x), whose
+/// coefficients are found by d + 1 passes over the values at construction. Each row then costs O(d).
+/// </remarks>
+class OrthogonalPolynomialBasis : public IColumnGenerator {
+public:
+
+    /// <param name="values">
+    /// The first value of the variable, which must outlive the basis.
+    /// </param>
+    /// <param name="stride">
+    /// The distance, in elements, between consecutive values.
+    /// </param>
+    /// <param name="rowCount">
+    /// The number of values over which the polynomials are orthogonal.
+    /// </param>
+    /// <param name="degree">
+    /// The highest degree.
+    /// </param>
+    /// <param name="valid">
+    /// The values over which the polynomials are orthogonal, or an empty mask for all of them.
+    /// </param>
+    /// <param name="pool">
+    /// The pool whose workers compute the recurrence coefficients.
+    /// </param>
+    /// <exception cref="std::domain_error">
+    /// The degree is not less than the number of distinct values.
+    /// </exception>
+    OrthogonalPolynomialBasis(
+            const double *values,
+            std::ptrdiff_t stride,
+            std::size_t rowCount,
+            std::size_t degree,
+            const ValidityMask &valid = ValidityMask(),
+            Threading::ThreadPool &pool = Threading::ThreadPool::Instance());
+
+    /// <summary>
+    /// Evaluates the polynomials of a fitted basis at other values, such as those of a prediction sample.
+    /// </summary>
+    OrthogonalPolynomialBasis(const double *values, std::ptrdiff_t stride, const OrthogonalPolynomialBasis &fitted);
+
+    const std::size_t Width() const override
+    { return _alpha.size(); }
+
+    /// <summary>
+    /// The recurrence coefficients α₀, ..., αₐ₋₁.
+    /// </summary>
+    const std::vector<double> &Alpha() const
+    { return _alpha; }
+
+    /// <summary>
+    /// The squared norms ‖P₀‖², ..., ‖Pₐ‖².
+    /// </summary>
+    const std::vector<double> &Norms() const
+    { return _norms; }
+
+    void Generate(std::size_t first, std::size_t count, double *block, std::size_t stride) const override;
+
+private:
+
+    const double *_values;
+
+    std::ptrdiff_t _stride;
+
+    std::vector<double> _alpha;
+
+    std::vector<double> _norms;
+};
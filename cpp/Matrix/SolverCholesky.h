@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+/// <summary>
+/// Solves an equation of the form A * x = b where A = L * Lᵀ.
+/// </summary>
+/// <remarks>
+/// With A = Xᵀ * W * X and b = Xᵀ * W * z, this yields the weighted least squares coefficients by a forward
+/// substitution with L followed by a backward substitution with Lᵀ.
+/// </remarks>
+struct SolverCholesky {
+    /// <summary>
+    /// Solves an equation of the form A * x = b where A = L * Lᵀ.
+    /// </summary>
+    /// <param name="lower">
+    /// The lower triangular factor, stored row-major.
+    /// </param>
+    /// <param name="b">
+    /// The right-hand side vector.
+    /// </param>
+    /// <returns>
+    /// The solution vector.
+    /// </returns>
+    std::vector<double> operator()(const std::vector<double> &lower, const std::vector<double> &b) const
+    {
+        const std::size_t n = b.size();
+
+        if (lower.size() != n * n) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        std::vector<double> x(b);
+
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t k = 0; k < i; k++) {
+                x[i] -= lower[i * n + k] * x[k];
+            }
+            x[i] /= lower[i * n + i];
+        }
+
+        for (std::size_t i = n; i-- > 0;) {
+            for (std::size_t k = i + 1; k < n; k++) {
+                x[i] -= lower[k * n + i] * x[k];
+            }
+            x[i] /= lower[i * n + i];
+        }
+
+        return x;
+    }
+};
+
+static const SolverCholesky solverCholesky = {};
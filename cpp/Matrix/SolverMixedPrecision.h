@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "DecompositionCholesky.h"
+#include "SolverCholesky.h"
+
+/// <summary>
+/// Solves a symmetric positive definite system A * x = b by a single precision Cholesky factorization followed by
+/// iterative refinement in double precision.
+/// </summary>
+/// <remarks>
+/// The factorization dominates the cost of a solve (k³/3 operations against k² per refinement step) and runs at
+/// twice the vector width and half the memory traffic in single precision. Each refinement step computes the residual
+/// r = b - A * x in double precision and corrects x by the single precision solution of A * d = r, which recovers full
+/// double accuracy whenever the condition number of A is well below 1 / ε(float) ≈ 10⁷. When the factorization
+/// fails or the corrections stop shrinking, the system is solved again by <see cref="DecompositionCholesky"/>.
+/// </remarks>
+struct SolverMixedPrecision {
+    /// <summary>
+    /// The largest number of refinement steps before falling back to a double precision factorization.
+    /// </summary>
+    static constexpr std::size_t MaxRefinements = 30;
+
+    /// <summary>
+    /// Solves A * x = b.
+    /// </summary>
+    /// <param name="a">
+    /// The n x n symmetric positive definite array, stored row-major.
+    /// </param>
+    /// <param name="b">
+    /// The right-hand side vector.
+    /// </param>
+    /// <returns>
+    /// The solution vector.
+    /// </returns>
+    std::vector<double> operator()(const std::vector<double> &a, const std::vector<double> &b) const
+    {
+        const std::size_t n = b.size();
+
+        if (a.size() != n * n) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        std::vector<float> upper;
+
+        if (!Factor(a, n, upper)) {
+            return solverCholesky(decompositionCholesky(a, n), b);
+        }
+
+        // Refinement stops once the residual is at the level of rounding in A * x, as in LAPACK's dsposv.
+        double norm = 0.0;
+
+        for (std::size_t i = 0; i < n; i++) {
+            double sum = 0.0;
+
+            for (std::size_t k = 0; k < n; k++) {
+                sum += std::abs(a[i * n + k]);
+            }
+
+            norm = std::max(norm, sum);
+        }
+
+        const double threshold = std::sqrt(static_cast<double>(n)) * std::numeric_limits<double>::epsilon() * norm;
+
+        std::vector<double> x(n, 0.0);
+        std::vector<double> residual(b);
+        std::vector<float> correction(n);
+
+        double previous = std::numeric_limits<double>::infinity();
+
+        for (std::size_t step = 0; step < MaxRefinements; step++) {
+            Solve(upper, n, residual, correction);
+
+            double size = 0.0;
+            double magnitude = 0.0;
+            double remaining = 0.0;
+
+            for (std::size_t i = 0; i < n; i++) {
+                x[i] += correction[i];
+                size = std::max(size, std::abs(static_cast<double>(correction[i])));
+                magnitude = std::max(magnitude, std::abs(x[i]));
+            }
+
+            for (std::size_t i = 0; i < n; i++) {
+                double sum = b[i];
+
+                for (std::size_t k = 0; k < n; k++) {
+                    sum -= a[i * n + k] * x[k];
+                }
+
+                residual[i] = sum;
+                remaining = std::max(remaining, std::abs(sum));
+            }
+
+            if (remaining <= threshold * magnitude) {
+                return x;
+            }
+            if (!(size < 0.5 * previous)) {
+                break;
+            }
+
+            previous = size;
+        }
+
+        // The refinement stalled: A is too ill-conditioned for a single precision factor.
+        return solverCholesky(decompositionCholesky(a, n), b);
+    }
+
+private:
+
+    /// <summary>
+    /// Computes the upper factor U = Lᵀ in single precision, row-major, with right-looking updates whose inner loops
+    /// run along contiguous rows.
+    /// </summary>
+    static bool Factor(const std::vector<double> &a, const std::size_t n, std::vector<float> &upper)
+    {
+        upper.assign(n * n, 0.0f);
+
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t k = i; k < n; k++) {
+                upper[i * n + k] = static_cast<float>(a[i * n + k]);
+            }
+        }
+
+        for (std::size_t j = 0; j < n; j++) {
+            float *row = upper.data() + j * n;
+
+            if (!(row[j] > 0.0f)) {
+                return false;
+            }
+
+            const float pivot = std::sqrt(row[j]);
+            const float inverse = 1.0f / pivot;
+
+            row[j] = pivot;
+
+            for (std::size_t k = j + 1; k < n; k++) {
+                row[k] *= inverse;
+            }
+
+            for (std::size_t i = j + 1; i < n; i++) {
+                float *target = upper.data() + i * n;
+                const float factor = row[i];
+
+                for (std::size_t k = i; k < n; k++) {
+                    target[k] -= factor * row[k];
+                }
+            }
+        }
+
+        return true;
+    }
+
+    /// <summary>
+    /// Solves Uᵀ * U * d = r in single precision.
+    /// </summary>
+    static void Solve(const std::vector<float> &upper, const std::size_t n, const std::vector<double> &residual, std::vector<float> &result)
+    {
+        for (std::size_t i = 0; i < n; i++) {
+            result[i] = static_cast<float>(residual[i]);
+        }
+
+        for (std::size_t i = 0; i < n; i++) {
+            const float *row = upper.data() + i * n;
+
+            result[i] /= row[i];
+
+            for (std::size_t k = i + 1; k < n; k++) {
+                result[k] -= row[k] * result[i];
+            }
+        }
+
+        for (std::size_t i = n; i-- > 0;) {
+            const float *row = upper.data() + i * n;
+
+            float sum = result[i];
+
+            for (std::size_t k = i + 1; k < n; k++) {
+                sum -= row[k] * result[k];
+            }
+
+            result[i] = sum / row[i];
+        }
+    }
+};
+
+static const SolverMixedPrecision solverMixedPrecision = {};
@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <utility>
+#include "SparseCholesky.h"
+
+namespace {
+    constexpr std::size_t None = std::numeric_limits<std::size_t>::max();
+
+    /// <summary>
+    /// Orders the vertices of the graph of a symmetric pattern by minimum degree, eliminating one vertex at a time and
+    /// joining its neighbours into a clique. Ties go to the lowest vertex, so the order is deterministic.
+    /// </summary>
+    std::vector<std::size_t> MinimumDegree(const SparseMatrix &pattern)
+    {
+        const std::size_t n = pattern.Dimension;
+
+        std::vector<std::set<std::size_t>> adjacency(n);
+
+        for (std::size_t j = 0; j < n; j++) {
+            for (std::size_t p = pattern.ColumnStarts[j]; p < pattern.ColumnStarts[j + 1]; p++) {
+                const std::size_t i = pattern.RowIndices[p];
+
+                if (i != j) {
+                    adjacency[i].insert(j);
+                    adjacency[j].insert(i);
+                }
+            }
+        }
+
+        std::set<std::pair<std::size_t, std::size_t>> queue;
+
+        for (std::size_t v = 0; v < n; v++) {
+            queue.emplace(adjacency[v].size(), v);
+        }
+
+        std::vector<std::size_t> order;
+        order.reserve(n);
+
+        while (!queue.empty()) {
+            const std::size_t v = queue.begin()->second;
+            queue.erase(queue.begin());
+            order.push_back(v);
+
+            const std::set<std::size_t> neighbours = std::move(adjacency[v]);
+            adjacency[v].clear();
+
+            for (std::size_t a : neighbours) {
+                queue.erase({adjacency[a].size(), a});
+
+                adjacency[a].erase(v);
+
+                for (std::size_t b : neighbours) {
+                    if (b != a) {
+                        adjacency[a].insert(b);
+                    }
+                }
+
+                queue.emplace(adjacency[a].size(), a);
+            }
+        }
+
+        return order;
+    }
+}
+
+SparseCholesky::SparseCholesky(const SparseMatrix &pattern)
+        : _dimension(pattern.Dimension)
+{
+    const std::size_t n = _dimension;
+
+    if (pattern.ColumnStarts.size() != n + 1 || pattern.RowIndices.size() != pattern.ColumnStarts[n]) {
+        throw std::out_of_range("Argument vectors differ in length.");
+    }
+
+    for (std::size_t j = 0; j < n; j++) {
+        for (std::size_t p = pattern.ColumnStarts[j]; p < pattern.ColumnStarts[j + 1]; p++) {
+            if (pattern.RowIndices[p] > j) {
+                throw std::invalid_argument("The pattern must hold only the upper triangle.");
+            }
+        }
+    }
+
+    _permutation = MinimumDegree(pattern);
+
+    std::vector<std::size_t> inverse(n);
+
+    for (std::size_t i = 0; i < n; i++) {
+        inverse[_permutation[i]] = i;
+    }
+
+    // The upper triangle of P * A * Pᵀ, remembering where each input entry lands.
+    std::vector<std::size_t> counts(n + 1, 0);
+
+    for (std::size_t j = 0; j < n; j++) {
+        for (std::size_t p = pattern.ColumnStarts[j]; p < pattern.ColumnStarts[j + 1]; p++) {
+            counts[std::max(inverse[pattern.RowIndices[p]], inverse[j]) + 1]++;
+        }
+    }
+
+    _starts.assign(n + 1, 0);
+
+    for (std::size_t j = 0; j < n; j++) {
+        _starts[j + 1] = _starts[j] + counts[j + 1];
+    }
+
+    std::vector<std::size_t> next(_starts.begin(), _starts.end() - 1);
+
+    _rows.resize(_starts[n]);
+    _destinations.resize(_starts[n]);
+    _values.resize(_starts[n]);
+
+    for (std::size_t j = 0; j < n; j++) {
+        for (std::size_t p = pattern.ColumnStarts[j]; p < pattern.ColumnStarts[j + 1]; p++) {
+            const std::size_t a = inverse[pattern.RowIndices[p]];
+            const std::size_t b = inverse[j];
+            const std::size_t q = next[std::max(a, b)]++;
+
+            _rows[q] = std::min(a, b);
+            _destinations[p] = q;
+        }
+    }
+
+    // The elimination tree, with path compression through the ancestors.
+    _parent.assign(n, None);
+
+    std::vector<std::size_t> ancestor(n, None);
+
+    for (std::size_t k = 0; k < n; k++) {
+        for (std::size_t p = _starts[k]; p < _starts[k + 1]; p++) {
+            std::size_t i = _rows[p];
+
+            while (i != None && i < k) {
+                const std::size_t following = ancestor[i];
+
+                ancestor[i] = k;
+
+                if (following == None) {
+                    _parent[i] = k;
+                }
+
+                i = following;
+            }
+        }
+    }
+
+    // The column counts of L: row k of L holds the nodes reached from the entries of column k.
+    std::vector<std::size_t> stack(n);
+    std::vector<std::size_t> marks(n, None);
+    std::vector<std::size_t> columnCounts(n, 1);
+
+    for (std::size_t k = 0; k < n; k++) {
+        for (std::size_t top = Reach(k, stack, marks); top < n; top++) {
+            columnCounts[stack[top]]++;
+        }
+    }
+
+    _lowerStarts.assign(n + 1, 0);
+
+    for (std::size_t j = 0; j < n; j++) {
+        _lowerStarts[j + 1] = _lowerStarts[j] + columnCounts[j];
+    }
+
+    _lowerRows.resize(_lowerStarts[n]);
+    _lowerValues.resize(_lowerStarts[n]);
+}
+
+std::size_t SparseCholesky::Reach(const std::size_t k, std::vector<std::size_t> &stack, std::vector<std::size_t> &marks) const
+{
+    const std::size_t n = _dimension;
+
+    std::size_t top = n;
+
+    marks[k] = k;
+
+    for (std::size_t p = _starts[k]; p < _starts[k + 1]; p++) {
+        std::size_t i = _rows[p];
+        std::size_t length = 0;
+
+        // Walk up the tree to a node already on the pattern, then move the path onto the output.
+        for (; marks[i] != k; i = _parent[i]) {
+            stack[length++] = i;
+            marks[i] = k;
+        }
+
+        while (length > 0) {
+            stack[--top] = stack[--length];
+        }
+    }
+
+    return top;
+}
+
+void SparseCholesky::Factorize(const std::vector<double> &values)
+{
+    const std::size_t n = _dimension;
+
+    if (values.size() != _destinations.size()) {
+        throw std::out_of_range("Argument vectors differ in length.");
+    }
+
+    std::fill(_values.begin(), _values.end(), 0.0);
+
+    for (std::size_t p = 0; p < values.size(); p++) {
+        _values[_destinations[p]] += values[p];
+    }
+
+    std::vector<double> x(n, 0.0);
+    std::vector<std::size_t> stack(n);
+    std::vector<std::size_t> marks(n, None);
+    std::vector<std::size_t> next(_lowerStarts.begin(), _lowerStarts.end() - 1);
+
+    for (std::size_t k = 0; k < n; k++) {
+        std::size_t top = Reach(k, stack, marks);
+
+        for (std::size_t p = _starts[k]; p < _starts[k + 1]; p++) {
+            x[_rows[p]] += _values[p];
+        }
+
+        double diagonal = x[k];
+        x[k] = 0.0;
+
+        // Row k of L by a sparse triangular solve over the columns on its pattern.
+        for (; top < n; top++) {
+            const std::size_t i = stack[top];
+            const double value = x[i] / _lowerValues[_lowerStarts[i]];
+
+            x[i] = 0.0;
+
+            for (std::size_t p = _lowerStarts[i] + 1; p < next[i]; p++) {
+                x[_lowerRows[p]] -= _lowerValues[p] * value;
+            }
+
+            diagonal -= value * value;
+
+            const std::size_t p = next[i]++;
+            _lowerRows[p] = k;
+            _lowerValues[p] = value;
+        }
+
+        if (!(diagonal > 0.0)) {
+            throw std::domain_error("Input array is not positive definite.");
+        }
+
+        const std::size_t p = next[k]++;
+        _lowerRows[p] = k;
+        _lowerValues[p] = std::sqrt(diagonal);
+    }
+}
+
+std::vector<double> SparseCholesky::ForwardSolve(const std::vector<double> &b) const
+{
+    const std::size_t n = _dimension;
+
+    if (b.size() != n) {
+        throw std::out_of_range("Argument vectors differ in length.");
+    }
+
+    std::vector<double> x(n);
+
+    for (std::size_t i = 0; i < n; i++) {
+        x[i] = b[_permutation[i]];
+    }
+
+    for (std::size_t j = 0; j < n; j++) {
+        x[j] /= _lowerValues[_lowerStarts[j]];
+
+        for (std::size_t p = _lowerStarts[j] + 1; p < _lowerStarts[j + 1]; p++) {
+            x[_lowerRows[p]] -= _lowerValues[p] * x[j];
+        }
+    }
+
+    return x;
+}
+
+std::vector<double> SparseCholesky::BackwardSolve(const std::vector<double> &c) const
+{
+    const std::size_t n = _dimension;
+
+    if (c.size() != n) {
+        throw std::out_of_range("Argument vectors differ in length.");
+    }
+
+    std::vector<double> x(c);
+
+    for (std::size_t j = n; j-- > 0;) {
+        for (std::size_t p = _lowerStarts[j] + 1; p < _lowerStarts[j + 1]; p++) {
+            x[j] -= _lowerValues[p] * x[_lowerRows[p]];
+        }
+
+        x[j] /= _lowerValues[_lowerStarts[j]];
+    }
+
+    std::vector<double> result(n);
+
+    for (std::size_t i = 0; i < n; i++) {
+        result[_permutation[i]] = x[i];
+    }
+
+    return result;
+}
+
+double SparseCholesky::LogDeterminant() const
+{
+    double result = 0.0;
+
+    for (std::size_t j = 0; j < _dimension; j++) {
+        result += 2.0 * std::log(_lowerValues[_lowerStarts[j]]);
+    }
+
+    return result;
+}
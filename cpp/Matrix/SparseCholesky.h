@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/// <summary>
+/// The upper triangle of a sparse symmetric matrix in compressed sparse column form.
+/// </summary>
+struct SparseMatrix {
+    std::size_t Dimension = 0;
+
+    /// <summary>
+    /// The first entry of each column, followed by the number of entries.
+    /// </summary>
+    std::vector<std::size_t> ColumnStarts;
+
+    /// <summary>
+    /// The row of each entry. Every row is at most its column.
+    /// </summary>
+    std::vector<std::size_t> RowIndices;
+
+    std::vector<double> Values;
+};
+
+/// <summary>
+/// Decomposes a sparse symmetric positive definite matrix A into P * A * Pᵀ = L * Lᵀ.
+/// </summary>
+/// <remarks>
+/// Construction analyses the pattern once: it chooses the permutation P by minimum degree, to limit fill-in, and
+/// computes the elimination tree and the column counts of L. <see cref="Factorize"/> then computes L for any values on
+/// that pattern without repeating the analysis, so that a sequence of matrices with one pattern, such as the
+/// mixed-model equations at each step of an optimizer, pays for the analysis only once. L is computed row by row
+/// (the up-looking algorithm of Davis, 2006).
+/// </remarks>
+class SparseCholesky {
+public:
+
+    /// <summary>
+    /// Analyses the pattern of a matrix. Its values are not read.
+    /// </summary>
+    explicit SparseCholesky(const SparseMatrix &pattern);
+
+    /// <summary>
+    /// Computes L for new values on the analysed pattern.
+    /// </summary>
+    /// <param name="values">
+    /// The values, in the order of <see cref="SparseMatrix::Values"/> of the analysed pattern.
+    /// </param>
+    /// <exception cref="std::domain_error">
+    /// The matrix is not positive definite.
+    /// </exception>
+    void Factorize(const std::vector<double> &values);
+
+    const std::size_t Dimension() const
+    { return _dimension; }
+
+    /// <summary>
+    /// The number of stored entries of L.
+    /// </summary>
+    const std::size_t NonZeroCount() const
+    { return _lowerStarts[_dimension]; }
+
+    /// <summary>
+    /// The permutation: row i of P * A * Pᵀ is row Permutation()[i] of A.
+    /// </summary>
+    const std::vector<std::size_t> &Permutation() const
+    { return _permutation; }
+
+    /// <summary>
+    /// Returns L⁻¹ * P * b.
+    /// </summary>
+    std::vector<double> ForwardSolve(const std::vector<double> &b) const;
+
+    /// <summary>
+    /// Returns Pᵀ * L⁻ᵀ * c, so that BackwardSolve(ForwardSolve(b)) = A⁻¹ * b.
+    /// </summary>
+    std::vector<double> BackwardSolve(const std::vector<double> &c) const;
+
+    /// <summary>
+    /// Returns log det(A) = 2 * Σ log Lᵢᵢ.
+    /// </summary>
+    double LogDeterminant() const;
+
+private:
+
+    std::size_t Reach(std::size_t k, std::vector<std::size_t> &stack, std::vector<std::size_t> &marks) const;
+
+    std::size_t _dimension;
+
+    std::vector<std::size_t> _permutation;
+
+    /// <summary>
+    /// The pattern of the upper triangle of P * A * Pᵀ, and the entry of it that receives each input value.
+    /// </summary>
+    std::vector<std::size_t> _starts;
+
+    std::vector<std::size_t> _rows;
+
+    std::vector<std::size_t> _destinations;
+
+    std::vector<double> _values;
+
+    /// <summary>
+    /// The elimination tree, with _dimension marking a root.
+    /// </summary>
+    std::vector<std::size_t> _parent;
+
+    /// <summary>
+    /// L in compressed sparse column form, the diagonal first in each column.
+    /// </summary>
+    std::vector<std::size_t> _lowerStarts;
+
+    std::vector<std::size_t> _lowerRows;
+
+    std::vector<double> _lowerValues;
+};
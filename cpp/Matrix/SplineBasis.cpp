@@ -0,0 +1,354 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "SplineBasis.h"
+
+BSplineBasis::BSplineBasis(
+        const double *values,
+        const std::ptrdiff_t stride,
+        const std::vector<double> &knots,
+        const double lower,
+        const double upper,
+        const std::size_t degree,
+        const bool intercept)
+        : _values(values),
+          _stride(stride),
+          _degree(degree),
+          _basisCount(knots.size() + degree + 1),
+          _intercept(intercept)
+{
+    if (!(lower < upper) || !std::is_sorted(knots.begin(), knots.end()) ||
+        (!knots.empty() && !(knots.front() > lower && knots.back() < upper))) {
+        throw std::invalid_argument("Knots must be ascending and lie strictly between the boundary knots.");
+    }
+
+    _knots.reserve(knots.size() + 2 * (degree + 1));
+    _knots.insert(_knots.end(), degree + 1, lower);
+    _knots.insert(_knots.end(), knots.begin(), knots.end());
+    _knots.insert(_knots.end(), degree + 1, upper);
+}
+
+std::size_t BSplineBasis::Span(const double x) const
+{
+    // The span i with knots[i] <= x < knots[i + 1], clamped to the first and last nonempty spans.
+    return std::upper_bound(_knots.begin() + _degree + 1, _knots.begin() + _basisCount, x) - _knots.begin() - 1;
+}
+
+void BSplineBasis::Evaluate(const std::size_t first, const std::size_t count, std::size_t *offsets, double *values) const
+{
+    const std::size_t p = _degree;
+
+    std::vector<double> left(p + 1);
+    std::vector<double> right(p + 1);
+
+    for (std::size_t i = 0; i < count; i++) {
+        const double x = _values[static_cast<std::ptrdiff_t>(first + i) * _stride];
+        const std::size_t span = Span(x);
+
+        double *n = values + i * (p + 1);
+
+        n[0] = 1.0;
+
+        for (std::size_t j = 1; j <= p; j++) {
+            left[j] = x - _knots[span + 1 - j];
+            right[j] = _knots[span + j] - x;
+
+            double saved = 0.0;
+
+            for (std::size_t r = 0; r < j; r++) {
+                const double temp = n[r] / (right[r + 1] + left[j - r]);
+
+                n[r] = saved + right[r + 1] * temp;
+                saved = left[j - r] * temp;
+            }
+
+            n[j] = saved;
+        }
+
+        offsets[i] = span - p;
+    }
+}
+
+std::pair<std::size_t, std::vector<double>> BSplineBasis::Derivatives(const double x, const std::size_t order) const
+{
+    // The NURBS Book, A2.3.
+    const std::size_t p = _degree;
+    const std::size_t span = Span(x);
+
+    std::vector<std::vector<double>> ndu(p + 1, std::vector<double>(p + 1));
+    std::vector<std::vector<double>> a(2, std::vector<double>(p + 1));
+    std::vector<double> left(p + 1);
+    std::vector<double> right(p + 1);
+
+    ndu[0][0] = 1.0;
+
+    for (std::size_t j = 1; j <= p; j++) {
+        left[j] = x - _knots[span + 1 - j];
+        right[j] = _knots[span + j] - x;
+
+        double saved = 0.0;
+
+        for (std::size_t r = 0; r < j; r++) {
+            ndu[j][r] = right[r + 1] + left[j - r];
+
+            const double temp = ndu[r][j - 1] / ndu[j][r];
+
+            ndu[r][j] = saved + right[r + 1] * temp;
+            saved = left[j - r] * temp;
+        }
+
+        ndu[j][j] = saved;
+    }
+
+    std::vector<double> result((order + 1) * (p + 1), 0.0);
+
+    for (std::size_t j = 0; j <= p; j++) {
+        result[j] = ndu[j][p];
+    }
+
+    const long degree = static_cast<long>(p);
+
+    for (long r = 0; r <= degree; r++) {
+        std::size_t s1 = 0;
+        std::size_t s2 = 1;
+
+        a[0][0] = 1.0;
+
+        for (long k = 1; k <= static_cast<long>(std::min(order, p)); k++) {
+            const long rk = r - k;
+            const long pk = degree - k;
+
+            double d = 0.0;
+
+            if (r >= k) {
+                a[s2][0] = a[s1][0] / ndu[pk + 1][rk];
+                d = a[s2][0] * ndu[rk][pk];
+            }
+
+            const long j1 = rk >= -1 ? 1 : -rk;
+            const long j2 = r - 1 <= pk ? k - 1 : degree - r;
+
+            for (long j = j1; j <= j2; j++) {
+                a[s2][j] = (a[s1][j] - a[s1][j - 1]) / ndu[pk + 1][rk + j];
+                d += a[s2][j] * ndu[rk + j][pk];
+            }
+
+            if (r <= pk) {
+                a[s2][k] = -a[s1][k - 1] / ndu[pk + 1][r];
+                d += a[s2][k] * ndu[r][pk];
+            }
+
+            result[k * (p + 1) + r] = d;
+
+            std::swap(s1, s2);
+        }
+    }
+
+    double factor = static_cast<double>(p);
+
+    for (std::size_t k = 1; k <= std::min(order, p); k++) {
+        for (std::size_t j = 0; j <= p; j++) {
+            result[k * (p + 1) + j] *= factor;
+        }
+
+        factor *= static_cast<double>(p - k);
+    }
+
+    return {span - p, std::move(result)};
+}
+
+void BSplineBasis::Generate(const std::size_t first, const std::size_t count, double *block, const std::size_t stride) const
+{
+    const std::size_t p = _degree;
+    const std::size_t width = Width();
+    const std::size_t shift = _intercept ? 0 : 1;
+
+    std::vector<std::size_t> offsets(count);
+    std::vector<double> values(count * (p + 1));
+
+    Evaluate(first, count, offsets.data(), values.data());
+
+    for (std::size_t i = 0; i < count; i++) {
+        double *row = block + i * stride;
+
+        std::fill(row, row + width, 0.0);
+
+        for (std::size_t j = 0; j <= p; j++) {
+            const std::size_t index = offsets[i] + j;
+
+            if (index >= shift) {
+                row[index - shift] = values[i * (p + 1) + j];
+            }
+        }
+    }
+}
+
+NaturalSplineBasis::NaturalSplineBasis(
+        const double *values,
+        const std::ptrdiff_t stride,
+        const std::vector<double> &knots,
+        const double lower,
+        const double upper,
+        const bool intercept)
+        : _basis(values, stride, knots, lower, upper, 3, true),
+          _shift(intercept ? 0 : 1),
+          _width(knots.size() + (intercept ? 2 : 1))
+{
+    const std::size_t p = _basis.Degree();
+    const std::size_t kept = _basis.BasisCount() - _shift;
+
+    const std::pair<std::size_t, std::vector<double>> atLower = _basis.Derivatives(lower, 2);
+    const std::pair<std::size_t, std::vector<double>> atUpper = _basis.Derivatives(upper, 2);
+
+    // The transposed constraints, kept x 2: the second derivatives of the kept B-splines at the boundary knots.
+    std::vector<double> constraints(kept * 2, 0.0);
+
+    for (std::size_t j = 0; j <= p; j++) {
+        if (atLower.first + j >= _shift) {
+            constraints[(atLower.first + j - _shift) * 2] = atLower.second[2 * (p + 1) + j];
+        }
+        if (atUpper.first + j >= _shift) {
+            constraints[(atUpper.first + j - _shift) * 2 + 1] = atUpper.second[2 * (p + 1) + j];
+        }
+    }
+
+    // Householder reflections Q = H₀ * H₁ of the constraints; the trailing columns of Q span their null space.
+    std::vector<std::vector<double>> reflections(2, std::vector<double>(kept, 0.0));
+
+    for (std::size_t c = 0; c < 2; c++) {
+        double norm = 0.0;
+
+        for (std::size_t r = c; r < kept; r++) {
+            norm += constraints[r * 2 + c] * constraints[r * 2 + c];
+        }
+
+        norm = sqrt(norm);
+
+        if (norm == 0.0) {
+            continue;
+        }
+
+        std::vector<double> &v = reflections[c];
+
+        for (std::size_t r = c; r < kept; r++) {
+            v[r] = constraints[r * 2 + c];
+        }
+
+        v[c] += v[c] < 0.0 ? -norm : norm;
+
+        double length = 0.0;
+
+        for (std::size_t r = c; r < kept; r++) {
+            length += v[r] * v[r];
+        }
+
+        length = sqrt(length);
+
+        for (std::size_t r = c; r < kept; r++) {
+            v[r] /= length;
+        }
+
+        for (std::size_t k = c; k < 2; k++) {
+            double dot = 0.0;
+
+            for (std::size_t r = c; r < kept; r++) {
+                dot += v[r] * constraints[r * 2 + k];
+            }
+            for (std::size_t r = c; r < kept; r++) {
+                constraints[r * 2 + k] -= 2.0 * dot * v[r];
+            }
+        }
+    }
+
+    _projection.assign(kept * _width, 0.0);
+
+    for (std::size_t k = 0; k < _width; k++) {
+        std::vector<double> column(kept, 0.0);
+
+        column[k + 2] = 1.0;
+
+        for (std::size_t c = 2; c-- > 0;) {
+            double dot = 0.0;
+
+            for (std::size_t r = 0; r < kept; r++) {
+                dot += reflections[c][r] * column[r];
+            }
+            for (std::size_t r = 0; r < kept; r++) {
+                column[r] -= 2.0 * dot * reflections[c][r];
+            }
+        }
+
+        for (std::size_t r = 0; r < kept; r++) {
+            _projection[r * _width + k] = column[r];
+        }
+    }
+
+    const auto boundary = [&](const std::pair<std::size_t, std::vector<double>> &derivatives, std::vector<double> &values, std::vector<double> &slopes) {
+        values.assign(_width, 0.0);
+        slopes.assign(_width, 0.0);
+
+        for (std::size_t j = 0; j <= p; j++) {
+            if (derivatives.first + j < _shift) {
+                continue;
+            }
+
+            const double *projection = _projection.data() + (derivatives.first + j - _shift) * _width;
+
+            for (std::size_t k = 0; k < _width; k++) {
+                values[k] += derivatives.second[j] * projection[k];
+                slopes[k] += derivatives.second[(p + 1) + j] * projection[k];
+            }
+        }
+    };
+
+    boundary(atLower, _lowerValues, _lowerSlopes);
+    boundary(atUpper, _upperValues, _upperSlopes);
+}
+
+void NaturalSplineBasis::Generate(const std::size_t first, const std::size_t count, double *block, const std::size_t stride) const
+{
+    const std::size_t p = _basis.Degree();
+    const double lower = _basis.Knots().front();
+    const double upper = _basis.Knots().back();
+
+    std::vector<std::size_t> offsets(count);
+    std::vector<double> values(count * (p + 1));
+
+    _basis.Evaluate(first, count, offsets.data(), values.data());
+
+    for (std::size_t i = 0; i < count; i++) {
+        const double x = _basis.Value(first + i);
+
+        double *row = block + i * stride;
+
+        if (x < lower || x > upper) {
+            const bool below = x < lower;
+            const std::vector<double> &boundary = below ? _lowerValues : _upperValues;
+            const std::vector<double> &slopes = below ? _lowerSlopes : _upperSlopes;
+            const double distance = x - (below ? lower : upper);
+
+            for (std::size_t k = 0; k < _width; k++) {
+                row[k] = boundary[k] + distance * slopes[k];
+            }
+
+            continue;
+        }
+
+        std::fill(row, row + _width, 0.0);
+
+        for (std::size_t j = 0; j <= p; j++) {
+            const std::size_t index = offsets[i] + j;
+
+            if (index < _shift) {
+                continue;
+            }
+
+            const double value = values[i * (p + 1) + j];
+            const double *projection = _projection.data() + (index - _shift) * _width;
+
+            for (std::size_t k = 0; k < _width; k++) {
+                row[k] += value * projection[k];
+            }
+        }
+    }
+}
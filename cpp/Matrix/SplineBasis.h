@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "IColumnGenerator.h"
+
+/// <summary>
+/// The B-spline basis of a variable, generated on the fly (see <see cref="DesignMatrix::Wrap"/>).
+/// </summary>
+/// <remarks>
+/// The knot vector repeats each boundary knot degree + 1 times around the interior knots, as R's splines::bs does. A
+/// B-spline of degree p is nonzero on at most p + 1 knot spans, so each row evaluates only the p + 1 functions that
+/// are nonzero on its span (Piegl and Tiller, The NURBS Book, A2.2) and leaves the other columns zero. Values beyond
+/// the boundary knots continue the polynomial pieces of the end spans.
+/// </remarks>
+class BSplineBasis : public IColumnGenerator {
+public:
+
+    /// <param name="values">
+    /// The first value of the variable, which must outlive the basis.
+    /// </param>
+    /// <param name="stride">
+    /// The distance, in elements, between consecutive values.
+    /// </param>
+    /// <param name="knots">
+    /// The interior knots, in ascending order.
+    /// </param>
+    /// <param name="lower">
+    /// The lower boundary knot.
+    /// </param>
+    /// <param name="upper">
+    /// The upper boundary knot.
+    /// </param>
+    /// <param name="degree">
+    /// The degree of the pieces.
+    /// </param>
+    /// <param name="intercept">
+    /// True to keep the first basis function, whose columns otherwise sum with the others to one.
+    /// </param>
+    /// <exception cref="std::invalid_argument">
+    /// The knots are not ascending or do not lie strictly between the boundary knots.
+    /// </exception>
+    BSplineBasis(
+            const double *values,
+            std::ptrdiff_t stride,
+            const std::vector<double> &knots,
+            double lower,
+            double upper,
+            std::size_t degree = 3,
+            bool intercept = false);
+
+    const std::size_t Width() const override
+    { return _basisCount - (_intercept ? 0 : 1); }
+
+    const std::size_t Degree() const
+    { return _degree; }
+
+    /// <summary>
+    /// The number of basis functions, including the first whether or not it is a column.
+    /// </summary>
+    const std::size_t BasisCount() const
+    { return _basisCount; }
+
+    /// <summary>
+    /// The value of the variable at a row.
+    /// </summary>
+    const double Value(std::size_t row) const
+    { return _values[static_cast<std::ptrdiff_t>(row) * _stride]; }
+
+    /// <summary>
+    /// The knot vector, including the repeated boundary knots.
+    /// </summary>
+    const std::vector<double> &Knots() const
+    { return _knots; }
+
+    void Generate(std::size_t first, std::size_t count, double *block, std::size_t stride) const override;
+
+    /// <summary>
+    /// Evaluates the basis functions that are nonzero at the rows [first, first + count).
+    /// </summary>
+    /// <param name="first">
+    /// The first row.
+    /// </param>
+    /// <param name="count">
+    /// The number of rows.
+    /// </param>
+    /// <param name="offsets">
+    /// Receives, for each row, the index in the full basis of the first of its degree + 1 functions.
+    /// </param>
+    /// <param name="values">
+    /// Receives, for each row, the degree + 1 function values.
+    /// </param>
+    void Evaluate(std::size_t first, std::size_t count, std::size_t *offsets, double *values) const;
+
+    /// <summary>
+    /// Evaluates the derivatives, up to the given order, of the degree + 1 basis functions that are nonzero at x.
+    /// </summary>
+    /// <returns>
+    /// The index in the full basis of the first function, and the derivatives of order k at [k * (degree + 1), (k + 1) * (degree + 1)).
+    /// </returns>
+    std::pair<std::size_t, std::vector<double>> Derivatives(double x, std::size_t order) const;
+
+private:
+
+    std::size_t Span(double x) const;
+
+    const double *_values;
+
+    std::ptrdiff_t _stride;
+
+    std::vector<double> _knots;
+
+    std::size_t _degree;
+
+    std::size_t _basisCount;
+
+    bool _intercept;
+};
+
+/// <summary>
+/// The natural cubic spline basis of a variable, generated on the fly (see <see cref="DesignMatrix::Wrap"/>).
+/// </summary>
+/// <remarks>
+/// The basis spans the cubic splines whose second derivatives vanish at the boundary knots, as R's splines::ns does:
+/// the cubic B-spline basis is projected onto the null space of those two constraints, which is found once by a
+/// Householder factorization. Each row combines only its four nonzero B-splines. Beyond the boundary knots the basis
+/// continues linearly.
+/// </remarks>
+class NaturalSplineBasis : public IColumnGenerator {
+public:
+
+    /// <param name="values">
+    /// The first value of the variable, which must outlive the basis.
+    /// </param>
+    /// <param name="stride">
+    /// The distance, in elements, between consecutive values.
+    /// </param>
+    /// <param name="knots">
+    /// The interior knots, in ascending order.
+    /// </param>
+    /// <param name="lower">
+    /// The lower boundary knot.
+    /// </param>
+    /// <param name="upper">
+    /// The upper boundary knot.
+    /// </param>
+    /// <param name="intercept">
+    /// True to include the constant in the span of the basis.
+    /// </param>
+    /// <exception cref="std::invalid_argument">
+    /// The knots are not ascending or do not lie strictly between the boundary knots.
+    /// </exception>
+    NaturalSplineBasis(
+            const double *values,
+            std::ptrdiff_t stride,
+            const std::vector<double> &knots,
+            double lower,
+            double upper,
+            bool intercept = false);
+
+    const std::size_t Width() const override
+    { return _width; }
+
+    void Generate(std::size_t first, std::size_t count, double *block, std::size_t stride) const override;
+
+private:
+
+    BSplineBasis _basis;
+
+    std::size_t _shift;
+
+    std::size_t _width;
+
+    /// <summary>
+    /// The projection from the kept B-splines onto the basis, row-major.
+    /// </summary>
+    std::vector<double> _projection;
+
+    std::vector<double> _lowerValues;
+
+    std::vector<double> _lowerSlopes;
+
+    std::vector<double> _upperValues;
+
+    std::vector<double> _upperSlopes;
+};
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <bitset>
+#include <stdexcept>
+#include "ValidityMask.h"
+#include "Kernels.h"
+
+ValidityMask::ValidityMask(const std::size_t rowCount)
+        : _words((rowCount + 63) / 64, ~std::uint64_t{0}),
+          _rowCount(rowCount),
+          _validCount(rowCount)
+{
+    if (rowCount % 64 != 0) {
+        _words.back() = (std::uint64_t{1} << (rowCount % 64)) - 1;
+    }
+}
+
+ValidityMask ValidityMask::Of(const std::vector<double> &values)
+{
+    ValidityMask result(values.size());
+
+    Kernels::Active().MarkValid(values.data(), values.size(), result._words.data());
+
+    // Combining with itself counts the bits.
+    result._validCount = Kernels::Active().CombineMasks(result._words.data(), result._words.data(), result._words.size());
+
+    return result;
+}
+
+std::size_t ValidityMask::CountValid(const std::size_t first, const std::size_t count) const
+{
+    std::size_t result = 0;
+
+    for (std::size_t row = first, last = first + count; row < last;) {
+        const std::size_t offset = row % 64;
+        const std::size_t bits = std::min<std::size_t>(64 - offset, last - row);
+        const std::uint64_t span = bits == 64 ? ~std::uint64_t{0} : ((std::uint64_t{1} << bits) - 1) << offset;
+
+        result += std::bitset<64>(_words[row / 64] & span).count();
+        row += bits;
+    }
+
+    return result;
+}
+
+void ValidityMask::Clear(const std::size_t row)
+{
+    if ((*this)[row]) {
+        _words[row / 64] &= ~(std::uint64_t{1} << (row % 64));
+        _validCount--;
+    }
+}
+
+ValidityMask &ValidityMask::operator&=(const ValidityMask &other)
+{
+    if (other._rowCount != _rowCount) {
+        throw std::out_of_range("Argument vectors differ in length.");
+    }
+
+    _validCount = Kernels::Active().CombineMasks(_words.data(), other._words.data(), _words.size());
+
+    return *this;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// One bit per observation, set if the observation is valid, packed 64 to a word.
+/// </summary>
+/// <remarks>
+/// Masks are built and combined by the SIMD kernels (see <see cref="Kernels::KernelTable::MarkValid"/> and
+/// <see cref="Kernels::KernelTable::CombineMasks"/>), so listwise deletion over many columns costs one pass over n / 64
+/// words per column. Bits past the last observation are always clear.
+/// </remarks>
+class ValidityMask {
+public:
+
+    ValidityMask() = default;
+
+    /// <summary>
+    /// A mask of the given number of observations, all valid.
+    /// </summary>
+    explicit ValidityMask(std::size_t rowCount);
+
+    /// <summary>
+    /// Marks the values that are not NaN as valid.
+    /// </summary>
+    static ValidityMask Of(const std::vector<double> &values);
+
+    const std::size_t RowCount() const
+    { return _rowCount; }
+
+    /// <summary>
+    /// The number of valid observations.
+    /// </summary>
+    const std::size_t ValidCount() const
+    { return _validCount; }
+
+    const bool AllValid() const
+    { return _validCount == _rowCount; }
+
+    const std::vector<std::uint64_t> &Words() const
+    { return _words; }
+
+    const bool operator[](std::size_t row) const
+    { return (_words[row / 64] >> (row % 64) & 1) != 0; }
+
+    /// <summary>
+    /// The number of valid observations among the rows [first, first + count), counted a word at a time, so kernels
+    /// can skip a block whose rows are all masked out.
+    /// </summary>
+    std::size_t CountValid(std::size_t first, std::size_t count) const;
+
+    /// <summary>
+    /// Marks an observation as invalid.
+    /// </summary>
+    void Clear(std::size_t row);
+
+    /// <summary>
+    /// Keeps only the observations that are valid in both masks.
+    /// </summary>
+    /// <exception cref="std::out_of_range">
+    /// The masks differ in length.
+    /// </exception>
+    ValidityMask &operator&=(const ValidityMask &other);
+
+private:
+
+    std::vector<std::uint64_t> _words;
+
+    std::size_t _rowCount = 0;
+
+    std::size_t _validCount = 0;
+};
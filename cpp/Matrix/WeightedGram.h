@@ -0,0 +1,256 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "DesignMatrix.h"
+#include "Kernels.h"
+#include "ValidityMask.h"
+
+/// <summary>
+/// The weighted normal equations X'WX b = X'Wz of a least squares step.
+/// </summary>
+struct NormalEquations {
+    /// <summary>
+    /// The symmetric matrix X'WX, stored row-major.
+    /// </summary>
+    std::vector<double> Gram;
+
+    /// <summary>
+    /// The vector X'Wz.
+    /// </summary>
+    std::vector<double> Moment;
+};
+
+/// <summary>
+/// Selects how parallel kernels divide and recombine their work.
+/// </summary>
+enum class ReductionMode {
+    /// <summary>
+    /// Each worker reduces its own row partition. Fastest and NUMA-local, but the rounding of the result depends on the
+    /// number of workers.
+    /// </summary>
+    Partitioned,
+
+    /// <summary>
+    /// Rows are reduced in chunks whose boundaries depend only on the row count, and the chunk results are combined in
+    /// order, so the result is bitwise identical for any number of workers.
+    /// </summary>
+    Reproducible
+};
+
+/// <summary>
+/// Forms the weighted Gram matrix and moment vector of a design in a single pass over its rows.
+/// </summary>
+/// <remarks>
+/// Each worker accumulates the rows of its own partition (see <see cref="DesignMatrix::RowPartition"/>), so a
+/// <see cref="MemoryPlacement::Partitioned"/> design is read entirely from node-local memory.
+/// </remarks>
+struct WeightedGram {
+    /// <summary>
+    /// Adds w * x * xᵀ to the upper triangle of a k x k Gram matrix and w * z * x to a moment vector.
+    /// </summary>
+    static void AccumulateRow(const double *x, const std::size_t k, const double w, const double z, double *gram, double *moment)
+    {
+        for (std::size_t a = 0; a < k; a++) {
+            const double wx = w * x[a];
+
+            moment[a] += wx * z;
+
+            for (std::size_t b = a; b < k; b++) {
+                gram[a * k + b] += wx * x[b];
+            }
+        }
+    }
+
+    /// <summary>
+    /// Sums partial normal equations in order and mirrors the upper triangle of the Gram matrix into the lower.
+    /// </summary>
+    static NormalEquations Reduce(const std::vector<NormalEquations> &partials, const std::size_t k)
+    {
+        NormalEquations result{std::vector<double>(k * k, 0.0), std::vector<double>(k, 0.0)};
+
+        for (const NormalEquations &partial : partials) {
+            for (std::size_t i = 0; i < k * k; i++) {
+                result.Gram[i] += partial.Gram[i];
+            }
+            for (std::size_t i = 0; i < k; i++) {
+                result.Moment[i] += partial.Moment[i];
+            }
+        }
+
+        for (std::size_t a = 0; a < k; a++) {
+            for (std::size_t b = 0; b < a; b++) {
+                result.Gram[a * k + b] = result.Gram[b * k + a];
+            }
+        }
+
+        return result;
+    }
+
+    /// <summary>
+    /// The largest number of chunks, and so of partial results held at once, in <see cref="ReductionMode::Reproducible"/>.
+    /// </summary>
+    static constexpr std::size_t MaxChunks = 512;
+
+    /// <param name="valid">
+    /// The observations to include, or an empty mask to include those of the design (see
+    /// <see cref="DesignMatrix::Mask"/>). The weights and response of excluded rows are never read, so they may be NaN.
+    /// </param>
+    NormalEquations operator()(const DesignMatrix &design, const std::vector<double> &weights, const std::vector<double> &response, const ReductionMode mode = ReductionMode::Partitioned, const ValidityMask &valid = ValidityMask()) const
+    {
+        if (design.RowCount() != weights.size() || design.RowCount() != response.size() || (valid.RowCount() != 0 && valid.RowCount() != design.RowCount())) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        const std::size_t k = design.ColumnCount();
+        const ValidityMask &mask = valid.RowCount() != 0 ? valid : design.Mask();
+
+        if (mode == ReductionMode::Reproducible) {
+            return Chunked(design, weights, response, mask);
+        }
+
+        const Kernels::KernelTable &kernels = Kernels::Active();
+
+        std::vector<NormalEquations> partials(design.Pool().WorkerCount());
+
+        design.ForEachPartition(
+                [&](unsigned worker, std::size_t first, std::size_t last) {
+                    std::vector<double> gram(k * k, 0.0);
+                    std::vector<double> moment(k, 0.0);
+                    Scratch scratch;
+
+                    for (std::size_t block = first; block < last; block += DesignMatrix::BlockRows) {
+                        const std::size_t count = std::min(DesignMatrix::BlockRows, last - block);
+                        AccumulateBlock(kernels, design, mask, block, count, weights, response, gram, moment, scratch);
+                    }
+
+                    partials[worker] = NormalEquations{std::move(gram), std::move(moment)};
+                });
+
+        return Reduce(partials, k);
+    }
+
+private:
+
+    /// <summary>
+    /// The buffers a worker reuses from block to block.
+    /// </summary>
+    struct Scratch {
+        std::vector<double> Rows;
+
+        std::vector<std::size_t> Columns;
+
+        std::vector<double> Packed;
+
+        std::vector<std::size_t> PackedColumns;
+    };
+
+    /// <summary>
+    /// Accumulates the valid rows of one block. A block with no valid row is not read at all; a partly valid one has
+    /// its valid rows, weights and responses packed into a buffer first. A sparse design (see
+    /// <see cref="DesignMatrix::IsSparse"/>) is read through its spans, so each row updates only the entries of the
+    /// Gram matrix at its possibly nonzero columns.
+    /// </summary>
+    static void AccumulateBlock(
+            const Kernels::KernelTable &kernels,
+            const DesignMatrix &design,
+            const ValidityMask &mask,
+            const std::size_t block,
+            const std::size_t count,
+            const std::vector<double> &weights,
+            const std::vector<double> &response,
+            std::vector<double> &gram,
+            std::vector<double> &moment,
+            Scratch &scratch)
+    {
+        const std::size_t k = design.ColumnCount();
+        const std::size_t validCount = mask.RowCount() == 0 ? count : mask.CountValid(block, count);
+
+        if (validCount == 0) {
+            return;
+        }
+
+        const bool sparse = design.IsSparse();
+        const std::size_t width = sparse ? design.SpanWidth() : k;
+
+        const double *x = sparse ? design.Spans(block, count, scratch.Rows, scratch.Columns) : design.Rows(block, count, scratch.Rows);
+
+        if (validCount == count) {
+            if (sparse) {
+                kernels.AccumulateGramSparse(x, scratch.Columns.data(), count, width, k, weights.data() + block, response.data() + block, gram.data(), moment.data());
+            } else {
+                kernels.AccumulateGram(x, count, k, weights.data() + block, response.data() + block, gram.data(), moment.data());
+            }
+            return;
+        }
+
+        scratch.Packed.resize(validCount * (width + 2));
+        scratch.PackedColumns.resize(sparse ? validCount * width : 0);
+
+        double *packedRows = scratch.Packed.data();
+        double *packedWeights = packedRows + validCount * width;
+        double *packedResponse = packedWeights + validCount;
+
+        for (std::size_t r = 0, j = 0; r < count; r++) {
+            if (mask[block + r]) {
+                std::copy(x + r * width, x + (r + 1) * width, packedRows + j * width);
+                packedWeights[j] = weights[block + r];
+                packedResponse[j] = response[block + r];
+
+                if (sparse) {
+                    std::copy(scratch.Columns.begin() + r * width, scratch.Columns.begin() + (r + 1) * width, scratch.PackedColumns.begin() + j * width);
+                }
+
+                j++;
+            }
+        }
+
+        if (sparse) {
+            kernels.AccumulateGramSparse(packedRows, scratch.PackedColumns.data(), validCount, width, k, packedWeights, packedResponse, gram.data(), moment.data());
+        } else {
+            kernels.AccumulateGram(packedRows, validCount, k, packedWeights, packedResponse, gram.data(), moment.data());
+        }
+    }
+
+    static NormalEquations Chunked(const DesignMatrix &design, const std::vector<double> &weights, const std::vector<double> &response, const ValidityMask &mask)
+    {
+        const std::size_t k = design.ColumnCount();
+        const std::size_t n = design.RowCount();
+
+        // Chunks are whole blocks, and there are at most MaxChunks of them whatever the row count.
+        const std::size_t blocks = (n + DesignMatrix::BlockRows - 1) / DesignMatrix::BlockRows;
+        const std::size_t chunkRows = std::max<std::size_t>((blocks + MaxChunks - 1) / MaxChunks, 1) * DesignMatrix::BlockRows;
+        const std::size_t chunks = (n + chunkRows - 1) / chunkRows;
+
+        const Kernels::KernelTable &kernels = Kernels::Active();
+
+        std::vector<NormalEquations> partials(chunks);
+
+        design.Pool().ParallelFor(
+                0,
+                chunks,
+                1,
+                [&](std::size_t firstChunk, std::size_t lastChunk) {
+                    Scratch scratch;
+
+                    for (std::size_t chunk = firstChunk; chunk < lastChunk; chunk++) {
+                        const std::size_t last = std::min(n, (chunk + 1) * chunkRows);
+
+                        std::vector<double> gram(k * k, 0.0);
+                        std::vector<double> moment(k, 0.0);
+
+                        for (std::size_t block = chunk * chunkRows; block < last; block += DesignMatrix::BlockRows) {
+                            const std::size_t count = std::min(DesignMatrix::BlockRows, last - block);
+                            AccumulateBlock(kernels, design, mask, block, count, weights, response, gram, moment, scratch);
+                        }
+
+                        partials[chunk] = NormalEquations{std::move(gram), std::move(moment)};
+                    }
+                });
+
+        return Reduce(partials, k);
+    }
+};
+
+static const WeightedGram weightedGram = {};
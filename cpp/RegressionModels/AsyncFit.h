@@ -0,0 +1,121 @@
+#pragma once
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "FitOptions.h"
+#include "ThreadPool.h"
+
+namespace RegressionModels {
+
+    /// <summary>
+    /// A handle to a model that is being fitted on the library thread pool.
+    /// </summary>
+    /// <typeparam name="TModel">
+    /// The type of the model under construction.
+    /// </typeparam>
+    template<typename TModel>
+    class AsyncFit {
+    public:
+
+        /// <summary>
+        /// Schedules factory(options) on the library thread pool. The options passed to the factory report progress
+        /// to the returned handle before forwarding it to the caller's callback.
+        /// </summary>
+        template<typename TFactory>
+        static AsyncFit Run(FitOptions options, TFactory factory)
+        {
+            auto promise = std::make_shared<std::promise<std::unique_ptr<TModel>>>();
+            auto monitor = std::make_shared<Monitor>();
+
+            AsyncFit handle(promise->get_future(), monitor, options.Cancellation);
+
+            options.Progress = [monitor, forward = std::move(options.Progress)](const FitProgress &progress) {
+                {
+                    std::lock_guard<std::mutex> lock(monitor->mutex);
+                    monitor->progress = progress;
+                }
+                if (forward) {
+                    forward(progress);
+                }
+            };
+
+            // std::function requires a copyable target, so the move-only state travels behind a shared pointer.
+            auto state = std::make_shared<std::pair<FitOptions, TFactory>>(std::move(options), std::move(factory));
+
+            Threading::ThreadPool::Instance().Submit(
+                    [promise, state]() {
+                        try {
+                            promise->set_value(state->second(state->first));
+                        }
+                        catch (...) {
+                            promise->set_exception(std::current_exception());
+                        }
+                    });
+
+            return handle;
+        }
+
+        /// <summary>
+        /// The progress reported by the most recently completed iteration.
+        /// </summary>
+        const FitProgress Progress() const
+        {
+            std::lock_guard<std::mutex> lock(_monitor->mutex);
+            return _monitor->progress;
+        }
+
+        /// <summary>
+        /// Requests cancellation. The fit stops at its next phase boundary and <see cref="Get"/> throws
+        /// <see cref="Threading::OperationCanceledException"/>.
+        /// </summary>
+        void Cancel() const
+        { _cancellation.Cancel(); }
+
+        const bool IsReady() const
+        { return _result.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+
+        /// <summary>
+        /// Waits for the fit and returns the model, or rethrows the exception that ended it. A caller running on the
+        /// thread pool executes pending tasks while it waits.
+        /// </summary>
+        std::unique_ptr<TModel> Get()
+        {
+            Threading::ThreadPool &pool = Threading::ThreadPool::Instance();
+
+            if (pool.CurrentWorker() >= 0) {
+                while (!IsReady()) {
+                    if (!pool.RunPendingTask()) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            return _result.get();
+        }
+
+    private:
+
+        struct Monitor {
+            std::mutex mutex;
+
+            FitProgress progress;
+        };
+
+        AsyncFit(std::future<std::unique_ptr<TModel>> result, std::shared_ptr<Monitor> monitor, Threading::CancellationToken cancellation)
+                : _result(std::move(result)),
+                  _monitor(std::move(monitor)),
+                  _cancellation(std::move(cancellation))
+        {
+        }
+
+        std::future<std::unique_ptr<TModel>> _result;
+
+        std::shared_ptr<Monitor> _monitor;
+
+        Threading::CancellationToken _cancellation;
+    };
+}
@@ -0,0 +1,170 @@
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <typeinfo>
+#include "FitCache.h"
+#include "Fingerprint.h"
+#include "GaussianDistribution.h"
+#include "GeneralizedLinearModel.h"
+
+namespace RegressionModels {
+    namespace {
+        /// <summary>
+        /// Changes whenever the key derivation or the fitting algorithm changes, so stale snapshots on disk are ignored.
+        /// </summary>
+        const std::uint64_t KeyVersion = 3;
+
+        void UpdateName(Xxh64 &hash, const char *name)
+        {
+            const std::size_t length = std::strlen(name);
+
+            hash.Update(static_cast<std::uint64_t>(length));
+            hash.Update(name, length);
+        }
+    }
+
+    FitCache::FitCache(std::string directory, const std::size_t capacity)
+            : _directory(std::move(directory)),
+              _capacity(capacity == 0 ? 1 : capacity),
+              _hits(0),
+              _misses(0)
+    {
+    }
+
+    ModelSnapshot FitCache::Fit(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, std::unique_ptr<IDistribution> distribution, const FitOptions &options)
+    {
+        if (distribution == nullptr) {
+            distribution = std::make_unique<Distributions::GaussianDistribution>();
+        }
+
+        const std::uint64_t key = Key(design, response, weights, *distribution, options);
+
+        ModelSnapshot snapshot(LinkKind::Identity, std::vector<double>());
+
+        if (Find(key, snapshot)) {
+            return snapshot;
+        }
+
+        if (!_directory.empty()) {
+            try {
+                snapshot = ModelSnapshot::Load(PathOf(key));
+                Insert(key, snapshot);
+                return snapshot;
+            }
+            catch (const std::runtime_error &) {
+                // Missing or unreadable; fall through and fit.
+            }
+        }
+
+        snapshot = GeneralizedLinearModel(design, response, weights, std::move(distribution), options).Snapshot();
+
+        Insert(key, snapshot);
+
+        if (!_directory.empty()) {
+            // Readers only ever see complete files: write privately, then rename into place.
+            std::ostringstream temporary;
+            temporary << PathOf(key) << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+
+            snapshot.Save(temporary.str());
+
+            if (std::rename(temporary.str().c_str(), PathOf(key).c_str()) != 0) {
+                std::remove(temporary.str().c_str());
+            }
+        }
+
+        return snapshot;
+    }
+
+    const std::uint64_t FitCache::Key(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, const IDistribution &distribution, const FitOptions &options)
+    {
+        Xxh64 hash(KeyVersion);
+
+        hash.Update(fingerprint(design));
+        hash.Update(fingerprint(response, design.Pool()));
+        hash.Update(fingerprint(weights, design.Pool()));
+
+        UpdateName(hash, typeid(distribution).name());
+        UpdateName(hash, typeid(distribution.LinkFunction()).name());
+
+        hash.Update(static_cast<std::uint64_t>(options.MaxIterations));
+        hash.Update(&options.Tolerance, sizeof(options.Tolerance));
+        hash.Update(static_cast<std::uint64_t>(options.Equilibrate) << 1 | static_cast<std::uint64_t>(options.MixedPrecision));
+
+        if (options.Robust != nullptr) {
+            UpdateName(hash, typeid(*options.Robust).name());
+
+            const double tuning = options.Robust->Tuning();
+            hash.Update(&tuning, sizeof(tuning));
+        } else {
+            UpdateName(hash, "");
+        }
+
+        return hash.Digest();
+    }
+
+    const std::size_t FitCache::Hits() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _hits;
+    }
+
+    const std::size_t FitCache::Misses() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _misses;
+    }
+
+    void FitCache::Clear()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _entries.clear();
+        _recency.clear();
+    }
+
+    bool FitCache::Find(const std::uint64_t key, ModelSnapshot &snapshot)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        const auto entry = _entries.find(key);
+
+        if (entry == _entries.end()) {
+            _misses++;
+            return false;
+        }
+
+        _hits++;
+        _recency.splice(_recency.begin(), _recency, entry->second.second);
+
+        snapshot = entry->second.first;
+
+        return true;
+    }
+
+    void FitCache::Insert(const std::uint64_t key, const ModelSnapshot &snapshot)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (_entries.count(key) != 0) {
+            return;
+        }
+
+        _recency.push_front(key);
+        _entries.emplace(key, Entry(snapshot, _recency.begin()));
+
+        if (_entries.size() > _capacity) {
+            _entries.erase(_recency.back());
+            _recency.pop_back();
+        }
+    }
+
+    std::string FitCache::PathOf(const std::uint64_t key) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.adms", static_cast<unsigned long long>(key));
+
+        return _directory + "/" + name;
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "DesignMatrix.h"
+#include "FitOptions.h"
+#include "IDistribution.h"
+#include "ModelSnapshot.h"
+
+namespace RegressionModels {
+
+    /// <summary>
+    /// A content-addressed cache of fitted <see cref="GeneralizedLinearModel"/> snapshots.
+    /// </summary>
+    /// <remarks>
+    /// A fit is keyed on the fingerprints of its design, including its validity mask, response and weights (see
+    /// <see cref="Fingerprint"/>) together with its distribution, link function and the fit options that change the
+    /// estimates, among them the robust weight function and its tuning constant. Repeating a fit therefore costs one hashing pass over the data plus a lookup,
+    /// first in memory and then, when a directory is given, on disk. Entries are immutable, so the cache never needs
+    /// invalidation: different data or a different specification is simply a different key.
+    /// </remarks>
+    class FitCache {
+    public:
+
+        /// <param name="directory">
+        /// The directory that stores snapshots across processes, or empty to cache in memory only.
+        /// </param>
+        /// <param name="capacity">
+        /// The number of snapshots held in memory; the least recently used are evicted first.
+        /// </param>
+        explicit FitCache(std::string directory = std::string(), std::size_t capacity = 64);
+
+        FitCache(const FitCache &) = delete;
+
+        FitCache &operator=(const FitCache &) = delete;
+
+        /// <summary>
+        /// Returns the snapshot of the requested fit, fitting the model only if no cached snapshot exists.
+        /// </summary>
+        ModelSnapshot Fit(
+                const DesignMatrix &design,
+                const std::vector<double> &response,
+                const std::vector<double> &weights,
+                std::unique_ptr<IDistribution> distribution = nullptr,
+                const FitOptions &options = FitOptions());
+
+        /// <summary>
+        /// Computes the cache key of a fit.
+        /// </summary>
+        static const std::uint64_t Key(
+                const DesignMatrix &design,
+                const std::vector<double> &response,
+                const std::vector<double> &weights,
+                const IDistribution &distribution,
+                const FitOptions &options);
+
+        const std::size_t Hits() const;
+
+        const std::size_t Misses() const;
+
+        /// <summary>
+        /// Empties the in-memory cache. Snapshots on disk are kept.
+        /// </summary>
+        void Clear();
+
+    private:
+
+        using Entry = std::pair<ModelSnapshot, std::list<std::uint64_t>::iterator>;
+
+        bool Find(std::uint64_t key, ModelSnapshot &snapshot);
+
+        void Insert(std::uint64_t key, const ModelSnapshot &snapshot);
+
+        std::string PathOf(std::uint64_t key) const;
+
+        const std::string _directory;
+
+        const std::size_t _capacity;
+
+        mutable std::mutex _mutex;
+
+        std::unordered_map<std::uint64_t, Entry> _entries;
+
+        std::list<std::uint64_t> _recency;
+
+        std::size_t _hits;
+
+        std::size_t _misses;
+    };
+}
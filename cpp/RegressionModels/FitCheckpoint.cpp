@@ -0,0 +1,125 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <typeinfo>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include "FitCheckpoint.h"
+#include "Fingerprint.h"
+
+namespace RegressionModels {
+    namespace {
+        const char Magic[4] = {'A', 'D', 'M', 'C'};
+
+        const std::uint32_t FormatVersion = 2;
+    }
+
+    const std::uint64_t FitCheckpoint::Key(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, const IDistribution &distribution, const FitOptions &options)
+    {
+        Xxh64 hash(FormatVersion);
+
+        hash.Update(fingerprint(design));
+        hash.Update(fingerprint(response, design.Pool()));
+        hash.Update(fingerprint(weights, design.Pool()));
+
+        for (const char *name : {typeid(distribution).name(), typeid(distribution.LinkFunction()).name()}) {
+            hash.Update(name, std::strlen(name) + 1);
+        }
+
+        if (options.Robust != nullptr) {
+            const char *name = typeid(*options.Robust).name();
+            const double tuning = options.Robust->Tuning();
+
+            hash.Update(name, std::strlen(name) + 1);
+            hash.Update(&tuning, sizeof(tuning));
+        } else {
+            hash.Update(static_cast<std::uint64_t>(0));
+        }
+
+        hash.Update(static_cast<std::uint64_t>(options.Equilibrate) << 1 | static_cast<std::uint64_t>(options.MixedPrecision));
+
+        return hash.Digest();
+    }
+
+    bool FitCheckpoint::TryLoad(const std::string &path, FitCheckpoint &checkpoint)
+    {
+        std::ifstream file(path, std::ios::binary);
+
+        char magic[4];
+        std::uint32_t version = 0;
+        std::uint64_t key = 0;
+        std::uint64_t iteration = 0;
+        double deviance = 0.0;
+        std::uint64_t count = 0;
+
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char *>(&version), sizeof(version));
+        file.read(reinterpret_cast<char *>(&key), sizeof(key));
+        file.read(reinterpret_cast<char *>(&iteration), sizeof(iteration));
+        file.read(reinterpret_cast<char *>(&deviance), sizeof(deviance));
+        file.read(reinterpret_cast<char *>(&count), sizeof(count));
+
+        if (!file || std::memcmp(magic, Magic, sizeof(Magic)) != 0 || version != FormatVersion || count > (1u << 24)) {
+            return false;
+        }
+
+        std::vector<double> coefficients(count);
+
+        file.read(reinterpret_cast<char *>(coefficients.data()), static_cast<std::streamsize>(count * sizeof(double)));
+
+        if (!file) {
+            return false;
+        }
+
+        checkpoint.FitKey = key;
+        checkpoint.Iteration = iteration;
+        checkpoint.Deviance = deviance;
+        checkpoint.Coefficients = std::move(coefficients);
+
+        return true;
+    }
+
+    void FitCheckpoint::Save(const std::string &path) const
+    {
+        const std::string temporary = path + ".tmp";
+
+        std::FILE *file = std::fopen(temporary.c_str(), "wb");
+
+        if (file == nullptr) {
+            throw std::runtime_error("Unable to write " + temporary + ".");
+        }
+
+        const auto iteration = static_cast<std::uint64_t>(Iteration);
+        const auto count = static_cast<std::uint64_t>(Coefficients.size());
+
+        bool written =
+                std::fwrite(Magic, sizeof(Magic), 1, file) == 1
+                && std::fwrite(&FormatVersion, sizeof(FormatVersion), 1, file) == 1
+                && std::fwrite(&FitKey, sizeof(FitKey), 1, file) == 1
+                && std::fwrite(&iteration, sizeof(iteration), 1, file) == 1
+                && std::fwrite(&Deviance, sizeof(Deviance), 1, file) == 1
+                && std::fwrite(&count, sizeof(count), 1, file) == 1
+                && std::fwrite(Coefficients.data(), sizeof(double), Coefficients.size(), file) == Coefficients.size()
+                && std::fflush(file) == 0;
+
+        // The data must reach the disk before the rename does, or a crash can leave the new name on an empty file.
+#if defined(_WIN32)
+        written = written && _commit(_fileno(file)) == 0;
+#else
+        written = written && fsync(fileno(file)) == 0;
+#endif
+
+        if (std::fclose(file) != 0 || !written) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Unable to write " + temporary + ".");
+        }
+
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Unable to replace " + path + ".");
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DesignMatrix.h"
+#include "FitOptions.h"
+#include "IDistribution.h"
+
+namespace RegressionModels {
+
+    /// <summary>
+    /// The state of an interrupted Iteratively Reweighted Least Squares (IRLS) fit.
+    /// </summary>
+    /// <remarks>
+    /// IRLS is memoryless beyond its coefficients: the working weights and response of the next iteration follow from
+    /// the coefficients alone, so a checkpoint only needs the coefficients, the deviance they produced (for the
+    /// convergence test) and the iteration count. The key ties a checkpoint to the data and specification it was
+    /// taken from, so a stale file is ignored rather than resumed.
+    /// </remarks>
+    struct FitCheckpoint {
+        /// <summary>
+        /// Identifies the data, distribution, link function and robust weights of the fit (see <see cref="Key"/>).
+        /// </summary>
+        std::uint64_t FitKey = 0;
+
+        /// <summary>
+        /// The number of completed iterations.
+        /// </summary>
+        unsigned long Iteration = 0;
+
+        /// <summary>
+        /// The deviance at <see cref="Coefficients"/>.
+        /// </summary>
+        double Deviance = 0.0;
+
+        std::vector<double> Coefficients;
+
+        /// <summary>
+        /// Computes the key of a fit from its data and specification: the robust weight function and its tuning
+        /// constant, and the options that change the solution of each step. Iteration limits and tolerances are
+        /// excluded, so a fit may be resumed with different ones.
+        /// </summary>
+        static const std::uint64_t Key(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, const IDistribution &distribution, const FitOptions &options);
+
+        /// <summary>
+        /// Reads a checkpoint written by <see cref="Save"/>.
+        /// </summary>
+        /// <returns>
+        /// False if the file does not exist or is not a complete checkpoint.
+        /// </returns>
+        static bool TryLoad(const std::string &path, FitCheckpoint &checkpoint);
+
+        /// <summary>
+        /// Replaces the file atomically and durably: the contents reach the disk before the rename, so an interruption or
+        /// a crash leaves either the previous checkpoint or this one.
+        /// </summary>
+        void Save(const std::string &path) const;
+    };
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include "CancellationToken.h"
+#include "IWeightFunction.h"
+
+namespace RegressionModels {
+
+    /// <summary>
+    /// The state of an Iteratively Reweighted Least Squares (IRLS) fit after a completed iteration.
+    /// </summary>
+    struct FitProgress {
+        /// <summary>
+        /// The number of completed iterations.
+        /// </summary>
+        unsigned long Iteration = 0;
+
+        /// <summary>
+        /// The deviance at the current coefficients.
+        /// </summary>
+        double Deviance = 0.0;
+    };
+
+    /// <summary>
+    /// Controls the Iteratively Reweighted Least Squares (IRLS) algorithm.
+    /// </summary>
+    struct FitOptions {
+        /// <summary>
+        /// The maximum number of iterations.
+        /// </summary>
+        unsigned long MaxIterations = 100;
+
+        /// <summary>
+        /// The relative change in deviance below which the fit has converged.
+        /// </summary>
+        double Tolerance = 1e-8;
+
+        /// <summary>
+        /// Checked between the phases of each iteration; a canceled fit throws
+        /// <see cref="Threading::OperationCanceledException"/>.
+        /// </summary>
+        Threading::CancellationToken Cancellation;
+
+        /// <summary>
+        /// True to make the fit bitwise reproducible for any number of threads, at some cost in speed: the Gram
+        /// matrix is reduced with <see cref="ReductionMode::Reproducible"/>. The other reductions of a fit are always
+        /// chunked independently of the thread count.
+        /// </summary>
+        bool Reproducible = false;
+
+        /// <summary>
+        /// True to solve each weighted least squares step with <see cref="SolverMixedPrecision"/>, which is faster for
+        /// wide models and falls back to a double precision factorization when the normal equations are too
+        /// ill-conditioned for it.
+        /// </summary>
+        bool MixedPrecision = false;
+
+        /// <summary>
+        /// True to solve each weighted least squares step in equilibrated space, as if every column of the design had
+        /// been scaled to unit weighted norm (see <see cref="Equilibration"/>). The scale factors come from the
+        /// diagonal of the Gram matrix, so the design is neither copied nor read again; the coefficients and
+        /// <see cref="GeneralizedLinearModel::Covariance"/> are returned in the original units.
+        /// </summary>
+        bool Equilibrate = true;
+
+        /// <summary>
+        /// The weight function of a robust M-estimate, or null for a maximum likelihood fit. From the second iteration
+        /// on, each observation's working weight is multiplied by the weight of its standardized Pearson residual,
+        /// where the scale is the median absolute residual over Φ⁻¹(0.75), re-estimated every iteration. The first
+        /// iteration is the unweighted fit that starts the reweighting.
+        /// </summary>
+        std::shared_ptr<const IWeightFunction> Robust;
+
+        /// <summary>
+        /// Invoked on the fitting thread after each iteration. May be empty.
+        /// </summary>
+        std::function<void(const FitProgress &)> Progress;
+
+        /// <summary>
+        /// The file that receives periodic checkpoints, or empty to disable checkpointing. A fit whose checkpoint
+        /// file holds a checkpoint of the same data and specification resumes from it (see
+        /// <see cref="FitCheckpoint"/>).
+        /// </summary>
+        std::string CheckpointPath;
+
+        /// <summary>
+        /// The number of iterations between checkpoints.
+        /// </summary>
+        unsigned long CheckpointInterval = 1;
+
+        /// <summary>
+        /// The number of fixed-effect levels absorbed from the design and response before the fit (see
+        /// <see cref="Formulas::ColumnPlan"/>), which the degrees of freedom exclude.
+        /// </summary>
+        unsigned long AbsorbedLevels = 0;
+    };
+}
@@ -1,29 +1,651 @@
-#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
 #include <numeric>
+#include <stdexcept>
+#include <vector>
 #include "GeneralizedLinearModel.h"
 #include "GaussianDistribution.h"
-#include "Prepend.h"
+#include "PoissonDistribution.h"
+#include "IdentityLinkFunction.h"
+#include "LogLinkFunction.h"
+#include "DecompositionCholesky.h"
+#include "Equilibration.h"
+#include "FitCheckpoint.h"
+#include "Kernels.h"
+#include "MatrixProduct.h"
+#include "Normal.h"
+#include "ShardWorker.h"
+#include "SolverCholesky.h"
+#include "SolverMixedPrecision.h"
+#include "WeightedGram.h"
 
 namespace RegressionModels {
+    namespace {
+        /// <summary>
+        /// The lower Cholesky factor L of D * G * D and the scale D of a solved system, kept so the covariance does not
+        /// factor the same Gram matrix again. Empty when the system was solved in mixed precision.
+        /// </summary>
+        struct Factor {
+            std::vector<double> Lower;
+
+            std::vector<double> Scale;
+        };
+
+        std::vector<double> SolveUnscaled(const std::vector<double> &gram, const std::vector<double> &moment, const FitOptions &options, Factor &factor)
+        {
+            if (options.MixedPrecision) {
+                factor.Lower.clear();
+                return solverMixedPrecision(gram, moment);
+            }
+
+            factor.Lower = decompositionCholesky(gram, moment.size());
+
+            return solverCholesky(factor.Lower, moment);
+        }
+
+        std::vector<double> Solve(const std::vector<double> &gram, const std::vector<double> &moment, const FitOptions &options, Factor &factor)
+        {
+            if (!options.Equilibrate) {
+                factor.Scale.assign(moment.size(), 1.0);
+                return SolveUnscaled(gram, moment, options, factor);
+            }
+
+            // Solving (D * G * D) * y = D * m and returning x = D * y fits the design X * D in scaled space.
+            const Equilibration equilibration(gram, moment.size());
+
+            factor.Scale = equilibration.Scale();
+
+            return equilibration.ApplyToVector(SolveUnscaled(equilibration.ApplyToMatrix(gram), equilibration.ApplyToVector(moment), options, factor));
+        }
+
+        /// <summary>
+        /// Inverts G = D⁻¹ * L * Lᵀ * D⁻¹ from its factor: G⁻¹ = D * (L * Lᵀ)⁻¹ * D.
+        /// </summary>
+        std::vector<double> Invert(const std::vector<double> &lower, const std::vector<double> &scale)
+        {
+            const std::size_t k = scale.size();
+
+            std::vector<double> inverse(k * k);
+            std::vector<double> unit(k, 0.0);
+
+            for (std::size_t j = 0; j < k; j++) {
+                unit[j] = 1.0;
+
+                const std::vector<double> column = solverCholesky(lower, unit);
+
+                for (std::size_t i = 0; i < k; i++) {
+                    inverse[i * k + j] = scale[i] * column[i] * scale[j];
+                }
+
+                unit[j] = 0.0;
+            }
+
+            return inverse;
+        }
+
+        /// <summary>
+        /// Estimates the scale of residuals centred at zero by their median absolute value over Φ⁻¹(0.75), found by
+        /// selection rather than sorting.
+        /// </summary>
+        double MedianAbsoluteDeviation(const std::vector<double> &residuals, const ValidityMask &valid)
+        {
+            std::vector<double> values;
+            values.reserve(valid.ValidCount());
+
+            for (std::size_t i = 0; i < residuals.size(); i++) {
+                if (valid[i]) {
+                    values.push_back(std::abs(residuals[i]));
+                }
+            }
+
+            const std::size_t middle = values.size() / 2;
+
+            std::nth_element(values.begin(), values.begin() + middle, values.end());
+
+            double median = values[middle];
+
+            if (values.size() % 2 == 0) {
+                median = 0.5 * (median + *std::max_element(values.begin(), values.begin() + middle));
+            }
+
+            return median / SpecialFunctions::Normal::Quantile(0.75);
+        }
+
+        /// <summary>
+        /// Divides the residuals by the scale of the valid ones, returning the scale. Residuals with zero scale are left
+        /// unchanged.
+        /// </summary>
+        double Standardize(std::vector<double> &residuals, const ValidityMask &valid)
+        {
+            const double scale = MedianAbsoluteDeviation(residuals, valid);
+
+            if (scale > 0.0) {
+                for (double &residual : residuals) {
+                    residual /= scale;
+                }
+            }
+
+            return scale;
+        }
+    }
+
     GeneralizedLinearModel::GeneralizedLinearModel(const std::vector<std::vector<double>> &design, const std::vector<double> &response, const std::vector<double> &weights, std::unique_ptr<IDistribution> distribution, const bool addConstant)
+            : GeneralizedLinearModel(DesignMatrix(design, addConstant), response, weights, std::move(distribution))
+    {
+    }
+
+    GeneralizedLinearModel::GeneralizedLinearModel(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, std::unique_ptr<IDistribution> distribution, const FitOptions &options)
     {
-        if (design.size() != response.size() || design.size() != weights.size() || design.empty()) {
+        if (design.RowCount() != response.size() || design.RowCount() != weights.size() || design.RowCount() == 0) {
             throw std::out_of_range("Argument vectors differ in length.");
         }
 
+        // Listwise deletion: observations masked out of the design, or with a missing response or weight, keep their
+        // rows, and the kernels and distribution skip them through the mask, so they are never read.
+        ValidityMask valid = ValidityMask::Of(response);
+        valid &= ValidityMask::Of(weights);
+
+        if (design.IsMasked()) {
+            valid &= design.Mask();
+        }
+
+        if (valid.ValidCount() == 0) {
+            throw std::invalid_argument("No observation is valid.");
+        }
+
         _distribution = distribution == nullptr ? std::make_unique<Distributions::GaussianDistribution>() : std::move(distribution);
-        _observationCount = design[0].size();
-        _variableCount = design.size();
+        _observationCount = valid.ValidCount();
+        _variableCount = design.ColumnCount();
+        _absorbedLevels = options.AbsorbedLevels;
+        _hasConstant = design.HasConstant();
+        _sumSquaredErrors = 0;
+        _deviance = 0;
+        _scale = std::numeric_limits<double>::quiet_NaN();
+        _dispersion = std::numeric_limits<double>::quiet_NaN();
+        _iterations = 0;
+        _converged = false;
+
+        Fit(design, response, weights, options, valid);
+    }
+
+    GeneralizedLinearModel::GeneralizedLinearModel(std::unique_ptr<IDistribution> distribution)
+            : _distribution(distribution == nullptr ? std::make_unique<Distributions::GaussianDistribution>() : std::move(distribution)),
+              _observationCount(0),
+              _variableCount(0),
+              _absorbedLevels(0),
+              _hasConstant(false),
+              _sumSquaredErrors(0),
+              _deviance(0),
+              _scale(std::numeric_limits<double>::quiet_NaN()),
+              _dispersion(std::numeric_limits<double>::quiet_NaN()),
+              _iterations(0),
+              _converged(false)
+    {
+    }
+
+    GeneralizedLinearModel GeneralizedLinearModel::FitSharded(const std::vector<IChannel *> &shards, std::unique_ptr<IDistribution> distribution, const FitOptions &options)
+    {
+        if (shards.empty()) {
+            throw std::out_of_range("Argument vector is empty.");
+        }
+
+        if (options.Robust != nullptr) {
+            throw std::invalid_argument("Robust weights are not supported for sharded fits.");
+        }
+
+        GeneralizedLinearModel model(std::move(distribution));
+
+        for (IChannel *shard : shards) {
+            const std::vector<double> announcement = shard->Receive();
+
+            if (announcement.size() != 2 || (model._variableCount != 0 && announcement[1] != model._variableCount)) {
+                throw std::out_of_range("Shards differ in their number of variables.");
+            }
+
+            model._observationCount += static_cast<unsigned long>(announcement[0]);
+            model._variableCount = static_cast<unsigned long>(announcement[1]);
+        }
+
+        if (model._observationCount == 0) {
+            throw std::invalid_argument("No observation is valid.");
+        }
+
+        const std::size_t k = model._variableCount;
+
+        std::vector<double> statistics;
+        std::vector<double> lastGram;
+        Factor factor;
+
+        const auto exchange = [&](const std::vector<double> &command) {
+            for (IChannel *shard : shards) {
+                shard->Send(command);
+            }
+
+            statistics.assign(2 + k * k + k, 0.0);
+
+            for (IChannel *shard : shards) {
+                const std::vector<double> partial = shard->Receive();
+
+                if (partial.size() != statistics.size()) {
+                    throw std::runtime_error("Received malformed shard statistics.");
+                }
+
+                for (std::size_t i = 0; i < partial.size(); i++) {
+                    statistics[i] += partial[i];
+                }
+            }
+        };
+
+        try {
+            exchange({static_cast<double>(ShardCommand::Start), options.Reproducible ? 1.0 : 0.0});
+
+            double previousDeviance = std::numeric_limits<double>::infinity();
+
+            for (; model._iterations < options.MaxIterations && !model._converged; model._iterations++) {
+                options.Cancellation.ThrowIfCancellationRequested();
+
+                const std::vector<double> gram(statistics.begin() + 2, statistics.begin() + 2 + k * k);
+                const std::vector<double> moment(statistics.begin() + 2 + k * k, statistics.end());
+
+                model._coefficients = Solve(gram, moment, options, factor);
+                lastGram = gram;
+
+                std::vector<double> command{static_cast<double>(ShardCommand::Iterate)};
+                command.insert(command.end(), model._coefficients.begin(), model._coefficients.end());
+
+                exchange(command);
+
+                model._deviance = statistics[0];
+                model._sumSquaredErrors = statistics[1];
+
+                model._converged = std::abs(model._deviance - previousDeviance) <= options.Tolerance * (std::abs(model._deviance) + 0.1);
+                previousDeviance = model._deviance;
+
+                if (options.Progress) {
+                    options.Progress(FitProgress{model._iterations + 1, model._deviance});
+                }
+            }
+        }
+        catch (...) {
+            // Release the workers before reporting the failure; a broken channel cannot be released.
+            for (IChannel *shard : shards) {
+                try {
+                    shard->Send({static_cast<double>(ShardCommand::Stop)});
+                }
+                catch (...) {
+                }
+            }
+
+            throw;
+        }
+
+        for (IChannel *shard : shards) {
+            shard->Send({static_cast<double>(ShardCommand::Stop)});
+        }
+
+        if (!factor.Lower.empty()) {
+            model.Factorize(std::move(factor.Lower), std::move(factor.Scale));
+        } else if (!lastGram.empty()) {
+            model.Factorize(lastGram, options);
+        }
+
+        return model;
+    }
+
+    AsyncFit<GeneralizedLinearModel> GeneralizedLinearModel::FitAsync(DesignMatrix design, std::vector<double> response, std::vector<double> weights, std::unique_ptr<IDistribution> distribution, FitOptions options)
+    {
+        return AsyncFit<GeneralizedLinearModel>::Run(
+                std::move(options),
+                [design = std::move(design), response = std::move(response), weights = std::move(weights), distribution = std::move(distribution)](const FitOptions &fitOptions) mutable {
+                    return std::make_unique<GeneralizedLinearModel>(design, response, weights, std::move(distribution), fitOptions);
+                });
+    }
+
+    void GeneralizedLinearModel::Fit(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, const FitOptions &options, const ValidityMask &valid)
+    {
+        const ILinkFunction &link = _distribution->LinkFunction();
+        const Threading::CancellationToken &cancellation = options.Cancellation;
+        const std::size_t n = design.RowCount();
+        const IWeightFunction *robust = options.Robust.get();
+
+        std::vector<double> meanResponse = _distribution->InitialMean(response, valid);
+        std::vector<double> linearResponse = _distribution->Predict(meanResponse);
+        std::vector<double> wlsResponse(n);
+
+        // The standardized Pearson residuals of a robust fit, sqrt(w) * (z - η), and whether coefficients exist to
+        // compute them from.
+        std::vector<double> residuals(robust != nullptr ? n : 0);
+        bool reweighting = false;
+
+        double previousDeviance = std::numeric_limits<double>::infinity();
+
+        std::vector<double> lastGram;
+        Factor factor;
+
+        _iterations = 0;
+
+        const bool checkpointing = !options.CheckpointPath.empty();
+        const std::uint64_t checkpointKey = checkpointing ? FitCheckpoint::Key(design, response, weights, *_distribution, options) : 0;
+
+        FitCheckpoint checkpoint;
+
+        if (checkpointing
+            && FitCheckpoint::TryLoad(options.CheckpointPath, checkpoint)
+            && checkpoint.FitKey == checkpointKey
+            && checkpoint.Coefficients.size() == _variableCount) {
+            _coefficients = std::move(checkpoint.Coefficients);
+            _iterations = checkpoint.Iteration;
+            _deviance = checkpoint.Deviance;
+            previousDeviance = checkpoint.Deviance;
+
+            linearResponse = matrixProduct(design, _coefficients, valid);
+            meanResponse = _distribution->Fit(linearResponse);
+            reweighting = true;
+        }
+
+        for (; _iterations < options.MaxIterations && !_converged; _iterations++) {
+            cancellation.ThrowIfCancellationRequested();
+
+            std::vector<double> wlsWeights = _distribution->Weight(meanResponse);
+            const std::vector<double> derivative = link.FirstDerivative(meanResponse);
+
+            for (std::size_t i = 0; i < n; i++) {
+                wlsWeights[i] *= weights[i];
+                wlsResponse[i] = linearResponse[i] + derivative[i] * (response[i] - meanResponse[i]);
+            }
+
+            if (robust != nullptr && reweighting) {
+                for (std::size_t i = 0; i < n; i++) {
+                    residuals[i] = std::sqrt(wlsWeights[i]) * (wlsResponse[i] - linearResponse[i]);
+                }
+
+                _scale = Standardize(residuals, valid);
+
+                const std::vector<double> robustWeights = robust->Weight(residuals);
+
+                for (std::size_t i = 0; i < n; i++) {
+                    wlsWeights[i] *= robustWeights[i];
+                }
+            }
+
+            cancellation.ThrowIfCancellationRequested();
+
+            const NormalEquations equations =
+                    weightedGram(
+                            design,
+                            wlsWeights,
+                            wlsResponse,
+                            options.Reproducible ? ReductionMode::Reproducible : ReductionMode::Partitioned,
+                            valid);
+
+            cancellation.ThrowIfCancellationRequested();
+
+            _coefficients = Solve(equations.Gram, equations.Moment, options, factor);
+            lastGram = equations.Gram;
+            reweighting = true;
+
+            cancellation.ThrowIfCancellationRequested();
+
+            linearResponse = matrixProduct(design, _coefficients, valid);
+            meanResponse = _distribution->Fit(linearResponse);
+            _deviance = _distribution->Deviance(response, meanResponse, weights, 1.0, valid);
+
+            _converged = std::abs(_deviance - previousDeviance) <= options.Tolerance * (std::abs(_deviance) + 0.1);
+            previousDeviance = _deviance;
+
+            if (options.Progress) {
+                options.Progress(FitProgress{_iterations + 1, _deviance});
+            }
+
+            if (checkpointing && (_iterations + 1) % std::max(options.CheckpointInterval, 1ul) == 0) {
+                FitCheckpoint{checkpointKey, _iterations + 1, _deviance, _coefficients}.Save(options.CheckpointPath);
+            }
+        }
+
+        // A fit resumed from the checkpoint of an exhausted run skips the loop, so its normal equations are rebuilt from
+        // the loaded coefficients.
+        if (lastGram.empty() && reweighting) {
+            std::vector<double> wlsWeights = _distribution->Weight(meanResponse);
+
+            for (std::size_t i = 0; i < n; i++) {
+                wlsWeights[i] *= weights[i];
+            }
+
+            lastGram =
+                    weightedGram(
+                            design,
+                            wlsWeights,
+                            linearResponse,
+                            options.Reproducible ? ReductionMode::Reproducible : ReductionMode::Partitioned,
+                            valid).Gram;
+        }
+
+        if (robust != nullptr && !lastGram.empty()) {
+            FitRobustCovariance(design, response, weights, meanResponse, *robust, options, valid);
+        } else if (!factor.Lower.empty()) {
+            Factorize(std::move(factor.Lower), std::move(factor.Scale));
+        } else if (!lastGram.empty()) {
+            Factorize(lastGram, options);
+        }
+
+        // A converged fit has nothing left to resume; an exhausted one keeps its checkpoint for a longer run.
+        if (checkpointing && _converged) {
+            std::remove(options.CheckpointPath.c_str());
+        }
+
+        const Kernels::KernelTable &kernels = Kernels::Active();
+
+        double squares[DesignMatrix::BlockRows];
+
         _sumSquaredErrors = 0;
+        for (std::size_t row = 0; row < n; row += DesignMatrix::BlockRows) {
+            const std::size_t count = std::min(DesignMatrix::BlockRows, n - row);
+
+            for (std::size_t i = 0, j = row; i < count; i++, j++) {
+                squares[i] = valid[j] ? (response[j] - meanResponse[j]) * (response[j] - meanResponse[j]) : 0.0;
+            }
+
+            _sumSquaredErrors += kernels.Sum(squares, count);
+        }
+    }
+
+    void GeneralizedLinearModel::FitRobustCovariance(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, const std::vector<double> &meanResponse, const IWeightFunction &robust, const FitOptions &options, const ValidityMask &valid)
+    {
+        const std::size_t n = design.RowCount();
+        const double count = static_cast<double>(valid.ValidCount());
+
+        std::vector<double> wlsWeights = _distribution->Weight(meanResponse);
+        const std::vector<double> derivative = _distribution->LinkFunction().FirstDerivative(meanResponse);
+
+        std::vector<double> residuals(n);
+
+        for (std::size_t i = 0; i < n; i++) {
+            wlsWeights[i] *= weights[i];
+            residuals[i] = std::sqrt(wlsWeights[i]) * derivative[i] * (response[i] - meanResponse[i]);
+        }
+
+        _scale = Standardize(residuals, valid);
+
+        const std::vector<double> psi = robust.Psi(residuals);
+        const std::vector<double> psiDerivative = robust.PsiDerivative(residuals);
+
+        double sumSquaredPsi = 0.0;
+        double meanDerivative = 0.0;
+        double meanSquaredDerivative = 0.0;
+
+        for (std::size_t i = 0; i < n; i++) {
+            if (!valid[i]) {
+                continue;
+            }
+
+            sumSquaredPsi += psi[i] * psi[i];
+            meanDerivative += psiDerivative[i];
+            meanSquaredDerivative += psiDerivative[i] * psiDerivative[i];
+        }
+
+        meanDerivative /= count;
+        meanSquaredDerivative /= count;
+
+        // Huber's small-sample correction K = 1 + p / n * Var(ψ') / E(ψ')².
+        const double correction = 1.0 + static_cast<double>(_variableCount) / count * (meanSquaredDerivative - meanDerivative * meanDerivative) / (meanDerivative * meanDerivative);
+
+        _dispersion = correction * correction * _scale * _scale * sumSquaredPsi / DegreesOfFreedom() / (meanDerivative * meanDerivative);
+
+        const NormalEquations equations =
+                weightedGram(
+                        design,
+                        wlsWeights,
+                        residuals,
+                        options.Reproducible ? ReductionMode::Reproducible : ReductionMode::Partitioned,
+                        valid);
+
+        Factorize(equations.Gram, options);
+    }
+
+    void GeneralizedLinearModel::Factorize(const std::vector<double> &gram, const FitOptions &options)
+    {
+        const std::size_t k = _variableCount;
+
+        if (options.Equilibrate) {
+            const Equilibration equilibration(gram, k);
+
+            Factorize(decompositionCholesky(equilibration.ApplyToMatrix(gram), k), equilibration.Scale());
+        } else {
+            Factorize(decompositionCholesky(gram, k), std::vector<double>(k, 1.0));
+        }
+    }
+
+    void GeneralizedLinearModel::Factorize(std::vector<double> lower, std::vector<double> scale)
+    {
+        _factor = std::move(lower);
+        _factorScale = std::move(scale);
+        _covariance = Invert(_factor, _factorScale);
+    }
+
+    const std::vector<double> GeneralizedLinearModel::VarianceInflationFactors() const
+    {
+        if (_factor.empty()) {
+            return std::vector<double>();
+        }
+
+        const std::size_t k = _variableCount;
+        const std::size_t first = _hasConstant ? 1 : 0;
+
+        std::vector<double> result(k);
+
+        for (std::size_t j = 0; j < k; j++) {
+            const double *row = _factor.data() + j * k;
+
+            // Xᵀ * W * X = D⁻¹ * L * Lᵀ * D⁻¹, so Sⱼⱼ is the squared norm of row j of L over Dⱼⱼ².
+            double squares = 0.0;
+
+            for (std::size_t m = first; m <= j; m++) {
+                squares += row[m] * row[m];
+            }
 
-        const std::vector<std::vector<double>> designArray = addConstant ? prepend(design, 1.0) : design;
+            result[j] = _covariance[j * k + j] * squares / (_factorScale[j] * _factorScale[j]);
+        }
+
+        if (_hasConstant) {
+            result[0] = std::numeric_limits<double>::quiet_NaN();
+        }
+
+        return result;
+    }
+
+    const std::vector<double> GeneralizedLinearModel::ConditionIndices() const
+    {
+        if (_factor.empty()) {
+            return std::vector<double>();
+        }
+
+        const std::size_t k = _variableCount;
+
+        // Rows of unit length factor the Gram matrix of the design with columns of unit length.
+        std::vector<double> rows(_factor);
+
+        for (std::size_t j = 0; j < k; j++) {
+            const double norm = std::sqrt(std::inner_product(rows.begin() + j * k, rows.begin() + (j + 1) * k, rows.begin() + j * k, 0.0));
+
+            for (std::size_t m = 0; m < k; m++) {
+                rows[j * k + m] /= norm;
+            }
+        }
+
+        // Rotates pairs of rows until every pair is orthogonal (Hestenes, 1958); the row norms are then the singular
+        // values.
+        for (unsigned sweep = 0; sweep < 64; sweep++) {
+            bool rotated = false;
+
+            for (std::size_t p = 0; p < k; p++) {
+                for (std::size_t q = p + 1; q < k; q++) {
+                    double *a = rows.data() + p * k;
+                    double *b = rows.data() + q * k;
+
+                    double alpha = 0.0;
+                    double beta = 0.0;
+                    double gamma = 0.0;
+
+                    for (std::size_t m = 0; m < k; m++) {
+                        alpha += a[m] * a[m];
+                        beta += b[m] * b[m];
+                        gamma += a[m] * b[m];
+                    }
+
+                    if (std::abs(gamma) <= std::numeric_limits<double>::epsilon() * std::sqrt(alpha * beta)) {
+                        continue;
+                    }
+
+                    const double zeta = (beta - alpha) / (2.0 * gamma);
+                    const double t = std::copysign(1.0, zeta) / (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+                    const double c = 1.0 / std::sqrt(1.0 + t * t);
+                    const double s = c * t;
+
+                    for (std::size_t m = 0; m < k; m++) {
+                        const double x = a[m];
+                        const double y = b[m];
+
+                        a[m] = c * x - s * y;
+                        b[m] = s * x + c * y;
+                    }
+
+                    rotated = true;
+                }
+            }
+
+            if (!rotated) {
+                break;
+            }
+        }
+
+        std::vector<double> result(k);
+
+        for (std::size_t j = 0; j < k; j++) {
+            result[j] = std::sqrt(std::inner_product(rows.begin() + j * k, rows.begin() + (j + 1) * k, rows.begin() + j * k, 0.0));
+        }
+
+        const double largest = *std::max_element(result.begin(), result.end());
 
-        _coefficients = std::vector<double>();
+        for (double &value : result) {
+            value = largest / value;
+        }
+
+        std::sort(result.begin(), result.end());
+
+        return result;
     }
 
     const std::vector<double> GeneralizedLinearModel::StandardErrorsOls() const
     {
-        return std::vector<double>();
+        std::vector<double> result = VarianceOls();
+
+        for (double &value : result) {
+            value = std::sqrt(value);
+        }
+
+        return result;
     }
 
     const std::vector<double> GeneralizedLinearModel::StandardErrorsHC0() const
@@ -36,9 +658,32 @@ namespace RegressionModels {
         return std::vector<double>();
     }
 
+    const double GeneralizedLinearModel::Dispersion() const
+    {
+        // The Poisson dispersion is fixed at one; otherwise it is estimated by the deviance per degree of freedom,
+        // which for a Gaussian response is the mean squared error.
+        return !std::isnan(_dispersion)
+               ? _dispersion
+               : dynamic_cast<const Distributions::PoissonDistribution *>(_distribution.get()) != nullptr
+                 ? 1.0
+                 : _deviance / DegreesOfFreedom();
+    }
+
     const std::vector<double> GeneralizedLinearModel::VarianceOls() const
     {
-        return std::vector<double>();
+        if (_covariance.empty()) {
+            return std::vector<double>();
+        }
+
+        const double dispersion = Dispersion();
+
+        std::vector<double> result(_variableCount);
+
+        for (std::size_t i = 0; i < _variableCount; i++) {
+            result[i] = dispersion * _covariance[i * _variableCount + i];
+        }
+
+        return result;
     }
 
     const std::vector<double> GeneralizedLinearModel::VarianceHC0() const
@@ -51,12 +696,33 @@ namespace RegressionModels {
         return std::vector<double>();
     }
 
+    ModelSnapshot GeneralizedLinearModel::Snapshot() const
+    {
+        const ILinkFunction &link = _distribution->LinkFunction();
+
+        if (dynamic_cast<const LinkFunctions::IdentityLinkFunction *>(&link) != nullptr) {
+            return ModelSnapshot(LinkKind::Identity, _coefficients);
+        }
+        if (dynamic_cast<const LinkFunctions::LogLinkFunction *>(&link) != nullptr) {
+            return ModelSnapshot(LinkKind::Log, _coefficients);
+        }
+
+        throw std::invalid_argument("The link function cannot be captured in a snapshot.");
+    }
+
     const double GeneralizedLinearModel::Evaluate(const std::vector<double> &observation) const
     {
-        return std::inner_product(
-                _coefficients.begin(),
-                _coefficients.end(),
-                observation.begin(),
-                0.0);
+        if (observation.size() != _variableCount) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        const double linearResponse =
+                std::inner_product(
+                        _coefficients.begin(),
+                        _coefficients.end(),
+                        observation.begin(),
+                        0.0);
+
+        return _distribution->LinkFunction().Inverse(std::vector<double>{linearResponse})[0];
     }
 }
@@ -3,8 +3,13 @@
 #include <cmath>
 #include <memory>
 #include <vector>
+#include "AsyncFit.h"
+#include "DesignMatrix.h"
+#include "FitOptions.h"
+#include "IChannel.h"
 #include "IDistribution.h"
 #include "IRegressionModel.h"
+#include "ModelSnapshot.h"
 
 namespace RegressionModels {
     class GeneralizedLinearModel : public IRegressionModel {
@@ -17,6 +22,69 @@ namespace RegressionModels {
                 std::unique_ptr<IDistribution> distribution = nullptr,
                 bool addConstant = false);
 
+        GeneralizedLinearModel(
+                const DesignMatrix &design,
+                const std::vector<double> &response,
+                const std::vector<double> &weights,
+                std::unique_ptr<IDistribution> distribution = nullptr,
+                const FitOptions &options = FitOptions());
+
+        /// <summary>
+        /// Schedules a fit on the library thread pool and returns immediately.
+        /// </summary>
+        /// <param name="design">
+        /// The design array.
+        /// </param>
+        /// <param name="response">
+        /// The response values.
+        /// </param>
+        /// <param name="weights">
+        /// The observation weights.
+        /// </param>
+        /// <param name="distribution">
+        /// The distribution of the response, or null for a <see cref="Distributions::GaussianDistribution"/>.
+        /// </param>
+        /// <param name="options">
+        /// The fit options. The returned handle cancels through <see cref="FitOptions::Cancellation"/> and reports
+        /// progress before forwarding it to <see cref="FitOptions::Progress"/>.
+        /// </param>
+        /// <returns>
+        /// A handle to the pending model.
+        /// </returns>
+        static AsyncFit<GeneralizedLinearModel> FitAsync(
+                DesignMatrix design,
+                std::vector<double> response,
+                std::vector<double> weights,
+                std::unique_ptr<IDistribution> distribution = nullptr,
+                FitOptions options = FitOptions());
+
+        /// <summary>
+        /// Fits a model whose rows are sharded across <see cref="ShardWorker"/> processes, acting as the coordinator.
+        /// </summary>
+        /// <remarks>
+        /// Each iteration broadcasts the coefficients, sums the workers' partial normal equations and deviances in
+        /// shard order, and solves for the next coefficients: one round trip per iteration, carrying k² + k + 2
+        /// values per worker. Workers start from the initial means of their own shards, so the iterations differ
+        /// slightly from a single-process fit while converging to the same estimates.
+        /// </remarks>
+        /// <param name="shards">
+        /// One channel per worker. The workers must use the same distribution and link function.
+        /// </param>
+        /// <param name="distribution">
+        /// The distribution of the response, or null for a <see cref="Distributions::GaussianDistribution"/>.
+        /// </param>
+        /// <param name="options">
+        /// The fit options. Checkpointing is not supported for sharded fits.
+        /// </param>
+        static GeneralizedLinearModel FitSharded(
+                const std::vector<IChannel *> &shards,
+                std::unique_ptr<IDistribution> distribution = nullptr,
+                const FitOptions &options = FitOptions());
+
+        /// <summary>
+        /// The number of valid observations, excluding those masked out of the design (see
+        /// <see cref="DesignMatrix::SetMask"/>) and those with a missing response or weight.
+        /// </summary>
         const unsigned long ObservationCount() const override
         { return _observationCount; }
 
@@ -24,7 +92,7 @@ namespace RegressionModels {
         { return _variableCount; }
 
         const long DegreesOfFreedom() const override
-        { return _observationCount - _variableCount; }
+        { return _observationCount - _variableCount - _absorbedLevels; }
 
         const std::vector<double> Coefficients() const override
         { return _coefficients; }
@@ -38,30 +106,159 @@ namespace RegressionModels {
         const double RootMeanSquaredError() const override
         { return sqrt(MeanSquaredError()); }
 
+        const double Deviance() const
+        { return _deviance; }
+
+        const unsigned long Iterations() const
+        { return _iterations; }
+
+        const bool Converged() const
+        { return _converged; }
+
+        const IDistribution &Distribution() const
+        { return *_distribution; }
+
+        /// <summary>
+        /// The unscaled covariance of the coefficients, (Xᵀ * W * X)⁻¹ at the weights of the final iteration, stored
+        /// row-major. The weights of a robust fit (see <see cref="FitOptions::Robust"/>) are taken without their robust
+        /// factors. Empty if no iteration ran and no checkpoint was resumed.
+        /// </summary>
+        const std::vector<double> Covariance() const
+        { return _covariance; }
+
+        /// <summary>
+        /// The scale of the standardized Pearson residuals at the estimates of a robust fit, or NaN for a maximum
+        /// likelihood fit.
+        /// </summary>
+        const double Scale() const
+        { return _scale; }
+
+        /// <summary>
+        /// The dispersion that scales <see cref="Covariance"/> into the variance of the coefficients: one for a Poisson
+        /// response, Huber's correction for a robust fit (see <see cref="VarianceOls"/>), and otherwise the deviance per
+        /// degree of freedom, which for a Gaussian response is the mean squared error.
+        /// </summary>
+        const double Dispersion() const;
+
+        /// <summary>
+        /// The variance inflation factor of each coefficient, VIFⱼ = (Xᵀ * W * X)⁻¹ⱼⱼ * Sⱼⱼ at the weights of
+        /// <see cref="Covariance"/>, where Sⱼⱼ is the weighted sum of squares of column j about its mean when the first
+        /// column is the constant (see <see cref="DesignMatrix::HasConstant"/>), and about zero otherwise. The factor of
+        /// the constant itself is NaN. Empty if no iteration ran.
+        /// </summary>
+        /// <remarks>
+        /// VIFⱼ = 1 / (1 - Rⱼ²) for the auxiliary regression of column j on the others, but no auxiliary regression is
+        /// fitted: (Xᵀ * W * X)⁻¹ⱼⱼ is a diagonal element of <see cref="Covariance"/>, and Sⱼⱼ is the squared norm of row j
+        /// of the Cholesky factor, less its first element when centred, since the rest of the factor is the factor of
+        /// the Schur complement of the constant. Every factor together costs O(k²).
+        /// </remarks>
+        const std::vector<double> VarianceInflationFactors() const;
+
+        /// <summary>
+        /// The condition indices of the weighted design scaled to columns of unit length (Belsley, Kuh and Welsch,
+        /// 1980), ηⱼ = σ_max / σⱼ over its singular values, in ascending order. The last is the condition number;
+        /// indices above 30 indicate a near dependency among the columns. Empty if no iteration ran.
+        /// </summary>
+        /// <remarks>
+        /// The design is not read again: the Cholesky factor of Xᵀ * W * X with its rows normalized is a square root of
+        /// the scaled Gram matrix, so its singular values are those of the scaled design. They are found by one-sided
+        /// Jacobi rotations, which keep their relative accuracy however ill-conditioned the design.
+        /// </remarks>
+        const std::vector<double> ConditionIndices() const;
+
         const std::vector<double> StandardErrorsOls() const override;
 
         const std::vector<double> StandardErrorsHC0() const override;
 
         const std::vector<double> StandardErrorsHC1() const override;
 
+        /// <summary>
+        /// The dispersion times the diagonal of <see cref="Covariance"/>. For a robust fit, the dispersion is Huber's
+        /// correction for M-estimates, K² * s² * (Σ ψ(uᵢ)² / (n - p)) / (Σ ψ'(uᵢ) / n)² with standardized residuals
+        /// uᵢ and scale s.
+        /// </summary>
         const std::vector<double> VarianceOls() const override;
 
         const std::vector<double> VarianceHC0() const override;
 
         const std::vector<double> VarianceHC1() const override;
 
+        /// <summary>
+        /// Calculates the mean response for a single observation. Latency-critical callers should score through a
+        /// <see cref="CompiledScorer"/> built from <see cref="Snapshot"/> instead.
+        /// </summary>
         const double Evaluate(const std::vector<double> &observation) const override;
 
+        /// <summary>
+        /// Captures the link function and coefficients for scoring.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">
+        /// The link function has no <see cref="LinkKind"/>.
+        /// </exception>
+        ModelSnapshot Snapshot() const;
+
     private:
 
+        explicit GeneralizedLinearModel(std::unique_ptr<IDistribution> distribution);
+
+        void Fit(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, const FitOptions &options, const ValidityMask &valid);
+
+        /// <summary>
+        /// Sets the scale, dispersion and covariance of a robust fit from the residuals at its estimates.
+        /// </summary>
+        void FitRobustCovariance(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, const std::vector<double> &meanResponse, const IWeightFunction &robust, const FitOptions &options, const ValidityMask &valid);
+
+        /// <summary>
+        /// Factors the Gram matrix Xᵀ * W * X and sets the covariance from the factor.
+        /// </summary>
+        void Factorize(const std::vector<double> &gram, const FitOptions &options);
+
+        /// <summary>
+        /// Keeps a factor already computed by the solver and sets the covariance from it.
+        /// </summary>
+        void Factorize(std::vector<double> lower, std::vector<double> scale);
+
         std::unique_ptr<IDistribution> _distribution;
 
         unsigned long _observationCount;
 
         unsigned long _variableCount;
 
+        unsigned long _absorbedLevels;
+
         std::vector<double> _coefficients;
 
+        std::vector<double> _covariance;
+
+        /// <summary>
+        /// The lower Cholesky factor L of D * Xᵀ * W * X * D, stored row-major, where D is the equilibration scale, or
+        /// the identity if the fit was not equilibrated.
+        /// </summary>
+        std::vector<double> _factor;
+
+        /// <summary>
+        /// The diagonal of D.
+        /// </summary>
+        std::vector<double> _factorScale;
+
+        /// <summary>
+        /// True if the first column of the design is the constant.
+        /// </summary>
+        bool _hasConstant;
+
         double _sumSquaredErrors;
+
+        double _deviance;
+
+        double _scale;
+
+        /// <summary>
+        /// The dispersion of a robust fit, or NaN to estimate it from the deviance.
+        /// </summary>
+        double _dispersion;
+
+        unsigned long _iterations;
+
+        bool _converged;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,711 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "LinearMixedModel.h"
+#include "DecompositionCholesky.h"
+#include "SolverCholesky.h"
+#include "SparseCholesky.h"
+#include "WeightedGram.h"
+
+namespace RegressionModels {
+    namespace {
+        struct Term {
+            /// <summary>
+            /// The index of the term's first random effect.
+            /// </summary>
+            std::size_t Offset;
+
+            /// <summary>
+            /// The number of random effects per level.
+            /// </summary>
+            std::size_t Size;
+
+            std::size_t Levels;
+
+            /// <summary>
+            /// The index of the term's first parameter in θ.
+            /// </summary>
+            std::size_t ThetaOffset;
+        };
+
+        /// <summary>
+        /// The cross-products in Zᵀ * Z of the random effects of one level of a term with one level of a term.
+        /// </summary>
+        struct Block {
+            std::size_t RowTerm;
+
+            std::size_t ColumnTerm;
+
+            std::size_t Row;
+
+            std::size_t Column;
+
+            /// <summary>
+            /// The first of the block's values in the block storage, RowSize x ColumnSize row-major.
+            /// </summary>
+            std::size_t Offset;
+        };
+
+        /// <summary>
+        /// Fills the lower triangular template of a term from θ, column by column.
+        /// </summary>
+        std::vector<double> Template(const std::vector<double> &theta, const Term &term)
+        {
+            const std::size_t r = term.Size;
+
+            std::vector<double> result(r * r, 0.0);
+
+            std::size_t k = term.ThetaOffset;
+
+            for (std::size_t j = 0; j < r; j++) {
+                for (std::size_t i = j; i < r; i++) {
+                    result[i * r + j] = theta[k++];
+                }
+            }
+
+            return result;
+        }
+
+        /// <summary>
+        /// Returns Tᵀ * v for the r x r template T of a level block of v.
+        /// </summary>
+        void TransposedProduct(const std::vector<double> &t, const std::size_t r, const double *v, double *result)
+        {
+            for (std::size_t i = 0; i < r; i++) {
+                result[i] = 0.0;
+
+                for (std::size_t k = i; k < r; k++) {
+                    result[i] += t[k * r + i] * v[k];
+                }
+            }
+        }
+
+        /// <summary>
+        /// Minimizes a function by the Nelder-Mead simplex method.
+        /// </summary>
+        template<typename TFunction>
+        std::vector<double> NelderMead(const TFunction &function, const std::vector<double> &start, const double step, const unsigned long maxEvaluations, const double tolerance, const double parameterTolerance, unsigned long &evaluations)
+        {
+            const std::size_t d = start.size();
+
+            std::vector<std::vector<double>> simplex(d + 1, start);
+            std::vector<double> values(d + 1);
+
+            const auto evaluate = [&](const std::vector<double> &x) {
+                evaluations++;
+                return function(x);
+            };
+
+            for (std::size_t i = 0; i < d; i++) {
+                simplex[i + 1][i] += step;
+            }
+
+            for (std::size_t i = 0; i <= d; i++) {
+                values[i] = evaluate(simplex[i]);
+            }
+
+            std::vector<std::size_t> order(d + 1);
+
+            while (evaluations < maxEvaluations) {
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return values[a] < values[b]; });
+
+                std::vector<std::vector<double>> sortedSimplex(d + 1);
+                std::vector<double> sortedValues(d + 1);
+
+                for (std::size_t i = 0; i <= d; i++) {
+                    sortedSimplex[i] = std::move(simplex[order[i]]);
+                    sortedValues[i] = values[order[i]];
+                }
+
+                simplex = std::move(sortedSimplex);
+                values = std::move(sortedValues);
+
+                double size = 0.0;
+
+                for (std::size_t i = 1; i <= d; i++) {
+                    for (std::size_t j = 0; j < d; j++) {
+                        size = std::max(size, std::abs(simplex[i][j] - simplex[0][j]));
+                    }
+                }
+
+                if (values[d] - values[0] <= tolerance * (std::abs(values[0]) + tolerance) && size <= parameterTolerance) {
+                    break;
+                }
+
+                std::vector<double> centroid(d, 0.0);
+
+                for (std::size_t i = 0; i < d; i++) {
+                    for (std::size_t j = 0; j < d; j++) {
+                        centroid[j] += simplex[i][j] / static_cast<double>(d);
+                    }
+                }
+
+                const auto along = [&](const double factor) {
+                    std::vector<double> result(d);
+
+                    for (std::size_t j = 0; j < d; j++) {
+                        result[j] = centroid[j] + factor * (simplex[d][j] - centroid[j]);
+                    }
+
+                    return result;
+                };
+
+                std::vector<double> reflected = along(-1.0);
+                const double reflectedValue = evaluate(reflected);
+
+                if (reflectedValue < values[0]) {
+                    std::vector<double> expanded = along(-2.0);
+                    const double expandedValue = evaluate(expanded);
+
+                    if (expandedValue < reflectedValue) {
+                        simplex[d] = std::move(expanded);
+                        values[d] = expandedValue;
+                    }
+                    else {
+                        simplex[d] = std::move(reflected);
+                        values[d] = reflectedValue;
+                    }
+
+                    continue;
+                }
+
+                if (reflectedValue < values[d - 1]) {
+                    simplex[d] = std::move(reflected);
+                    values[d] = reflectedValue;
+                    continue;
+                }
+
+                const bool outside = reflectedValue < values[d];
+
+                std::vector<double> contracted = along(outside ? -0.5 : 0.5);
+                const double contractedValue = evaluate(contracted);
+
+                if (contractedValue < std::min(reflectedValue, values[d])) {
+                    simplex[d] = std::move(contracted);
+                    values[d] = contractedValue;
+                    continue;
+                }
+
+                for (std::size_t i = 1; i <= d; i++) {
+                    for (std::size_t j = 0; j < d; j++) {
+                        simplex[i][j] = simplex[0][j] + 0.5 * (simplex[i][j] - simplex[0][j]);
+                    }
+
+                    values[i] = evaluate(simplex[i]);
+                }
+            }
+
+            return simplex[std::min_element(values.begin(), values.end()) - values.begin()];
+        }
+    }
+
+    LinearMixedModel::LinearMixedModel(const DesignMatrix &design, const std::vector<double> &response, const std::vector<RandomEffect> &randomEffects, const MixedModelOptions &options)
+            : _observationCount(design.RowCount()),
+              _sumSquaredErrors(0),
+              _residualVariance(0),
+              _criterion(0),
+              _evaluations(0)
+    {
+        const std::size_t n = design.RowCount();
+        const std::size_t p = design.ColumnCount();
+
+        if (n != response.size() || n == 0) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+        if (design.IsMasked()) {
+            throw std::invalid_argument("Masked designs are not supported.");
+        }
+        if (randomEffects.empty()) {
+            throw std::invalid_argument("At least one random-effects term is required.");
+        }
+        if (n <= p) {
+            throw std::invalid_argument("Too few observations for the fixed effects.");
+        }
+
+        std::vector<Term> terms;
+        std::size_t q = 0;
+        std::size_t parameterCount = 0;
+
+        for (const RandomEffect &effect : randomEffects) {
+            if (effect.Grouping.RowCount() != n) {
+                throw std::out_of_range("Argument vectors differ in length.");
+            }
+
+            for (std::size_t column : effect.Slopes) {
+                if (column >= p) {
+                    throw std::out_of_range("A random slope names a column outside the design.");
+                }
+            }
+
+            const std::size_t r = (effect.Intercept ? 1 : 0) + effect.Slopes.size();
+
+            if (r == 0) {
+                throw std::invalid_argument("A random-effects term has neither an intercept nor slopes.");
+            }
+
+            terms.push_back(Term{q, r, effect.Grouping.LevelCount(), parameterCount});
+            _termSizes.push_back(r);
+
+            q += r * effect.Grouping.LevelCount();
+            parameterCount += r * (r + 1) / 2;
+        }
+
+        const std::size_t termCount = terms.size();
+
+        // The single pass over the rows. Diagonal blocks are indexed directly; the blocks that cross two terms are
+        // created as their pairs of levels occur.
+        std::vector<Block> blocks;
+        std::vector<double> storage;
+
+        for (std::size_t t = 0; t < termCount; t++) {
+            for (std::size_t a = 0; a < terms[t].Levels; a++) {
+                blocks.push_back(Block{t, t, terms[t].Offset + a * terms[t].Size, terms[t].Offset + a * terms[t].Size, storage.size()});
+                storage.resize(storage.size() + terms[t].Size * terms[t].Size, 0.0);
+            }
+        }
+
+        std::vector<std::size_t> diagonalBlocks(termCount, 0);
+
+        for (std::size_t t = 1; t < termCount; t++) {
+            diagonalBlocks[t] = diagonalBlocks[t - 1] + terms[t - 1].Levels;
+        }
+
+        std::vector<std::unordered_map<std::uint64_t, std::size_t>> crossBlocks(termCount * termCount);
+
+        std::vector<double> zty(q, 0.0);
+        std::vector<double> ztx(q * p, 0.0);
+        std::vector<double> xtx(p * p, 0.0);
+        std::vector<double> xty(p, 0.0);
+        double yty = 0.0;
+
+        std::vector<std::vector<double>> z(termCount);
+        std::vector<std::size_t> levels(termCount);
+        std::vector<double> scratch;
+
+        for (std::size_t t = 0; t < termCount; t++) {
+            z[t].resize(terms[t].Size);
+        }
+
+        for (std::size_t block = 0; block < n; block += DesignMatrix::BlockRows) {
+            const std::size_t count = std::min(DesignMatrix::BlockRows, n - block);
+            const double *rows = design.Rows(block, count, scratch);
+
+            for (std::size_t r = 0; r < count; r++) {
+                const double *x = rows + r * p;
+                const double y = response[block + r];
+
+                WeightedGram::AccumulateRow(x, p, 1.0, y, xtx.data(), xty.data());
+                yty += y * y;
+
+                for (std::size_t t = 0; t < termCount; t++) {
+                    const RandomEffect &effect = randomEffects[t];
+
+                    std::size_t k = 0;
+
+                    if (effect.Intercept) {
+                        z[t][k++] = 1.0;
+                    }
+                    for (std::size_t column : effect.Slopes) {
+                        z[t][k++] = x[column];
+                    }
+
+                    levels[t] = effect.Grouping[block + r];
+
+                    const std::size_t first = terms[t].Offset + levels[t] * terms[t].Size;
+
+                    for (std::size_t i = 0; i < terms[t].Size; i++) {
+                        zty[first + i] += z[t][i] * y;
+
+                        for (std::size_t j = 0; j < p; j++) {
+                            ztx[(first + i) * p + j] += z[t][i] * x[j];
+                        }
+                    }
+                }
+
+                for (std::size_t t = 0; t < termCount; t++) {
+                    for (std::size_t u = t; u < termCount; u++) {
+                        std::size_t index;
+
+                        if (u == t) {
+                            index = diagonalBlocks[t] + levels[t];
+                        }
+                        else {
+                            const std::uint64_t key = static_cast<std::uint64_t>(levels[t]) * terms[u].Levels + levels[u];
+                            const auto inserted = crossBlocks[t * termCount + u].emplace(key, blocks.size());
+
+                            if (inserted.second) {
+                                blocks.push_back(Block{t, u, terms[t].Offset + levels[t] * terms[t].Size, terms[u].Offset + levels[u] * terms[u].Size, storage.size()});
+                                storage.resize(storage.size() + terms[t].Size * terms[u].Size, 0.0);
+                            }
+
+                            index = inserted.first->second;
+                        }
+
+                        double *values = &storage[blocks[index].Offset];
+
+                        for (std::size_t i = 0; i < terms[t].Size; i++) {
+                            for (std::size_t j = 0; j < terms[u].Size; j++) {
+                                values[i * terms[u].Size + j] += z[t][i] * z[u][j];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        for (std::size_t a = 0; a < p; a++) {
+            for (std::size_t b = 0; b < a; b++) {
+                xtx[a * p + b] = xtx[b * p + a];
+            }
+        }
+
+        // The upper triangle of Λᵀ * Zᵀ * Z * Λ + I, whose pattern is that of the blocks whatever θ.
+        struct Entry {
+            std::size_t Row;
+
+            std::size_t Column;
+
+            /// <summary>
+            /// The position of the entry's value in the block products.
+            /// </summary>
+            std::size_t Source;
+        };
+
+        std::vector<Entry> entries;
+
+        for (const Block &b : blocks) {
+            const std::size_t rows = terms[b.RowTerm].Size;
+            const std::size_t columns = terms[b.ColumnTerm].Size;
+
+            for (std::size_t i = 0; i < rows; i++) {
+                for (std::size_t j = b.RowTerm == b.ColumnTerm ? i : 0; j < columns; j++) {
+                    entries.push_back(Entry{b.Row + i, b.Column + j, b.Offset + i * columns + j});
+                }
+            }
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.Column < b.Column || (a.Column == b.Column && a.Row < b.Row); });
+
+        SparseMatrix pattern;
+        pattern.Dimension = q;
+        pattern.ColumnStarts.assign(q + 1, 0);
+        pattern.RowIndices.reserve(entries.size());
+
+        for (const Entry &entry : entries) {
+            pattern.ColumnStarts[entry.Column + 1]++;
+            pattern.RowIndices.push_back(entry.Row);
+        }
+
+        for (std::size_t j = 0; j < q; j++) {
+            pattern.ColumnStarts[j + 1] += pattern.ColumnStarts[j];
+        }
+
+        SparseCholesky factor(pattern);
+
+        std::vector<double> products(storage.size());
+        std::vector<double> values(entries.size());
+        std::vector<double> scaledZty(q);
+        std::vector<std::vector<double>> scaledZtx(p, std::vector<double>(q));
+
+        // Evaluation state kept for the estimates at the optimum.
+        std::vector<double> cu;
+        std::vector<std::vector<double>> rzx(p);
+        std::vector<double> fixedGram(p * p);
+        std::vector<double> beta;
+        double pwrss = 0.0;
+
+        const auto criterion = [&](const std::vector<double> &theta) -> double {
+            std::vector<std::vector<double>> templates(termCount);
+
+            for (std::size_t t = 0; t < termCount; t++) {
+                templates[t] = Template(theta, terms[t]);
+            }
+
+            // Tₜᵀ * G * Tᵤ for each block G.
+            for (const Block &b : blocks) {
+                const std::size_t rows = terms[b.RowTerm].Size;
+                const std::size_t columns = terms[b.ColumnTerm].Size;
+                const std::vector<double> &left = templates[b.RowTerm];
+                const std::vector<double> &right = templates[b.ColumnTerm];
+
+                std::vector<double> product(rows * columns, 0.0);
+
+                for (std::size_t i = 0; i < rows; i++) {
+                    for (std::size_t j = 0; j < columns; j++) {
+                        for (std::size_t k = j; k < columns; k++) {
+                            product[i * columns + j] += storage[b.Offset + i * columns + k] * right[k * columns + j];
+                        }
+                    }
+                }
+
+                for (std::size_t i = 0; i < rows; i++) {
+                    for (std::size_t j = 0; j < columns; j++) {
+                        double sum = 0.0;
+
+                        for (std::size_t k = i; k < rows; k++) {
+                            sum += left[k * rows + i] * product[k * columns + j];
+                        }
+
+                        products[b.Offset + i * columns + j] = sum;
+                    }
+                }
+            }
+
+            for (std::size_t e = 0; e < entries.size(); e++) {
+                values[e] = products[entries[e].Source] + (entries[e].Row == entries[e].Column ? 1.0 : 0.0);
+            }
+
+            factor.Factorize(values);
+
+            for (std::size_t t = 0; t < termCount; t++) {
+                const std::size_t r = terms[t].Size;
+
+                for (std::size_t a = 0; a < terms[t].Levels; a++) {
+                    const std::size_t first = terms[t].Offset + a * r;
+
+                    TransposedProduct(templates[t], r, &zty[first], &scaledZty[first]);
+
+                    for (std::size_t j = 0; j < p; j++) {
+                        std::vector<double> column(r);
+
+                        for (std::size_t i = 0; i < r; i++) {
+                            column[i] = ztx[(first + i) * p + j];
+                        }
+
+                        TransposedProduct(templates[t], r, column.data(), &scaledZtx[j][first]);
+                    }
+                }
+            }
+
+            // cu = L⁻¹ * P * Λᵀ * Zᵀ * y and R_ZX = L⁻¹ * P * Λᵀ * Zᵀ * X.
+            cu = factor.ForwardSolve(scaledZty);
+
+            for (std::size_t j = 0; j < p; j++) {
+                rzx[j] = factor.ForwardSolve(scaledZtx[j]);
+            }
+
+            // R_Xᵀ * R_X = Xᵀ * X - R_ZXᵀ * R_ZX.
+            std::vector<double> moment(xty);
+
+            for (std::size_t a = 0; a < p; a++) {
+                for (std::size_t b = 0; b < p; b++) {
+                    fixedGram[a * p + b] = xtx[a * p + b] - std::inner_product(rzx[a].begin(), rzx[a].end(), rzx[b].begin(), 0.0);
+                }
+
+                moment[a] -= std::inner_product(rzx[a].begin(), rzx[a].end(), cu.begin(), 0.0);
+            }
+
+            const std::vector<double> lower = decompositionCholesky(fixedGram, p);
+
+            beta = solverCholesky(lower, moment);
+
+            pwrss = yty - std::inner_product(cu.begin(), cu.end(), cu.begin(), 0.0) - std::inner_product(moment.begin(), moment.end(), beta.begin(), 0.0);
+
+            double logDeterminant = factor.LogDeterminant();
+
+            for (std::size_t i = 0; i < p; i++) {
+                logDeterminant += 2.0 * std::log(lower[i * p + i]);
+            }
+
+            const double degrees = static_cast<double>(n - p);
+
+            return logDeterminant + degrees * (1.0 + std::log(2.0 * M_PI * pwrss / degrees));
+        };
+
+        std::vector<double> start(parameterCount, 0.0);
+
+        for (const Term &term : terms) {
+            std::size_t k = term.ThetaOffset;
+
+            for (std::size_t j = 0; j < term.Size; j++) {
+                start[k] = 1.0;
+                k += term.Size - j;
+            }
+        }
+
+        _theta = NelderMead(criterion, start, 0.25, options.MaxEvaluations, options.Tolerance, options.ParameterTolerance, _evaluations);
+
+        // The criterion depends on each template only through Tₜ * Tₜᵀ; report templates with non-negative diagonals.
+        for (const Term &term : terms) {
+            std::size_t k = term.ThetaOffset;
+
+            for (std::size_t j = 0; j < term.Size; j++) {
+                if (_theta[k] < 0.0) {
+                    for (std::size_t i = j; i < term.Size; i++) {
+                        _theta[k + i - j] = -_theta[k + i - j];
+                    }
+                }
+
+                k += term.Size - j;
+            }
+        }
+
+        _criterion = criterion(_theta);
+        _coefficients = beta;
+        _residualVariance = pwrss / static_cast<double>(n - p);
+        _distribution = std::make_unique<Distributions::GaussianDistribution>(0.0, std::sqrt(_residualVariance));
+
+        // Var(β) = σ² * (R_Xᵀ * R_X)⁻¹.
+        const std::vector<double> lower = decompositionCholesky(fixedGram, p);
+
+        _variance.resize(p);
+
+        for (std::size_t j = 0; j < p; j++) {
+            std::vector<double> unit(p, 0.0);
+            unit[j] = 1.0;
+
+            _variance[j] = _residualVariance * solverCholesky(lower, unit)[j];
+        }
+
+        // b = Λ * u with u = Pᵀ * L⁻ᵀ * (cu - R_ZX * β).
+        std::vector<double> residual(cu);
+
+        for (std::size_t j = 0; j < p; j++) {
+            for (std::size_t i = 0; i < q; i++) {
+                residual[i] -= rzx[j][i] * beta[j];
+            }
+        }
+
+        const std::vector<double> u = factor.BackwardSolve(residual);
+
+        for (std::size_t t = 0; t < termCount; t++) {
+            const std::size_t r = terms[t].Size;
+            const std::vector<double> templateT = Template(_theta, terms[t]);
+
+            std::vector<double> effects(terms[t].Levels * r, 0.0);
+
+            for (std::size_t a = 0; a < terms[t].Levels; a++) {
+                for (std::size_t i = 0; i < r; i++) {
+                    for (std::size_t k = 0; k <= i; k++) {
+                        effects[a * r + i] += templateT[i * r + k] * u[terms[t].Offset + a * r + k];
+                    }
+                }
+            }
+
+            _randomEffects.push_back(std::move(effects));
+        }
+
+        // The conditional residuals, in a second pass.
+        std::vector<double> fitted(n);
+
+        for (std::size_t block = 0; block < n; block += DesignMatrix::BlockRows) {
+            const std::size_t count = std::min(DesignMatrix::BlockRows, n - block);
+            const double *rows = design.Rows(block, count, scratch);
+
+            for (std::size_t r = 0; r < count; r++) {
+                const double *x = rows + r * p;
+
+                double value = std::inner_product(x, x + p, _coefficients.begin(), 0.0);
+
+                for (std::size_t t = 0; t < termCount; t++) {
+                    const RandomEffect &effect = randomEffects[t];
+                    const double *b = &_randomEffects[t][effect.Grouping[block + r] * terms[t].Size];
+
+                    std::size_t k = 0;
+
+                    if (effect.Intercept) {
+                        value += b[k++];
+                    }
+                    for (std::size_t column : effect.Slopes) {
+                        value += b[k++] * x[column];
+                    }
+                }
+
+                fitted[block + r] = value;
+            }
+        }
+
+        _sumSquaredErrors = _distribution->Deviance(response, _distribution->Fit(fitted), std::vector<double>(n, 1.0), 1.0);
+    }
+
+    const std::vector<double> LinearMixedModel::RandomEffectCovariance(const std::size_t term) const
+    {
+        if (term >= _termSizes.size()) {
+            throw std::out_of_range("The term index is out of range.");
+        }
+
+        const std::size_t r = _termSizes[term];
+
+        std::size_t offset = 0;
+
+        for (std::size_t t = 0; t < term; t++) {
+            offset += _termSizes[t] * (_termSizes[t] + 1) / 2;
+        }
+
+        const std::vector<double> templateT = Template(_theta, Term{0, r, 0, offset});
+
+        std::vector<double> result(r * r, 0.0);
+
+        for (std::size_t i = 0; i < r; i++) {
+            for (std::size_t j = 0; j < r; j++) {
+                for (std::size_t k = 0; k <= std::min(i, j); k++) {
+                    result[i * r + j] += _residualVariance * templateT[i * r + k] * templateT[j * r + k];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    const std::vector<double> LinearMixedModel::RandomEffects(const std::size_t term) const
+    {
+        if (term >= _randomEffects.size()) {
+            throw std::out_of_range("The term index is out of range.");
+        }
+
+        return _randomEffects[term];
+    }
+
+    const std::vector<double> LinearMixedModel::StandardErrorsOls() const
+    {
+        std::vector<double> result = VarianceOls();
+
+        for (double &value : result) {
+            value = std::sqrt(value);
+        }
+
+        return result;
+    }
+
+    const std::vector<double> LinearMixedModel::StandardErrorsHC0() const
+    {
+        return std::vector<double>();
+    }
+
+    const std::vector<double> LinearMixedModel::StandardErrorsHC1() const
+    {
+        return std::vector<double>();
+    }
+
+    const std::vector<double> LinearMixedModel::VarianceOls() const
+    {
+        return _variance;
+    }
+
+    const std::vector<double> LinearMixedModel::VarianceHC0() const
+    {
+        return std::vector<double>();
+    }
+
+    const std::vector<double> LinearMixedModel::VarianceHC1() const
+    {
+        return std::vector<double>();
+    }
+
+    const double LinearMixedModel::Evaluate(const std::vector<double> &observation) const
+    {
+        if (observation.size() != _coefficients.size()) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        const double linearResponse = std::inner_product(_coefficients.begin(), _coefficients.end(), observation.begin(), 0.0);
+
+        return _distribution->LinkFunction().Inverse(std::vector<double>{linearResponse})[0];
+    }
+}
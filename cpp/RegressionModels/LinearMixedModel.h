@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "CategoricalColumn.h"
+#include "DesignMatrix.h"
+#include "GaussianDistribution.h"
+#include "IRegressionModel.h"
+
+namespace RegressionModels {
+
+    /// <summary>
+    /// A random-effects term: coefficients that vary across the levels of a grouping variable.
+    /// </summary>
+    struct RandomEffect {
+        /// <summary>
+        /// The grouping variable.
+        /// </summary>
+        CategoricalColumn Grouping;
+
+        /// <summary>
+        /// True to include a random intercept.
+        /// </summary>
+        bool Intercept = true;
+
+        /// <summary>
+        /// The columns of the design whose slopes vary across groups.
+        /// </summary>
+        std::vector<std::size_t> Slopes;
+    };
+
+    /// <summary>
+    /// Controls the optimization of the restricted likelihood of a <see cref="LinearMixedModel"/>.
+    /// </summary>
+    struct MixedModelOptions {
+        /// <summary>
+        /// The maximum number of evaluations of the profiled criterion.
+        /// </summary>
+        unsigned long MaxEvaluations = 10000;
+
+        /// <summary>
+        /// The change in the criterion across the simplex below which the optimization may stop.
+        /// </summary>
+        double Tolerance = 1e-10;
+
+        /// <summary>
+        /// The width of the simplex in θ below which the optimization may stop. Both tolerances must be met.
+        /// </summary>
+        double ParameterTolerance = 1e-8;
+    };
+
+    /// <summary>
+    /// A linear mixed model y = X * β + Z * b + e, with b ~ N(0, σ² * Λ * Λᵀ) and e ~ N(0, σ²), fitted by restricted
+    /// maximum likelihood (REML).
+    /// </summary>
+    /// <remarks>
+    /// The model follows the formulation of lme4 (Bates et al., 2015). The relative covariance factor Λ(θ) holds, for
+    /// each term, one lower triangular template per level. For a given θ, the sparse Cholesky factor of
+    /// Λᵀ * Zᵀ * Z * Λ + I and a small dense factor for the fixed effects give the REML criterion with β and σ² profiled
+    /// out. A Nelder-Mead search over θ minimizes it.
+    ///
+    /// The data are read once, to form Zᵀ * Z, Zᵀ * X, Zᵀ * y and the fixed-effects cross-products, so each
+    /// evaluation costs time in the number of random effects rather than observations. The pattern of the sparse
+    /// system does not depend on θ: a <see cref="SparseCholesky"/> orders and analyses it once, and each evaluation
+    /// only refactors it numerically. Crossed terms (such as firm and year) fill in, and the ordering keeps that fill
+    /// small.
+    /// </remarks>
+    class LinearMixedModel : public IRegressionModel {
+    public:
+
+        /// <param name="design">
+        /// The fixed-effects design, including a constant column if one is wanted.
+        /// </param>
+        /// <param name="response">
+        /// The response values.
+        /// </param>
+        /// <param name="randomEffects">
+        /// The random-effects terms.
+        /// </param>
+        /// <param name="options">
+        /// The optimization options.
+        /// </param>
+        /// <exception cref="std::invalid_argument">
+        /// The design is masked (see <see cref="DesignMatrix::SetMask"/>).
+        /// </exception>
+        LinearMixedModel(
+                const DesignMatrix &design,
+                const std::vector<double> &response,
+                const std::vector<RandomEffect> &randomEffects,
+                const MixedModelOptions &options = MixedModelOptions());
+
+        const unsigned long ObservationCount() const override
+        { return _observationCount; }
+
+        const unsigned long VariableCount() const override
+        { return _coefficients.size(); }
+
+        const long DegreesOfFreedom() const override
+        { return static_cast<long>(_observationCount) - static_cast<long>(_coefficients.size()); }
+
+        /// <summary>
+        /// The fixed-effects coefficients β.
+        /// </summary>
+        const std::vector<double> Coefficients() const override
+        { return _coefficients; }
+
+        /// <summary>
+        /// The sum of squared residuals given the predicted random effects.
+        /// </summary>
+        const double SumSquaredErrors() const override
+        { return _sumSquaredErrors; }
+
+        const double MeanSquaredError() const override
+        { return _sumSquaredErrors / DegreesOfFreedom(); }
+
+        const double RootMeanSquaredError() const override
+        { return sqrt(MeanSquaredError()); }
+
+        /// <summary>
+        /// The REML criterion, -2 times the restricted log-likelihood, at the estimates.
+        /// </summary>
+        const double Criterion() const
+        { return _criterion; }
+
+        /// <summary>
+        /// The covariance parameters: the lower triangle of each term's template, column by column.
+        /// </summary>
+        const std::vector<double> Theta() const
+        { return _theta; }
+
+        /// <summary>
+        /// The number of evaluations of the profiled criterion.
+        /// </summary>
+        const unsigned long Evaluations() const
+        { return _evaluations; }
+
+        /// <summary>
+        /// The estimated residual variance σ².
+        /// </summary>
+        const double ResidualVariance() const
+        { return _residualVariance; }
+
+        /// <summary>
+        /// The estimated covariance of the random effects of a term, stored row-major (intercept first).
+        /// </summary>
+        const std::vector<double> RandomEffectCovariance(std::size_t term) const;
+
+        /// <summary>
+        /// The predicted random effects (conditional modes) of a term, one row per level, stored row-major.
+        /// </summary>
+        const std::vector<double> RandomEffects(std::size_t term) const;
+
+        /// <summary>
+        /// The residual distribution: Gaussian with the identity link and standard deviation σ.
+        /// </summary>
+        const Distributions::GaussianDistribution &Distribution() const
+        { return *_distribution; }
+
+        const std::vector<double> StandardErrorsOls() const override;
+
+        const std::vector<double> StandardErrorsHC0() const override;
+
+        const std::vector<double> StandardErrorsHC1() const override;
+
+        /// <summary>
+        /// The variances of the fixed-effects coefficients, σ² * (Xᵀ * V⁻¹ * X)⁻¹ with V = Z * Λ * Λᵀ * Zᵀ + I.
+        /// </summary>
+        const std::vector<double> VarianceOls() const override;
+
+        const std::vector<double> VarianceHC0() const override;
+
+        const std::vector<double> VarianceHC1() const override;
+
+        /// <summary>
+        /// Calculates the population-level mean response xᵀ * β for an observation.
+        /// </summary>
+        const double Evaluate(const std::vector<double> &observation) const override;
+
+    private:
+
+        std::unique_ptr<Distributions::GaussianDistribution> _distribution;
+
+        unsigned long _observationCount;
+
+        std::vector<double> _coefficients;
+
+        std::vector<double> _variance;
+
+        std::vector<double> _theta;
+
+        /// <summary>
+        /// The size of each term's template.
+        /// </summary>
+        std::vector<std::size_t> _termSizes;
+
+        std::vector<std::vector<double>> _randomEffects;
+
+        double _sumSquaredErrors;
+
+        double _residualVariance;
+
+        double _criterion;
+
+        unsigned long _evaluations;
+    };
+}
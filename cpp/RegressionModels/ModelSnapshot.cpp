@@ -0,0 +1,100 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include "Kernels.h"
+#include "ModelSnapshot.h"
+
+namespace RegressionModels {
+
+    namespace {
+        const char Magic[4] = {'A', 'D', 'M', 'S'};
+
+        const std::uint32_t FormatVersion = 1;
+    }
+
+    ModelSnapshot::ModelSnapshot(const LinkKind link, std::vector<double> coefficients)
+            : _link(link),
+              _coefficients(std::move(coefficients))
+    {
+        if (_link != LinkKind::Identity && _link != LinkKind::Log) {
+            throw std::invalid_argument("Unknown link function.");
+        }
+    }
+
+    ModelSnapshot ModelSnapshot::Load(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+
+        if (!file) {
+            throw std::runtime_error("Unable to open " + path + ".");
+        }
+
+        char magic[4];
+        std::uint32_t version = 0;
+        std::uint32_t link = 0;
+        std::uint64_t count = 0;
+
+        file.read(magic, sizeof(magic));
+        file.read(reinterpret_cast<char *>(&version), sizeof(version));
+        file.read(reinterpret_cast<char *>(&link), sizeof(link));
+        file.read(reinterpret_cast<char *>(&count), sizeof(count));
+
+        if (!file || std::memcmp(magic, Magic, sizeof(Magic)) != 0 || version != FormatVersion) {
+            throw std::runtime_error(path + " is not a model snapshot.");
+        }
+
+        // A corrupt header must not drive the allocation below or reach the constructor's invalid_argument.
+        if (count > (1u << 24) || (link != static_cast<std::uint32_t>(LinkKind::Identity) && link != static_cast<std::uint32_t>(LinkKind::Log))) {
+            throw std::runtime_error(path + " is corrupt.");
+        }
+
+        std::vector<double> coefficients(count);
+
+        file.read(reinterpret_cast<char *>(coefficients.data()), static_cast<std::streamsize>(count * sizeof(double)));
+
+        if (!file) {
+            throw std::runtime_error(path + " is truncated.");
+        }
+
+        return ModelSnapshot(static_cast<LinkKind>(link), std::move(coefficients));
+    }
+
+    void ModelSnapshot::Save(const std::string &path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+        const auto link = static_cast<std::uint32_t>(_link);
+        const auto count = static_cast<std::uint64_t>(_coefficients.size());
+
+        file.write(Magic, sizeof(Magic));
+        file.write(reinterpret_cast<const char *>(&FormatVersion), sizeof(FormatVersion));
+        file.write(reinterpret_cast<const char *>(&link), sizeof(link));
+        file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char *>(_coefficients.data()), static_cast<std::streamsize>(count * sizeof(double)));
+
+        if (!file) {
+            throw std::runtime_error("Unable to write " + path + ".");
+        }
+    }
+
+    const double ModelSnapshot::Predict(const double *observation) const
+    {
+        double result;
+
+        Predict(observation, 1, &result);
+
+        return result;
+    }
+
+    void ModelSnapshot::Predict(const double *observations, const std::size_t count, double *result) const
+    {
+        const Kernels::KernelTable &kernels = Kernels::Active();
+
+        kernels.MultiplyRows(observations, count, _coefficients.size(), _coefficients.data(), result);
+
+        if (_link == LinkKind::Log) {
+            kernels.Exponentiate(result, count, result);
+        }
+    }
+}
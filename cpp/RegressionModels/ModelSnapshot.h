@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace RegressionModels {
+
+    /// <summary>
+    /// Identifies the link function of a fitted model in a form that can be stored and evaluated without a
+    /// distribution object.
+    /// </summary>
+    enum class LinkKind : std::uint32_t {
+        Identity = 0,
+
+        Log = 1
+    };
+
+    /// <summary>
+    /// An immutable record of a fitted model: its link function and coefficients. Snapshots are what scoring
+    /// processes load, so they carry nothing that depends on the data the model was fitted on.
+    /// </summary>
+    class ModelSnapshot {
+    public:
+
+        ModelSnapshot(LinkKind link, std::vector<double> coefficients);
+
+        /// <summary>
+        /// Reads a snapshot written by <see cref="Save"/>.
+        /// </summary>
+        /// <exception cref="std::runtime_error">
+        /// The file cannot be read, is not a snapshot, or is truncated or corrupt.
+        /// </exception>
+        static ModelSnapshot Load(const std::string &path);
+
+        /// <summary>
+        /// Writes the snapshot in a compact binary format in native byte order.
+        /// </summary>
+        void Save(const std::string &path) const;
+
+        const LinkKind Link() const
+        { return _link; }
+
+        const std::vector<double> &Coefficients() const
+        { return _coefficients; }
+
+        const std::size_t VariableCount() const
+        { return _coefficients.size(); }
+
+        /// <summary>
+        /// Calculates the mean response for a single observation.
+        /// </summary>
+        const double Predict(const double *observation) const;
+
+        /// <summary>
+        /// Calculates the mean responses for a block of observations stored row-major.
+        /// </summary>
+        /// <param name="observations">
+        /// The observations, <see cref="VariableCount"/> values per row.
+        /// </param>
+        /// <param name="count">
+        /// The number of observations.
+        /// </param>
+        /// <param name="result">
+        /// Receives one mean response per observation.
+        /// </param>
+        void Predict(const double *observations, std::size_t count, double *result) const;
+
+    private:
+
+        LinkKind _link;
+
+        std::vector<double> _coefficients;
+    };
+}
@@ -0,0 +1,412 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include "PanelLinearModel.h"
+#include "DecompositionCholesky.h"
+#include "Equilibration.h"
+#include "SolverCholesky.h"
+#include "ValidityMask.h"
+#include "WeightedGram.h"
+
+namespace RegressionModels {
+    namespace {
+        struct LeastSquares {
+            std::vector<double> Coefficients;
+
+            /// <summary>
+            /// The inverse of the Gram matrix, stored row-major.
+            /// </summary>
+            std::vector<double> Inverse;
+
+            double SumSquaredErrors;
+        };
+
+        /// <summary>
+        /// Solves the normal equations of the variables [first, p) of a p x p Gram matrix.
+        /// </summary>
+        LeastSquares Regress(const std::vector<double> &gram, const std::vector<double> &moment, const double yy, const std::size_t first)
+        {
+            const std::size_t p = moment.size();
+            const std::size_t n = p - first;
+
+            std::vector<double> a(n * n);
+            std::vector<double> b(n);
+
+            for (std::size_t i = 0; i < n; i++) {
+                for (std::size_t j = 0; j < n; j++) {
+                    a[i * n + j] = gram[(first + i) * p + first + j];
+                }
+
+                b[i] = moment[first + i];
+            }
+
+            const Equilibration equilibration(a, n);
+            const std::vector<double> lower = decompositionCholesky(equilibration.ApplyToMatrix(a), n);
+
+            LeastSquares result;
+            result.Coefficients = equilibration.ApplyToVector(solverCholesky(lower, equilibration.ApplyToVector(b)));
+            result.Inverse.assign(n * n, 0.0);
+
+            std::vector<double> unit(n, 0.0);
+
+            for (std::size_t j = 0; j < n; j++) {
+                unit[j] = 1.0;
+
+                const std::vector<double> column = solverCholesky(lower, unit);
+
+                for (std::size_t i = 0; i < n; i++) {
+                    result.Inverse[i * n + j] = column[i];
+                }
+
+                unit[j] = 0.0;
+            }
+
+            result.Inverse = equilibration.ApplyToMatrix(result.Inverse);
+
+            result.SumSquaredErrors = yy;
+
+            for (std::size_t i = 0; i < n; i++) {
+                result.SumSquaredErrors -= b[i] * result.Coefficients[i];
+            }
+
+            result.SumSquaredErrors = std::max(result.SumSquaredErrors, 0.0);
+
+            return result;
+        }
+    }
+
+    PanelLinearModel::PanelLinearModel(const DesignMatrix &design, const std::vector<double> &response, const std::vector<long> &entities, const PanelEstimator estimator)
+            : _estimator(estimator),
+              _sumSquaredErrors(0),
+              _idiosyncraticVariance(std::numeric_limits<double>::quiet_NaN()),
+              _entityVariance(std::numeric_limits<double>::quiet_NaN())
+    {
+        const std::size_t n = design.RowCount();
+        const std::size_t k = design.ColumnCount();
+        const std::size_t p = k + 1;
+
+        if (n != response.size() || n != entities.size() || n == 0) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        // Rows masked out of the design belong to no entity.
+        const ValidityMask valid = design.IsMasked() ? design.Mask() : ValidityMask(n);
+        const std::size_t observations = valid.ValidCount();
+
+        if (observations == 0) {
+            throw std::invalid_argument("No observation is valid.");
+        }
+
+        std::unordered_map<long, std::size_t> labels;
+        std::vector<std::size_t> index(n);
+        std::size_t first = n;
+
+        for (std::size_t i = 0; i < n; i++) {
+            if (valid[i]) {
+                index[i] = labels.emplace(entities[i], labels.size()).first->second;
+                first = std::min(first, i);
+            }
+        }
+
+        const std::size_t m = labels.size();
+
+        _observationCount = observations;
+        _entityCount = m;
+
+        // The single pass: the cross-products of z = (1, x - x₀) with itself and with y - y₀, and the sums of z and
+        // y - y₀ per entity, where (x₀, y₀) is the first valid observation.
+        std::vector<double> shift(p, 0.0);
+        const double responseShift = response[first];
+
+        for (std::size_t j = 0; j < k; j++) {
+            shift[1 + j] = design(first, j);
+        }
+
+        std::vector<double> gram(p * p, 0.0);
+        std::vector<double> moment(p, 0.0);
+        double yy = 0.0;
+
+        std::vector<double> entityZ(m * p, 0.0);
+        std::vector<double> entityY(m, 0.0);
+
+        std::vector<double> scratch;
+        std::vector<double> z(p, 1.0);
+
+        for (std::size_t block = 0; block < n; block += DesignMatrix::BlockRows) {
+            const std::size_t count = std::min(DesignMatrix::BlockRows, n - block);
+
+            if (valid.CountValid(block, count) == 0) {
+                continue;
+            }
+
+            const double *x = design.Rows(block, count, scratch);
+
+            for (std::size_t r = 0; r < count; r++) {
+                if (!valid[block + r]) {
+                    continue;
+                }
+
+                const std::size_t entity = index[block + r];
+                const double y = response[block + r] - responseShift;
+
+                for (std::size_t j = 0; j < k; j++) {
+                    z[1 + j] = x[r * k + j] - shift[1 + j];
+                }
+
+                WeightedGram::AccumulateRow(z.data(), p, 1.0, y, gram.data(), moment.data());
+                yy += y * y;
+
+                for (std::size_t j = 0; j < p; j++) {
+                    entityZ[entity * p + j] += z[j];
+                }
+
+                entityY[entity] += y;
+            }
+        }
+
+        for (std::size_t a = 0; a < p; a++) {
+            for (std::size_t b = 0; b < a; b++) {
+                gram[a * p + b] = gram[b * p + a];
+            }
+        }
+
+        // Forms base * Σ z zᵀ - Σᵢ cᵢ * sᵢ sᵢᵀ, where sᵢ are the sums of entity i; likewise for z y and y².
+        std::vector<double> transformedGram(p * p);
+        std::vector<double> transformedMoment(p);
+        double transformedYy;
+
+        const auto transform = [&](const double base, const std::vector<double> &c) {
+            for (std::size_t i = 0; i < p * p; i++) {
+                transformedGram[i] = base * gram[i];
+            }
+            for (std::size_t i = 0; i < p; i++) {
+                transformedMoment[i] = base * moment[i];
+            }
+
+            transformedYy = base * yy;
+
+            for (std::size_t e = 0; e < m; e++) {
+                const double *s = &entityZ[e * p];
+
+                for (std::size_t a = 0; a < p; a++) {
+                    for (std::size_t b = 0; b < p; b++) {
+                        transformedGram[a * p + b] -= c[e] * s[a] * s[b];
+                    }
+
+                    transformedMoment[a] -= c[e] * s[a] * entityY[e];
+                }
+
+                transformedYy -= c[e] * entityY[e] * entityY[e];
+            }
+        };
+
+        const long withinDegrees = static_cast<long>(observations) - static_cast<long>(m) - static_cast<long>(k);
+        const long betweenDegrees = static_cast<long>(m) - static_cast<long>(p);
+
+        std::vector<double> c(m);
+
+        LeastSquares within;
+        LeastSquares between;
+
+        if (withinDegrees > 0) {
+            // λ = 1: deviations from entity means. The constant column vanishes.
+            for (std::size_t e = 0; e < m; e++) {
+                c[e] = 1.0 / entityZ[e * p];
+            }
+
+            transform(1.0, c);
+            within = Regress(transformedGram, transformedMoment, transformedYy, 1);
+
+            _idiosyncraticVariance = within.SumSquaredErrors / withinDegrees;
+        }
+
+        if (betweenDegrees > 0) {
+            // One observation z̄ᵢ per entity: Σᵢ sᵢ sᵢᵀ / Tᵢ².
+            for (std::size_t e = 0; e < m; e++) {
+                c[e] = -1.0 / (entityZ[e * p] * entityZ[e * p]);
+            }
+
+            transform(0.0, c);
+            between = Regress(transformedGram, transformedMoment, transformedYy, 0);
+
+            if (withinDegrees > 0) {
+                double reciprocals = 0.0;
+
+                for (std::size_t e = 0; e < m; e++) {
+                    reciprocals += 1.0 / entityZ[e * p];
+                }
+
+                // The harmonic mean of the entity sizes stands in for T in unbalanced panels.
+                const double harmonicSize = static_cast<double>(m) / reciprocals;
+
+                _entityVariance = std::max(between.SumSquaredErrors / betweenDegrees - _idiosyncraticVariance / harmonicSize, 0.0);
+            }
+        }
+
+        // The coefficients and covariance in shifted space, (constant, slopes).
+        std::vector<double> coefficients(p);
+        std::vector<double> covariance(p * p);
+
+        switch (estimator) {
+            case PanelEstimator::Within: {
+                if (withinDegrees <= 0) {
+                    throw std::invalid_argument("Too few observations for the within estimator.");
+                }
+
+                // α = ȳ - x̄ᵀ * β, with Var(α) = σ²ₑ / NT + x̄ᵀ * V * x̄ and Cov(α, β) = -V * x̄.
+                const double total = static_cast<double>(observations);
+
+                std::vector<double> vx(k, 0.0);
+
+                coefficients[0] = moment[0] / total;
+
+                for (std::size_t i = 0; i < k; i++) {
+                    coefficients[1 + i] = within.Coefficients[i];
+                    coefficients[0] -= gram[1 + i] / total * within.Coefficients[i];
+
+                    for (std::size_t j = 0; j < k; j++) {
+                        covariance[(1 + i) * p + 1 + j] = _idiosyncraticVariance * within.Inverse[i * k + j];
+                        vx[i] += covariance[(1 + i) * p + 1 + j] * gram[1 + j] / total;
+                    }
+                }
+
+                covariance[0] = _idiosyncraticVariance / total;
+
+                for (std::size_t i = 0; i < k; i++) {
+                    covariance[0] += gram[1 + i] / total * vx[i];
+                    covariance[1 + i] = -vx[i];
+                    covariance[(1 + i) * p] = -vx[i];
+                }
+
+                _sumSquaredErrors = within.SumSquaredErrors;
+                _degreesOfFreedom = withinDegrees;
+                break;
+            }
+
+            case PanelEstimator::Between: {
+                if (betweenDegrees <= 0) {
+                    throw std::invalid_argument("Too few entities for the between estimator.");
+                }
+
+                coefficients = between.Coefficients;
+
+                for (std::size_t i = 0; i < p * p; i++) {
+                    covariance[i] = between.SumSquaredErrors / betweenDegrees * between.Inverse[i];
+                }
+
+                _sumSquaredErrors = between.SumSquaredErrors;
+                _degreesOfFreedom = betweenDegrees;
+                break;
+            }
+
+            case PanelEstimator::RandomEffects: {
+                if (withinDegrees <= 0 || betweenDegrees <= 0) {
+                    throw std::invalid_argument("Too few observations or entities for the random effects estimator.");
+                }
+
+                // θᵢ = 1 - √(σ²ₑ / (Tᵢ σ²ᵤ + σ²ₑ)), and λ = θ enters the cross-products as 2θ - θ² = 1 - (1 - θ)².
+                for (std::size_t e = 0; e < m; e++) {
+                    const double size = entityZ[e * p];
+                    const double retained = std::sqrt(_idiosyncraticVariance / (size * _entityVariance + _idiosyncraticVariance));
+
+                    c[e] = (1.0 - retained * retained) / size;
+                }
+
+                transform(1.0, c);
+                const LeastSquares quasi = Regress(transformedGram, transformedMoment, transformedYy, 0);
+
+                const long degrees = static_cast<long>(observations) - static_cast<long>(p);
+
+                coefficients = quasi.Coefficients;
+
+                for (std::size_t i = 0; i < p * p; i++) {
+                    covariance[i] = quasi.SumSquaredErrors / degrees * quasi.Inverse[i];
+                }
+
+                _sumSquaredErrors = quasi.SumSquaredErrors;
+                _degreesOfFreedom = degrees;
+                break;
+            }
+        }
+
+        // Undo the shift: α = α' + y₀ - x₀ᵀ * β, so Var(α) = dᵀ * C * d with d = (1, -x₀); the slopes are unchanged.
+        std::vector<double> direction(p, 1.0);
+
+        _coefficients = coefficients;
+        _coefficients[0] += responseShift;
+
+        for (std::size_t i = 1; i < p; i++) {
+            direction[i] = -shift[i];
+            _coefficients[0] -= shift[i] * coefficients[i];
+        }
+
+        double constantVariance = 0.0;
+
+        for (std::size_t i = 0; i < p; i++) {
+            for (std::size_t j = 0; j < p; j++) {
+                constantVariance += direction[i] * covariance[i * p + j] * direction[j];
+            }
+        }
+
+        _variance.resize(p);
+        _variance[0] = constantVariance;
+
+        for (std::size_t i = 1; i < p; i++) {
+            _variance[i] = covariance[i * p + i];
+        }
+    }
+
+    const std::vector<double> PanelLinearModel::StandardErrorsOls() const
+    {
+        std::vector<double> result = VarianceOls();
+
+        for (double &value : result) {
+            value = std::sqrt(value);
+        }
+
+        return result;
+    }
+
+    const std::vector<double> PanelLinearModel::StandardErrorsHC0() const
+    {
+        return std::vector<double>();
+    }
+
+    const std::vector<double> PanelLinearModel::StandardErrorsHC1() const
+    {
+        return std::vector<double>();
+    }
+
+    const std::vector<double> PanelLinearModel::VarianceOls() const
+    {
+        return _variance;
+    }
+
+    const std::vector<double> PanelLinearModel::VarianceHC0() const
+    {
+        return std::vector<double>();
+    }
+
+    const std::vector<double> PanelLinearModel::VarianceHC1() const
+    {
+        return std::vector<double>();
+    }
+
+    const double PanelLinearModel::Evaluate(const std::vector<double> &observation) const
+    {
+        if (observation.size() + 1 != _coefficients.size()) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        double result = _coefficients[0];
+
+        for (std::size_t i = 0; i < observation.size(); i++) {
+            result += _coefficients[1 + i] * observation[i];
+        }
+
+        return result;
+    }
+}
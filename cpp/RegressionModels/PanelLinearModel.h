@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include "DesignMatrix.h"
+#include "IRegressionModel.h"
+
+namespace RegressionModels {
+
+    /// <summary>
+    /// The estimators of a <see cref="PanelLinearModel"/>.
+    /// </summary>
+    enum class PanelEstimator {
+        /// <summary>
+        /// The fixed effects (within) estimator: least squares on deviations from entity means.
+        /// </summary>
+        Within,
+
+        /// <summary>
+        /// The between estimator: least squares on entity means, one observation per entity.
+        /// </summary>
+        Between,
+
+        /// <summary>
+        /// The Swamy-Arora random effects estimator: feasible GLS on quasi-demeaned data, with the variance components
+        /// estimated from the within and between regressions.
+        /// </summary>
+        RandomEffects
+    };
+
+    /// <summary>
+    /// A linear model of panel data y_it = α + x_itᵀ * β + u_i + e_it.
+    /// </summary>
+    /// <remarks>
+    /// The rows are read once, collecting the cross-products of (1, x, y) and their sums per entity. Each estimator
+    /// is a least squares fit on data transformed entity by entity as z_it - λ_i * z̄_i, whose cross-products follow
+    /// from those statistics alone: Σ_t (z - λ z̄)(z - λ z̄)ᵀ = Σ_t z zᵀ - (2λ - λ²) * T_i * z̄ z̄ᵀ. No demeaned copy of
+    /// the design is formed, and after the pass the cost no longer depends on the number of observations. Rows are
+    /// shifted by the first observation before accumulating, which limits cancellation when the data are far from zero.
+    ///
+    /// The coefficients are the constant followed by the slopes. For the within estimator the constant is the
+    /// grand mean ȳ - x̄ᵀ * β, as reported by Stata. Robust (HC) variances are not available.
+    /// </remarks>
+    class PanelLinearModel : public IRegressionModel {
+    public:
+
+        /// <param name="design">
+        /// The design array, without a constant column. Rows masked out of it (see <see cref="DesignMatrix::SetMask"/>)
+        /// are dropped from the entities, the observation count and the degrees of freedom.
+        /// </param>
+        /// <param name="response">
+        /// The response values.
+        /// </param>
+        /// <param name="entities">
+        /// The entity of each observation. Labels need not be contiguous, and the rows of an entity need not be
+        /// adjacent.
+        /// </param>
+        /// <param name="estimator">
+        /// The estimator.
+        /// </param>
+        PanelLinearModel(
+                const DesignMatrix &design,
+                const std::vector<double> &response,
+                const std::vector<long> &entities,
+                PanelEstimator estimator = PanelEstimator::Within);
+
+        const PanelEstimator Estimator() const
+        { return _estimator; }
+
+        const unsigned long ObservationCount() const override
+        { return _observationCount; }
+
+        const unsigned long EntityCount() const
+        { return _entityCount; }
+
+        const unsigned long VariableCount() const override
+        { return _coefficients.size(); }
+
+        const long DegreesOfFreedom() const override
+        { return _degreesOfFreedom; }
+
+        const std::vector<double> Coefficients() const override
+        { return _coefficients; }
+
+        const double SumSquaredErrors() const override
+        { return _sumSquaredErrors; }
+
+        const double MeanSquaredError() const override
+        { return _sumSquaredErrors / DegreesOfFreedom(); }
+
+        const double RootMeanSquaredError() const override
+        { return sqrt(MeanSquaredError()); }
+
+        /// <summary>
+        /// The estimated variance of the idiosyncratic error e_it, from the within regression.
+        /// </summary>
+        const double IdiosyncraticVariance() const
+        { return _idiosyncraticVariance; }
+
+        /// <summary>
+        /// The estimated variance of the entity effect u_i, from the between regression, truncated at zero.
+        /// </summary>
+        const double EntityVariance() const
+        { return _entityVariance; }
+
+        const std::vector<double> StandardErrorsOls() const override;
+
+        const std::vector<double> StandardErrorsHC0() const override;
+
+        const std::vector<double> StandardErrorsHC1() const override;
+
+        const std::vector<double> VarianceOls() const override;
+
+        const std::vector<double> VarianceHC0() const override;
+
+        const std::vector<double> VarianceHC1() const override;
+
+        /// <summary>
+        /// Calculates α + xᵀ * β for an observation given without its constant.
+        /// </summary>
+        const double Evaluate(const std::vector<double> &observation) const override;
+
+    private:
+
+        PanelEstimator _estimator;
+
+        unsigned long _observationCount;
+
+        unsigned long _entityCount;
+
+        long _degreesOfFreedom;
+
+        std::vector<double> _coefficients;
+
+        std::vector<double> _variance;
+
+        double _sumSquaredErrors;
+
+        double _idiosyncraticVariance;
+
+        double _entityVariance;
+    };
+}
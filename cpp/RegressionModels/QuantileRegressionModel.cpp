@@ -0,0 +1,738 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "QuantileRegressionModel.h"
+#include "DecompositionCholesky.h"
+#include "Equilibration.h"
+#include "MatrixProduct.h"
+#include "Normal.h"
+#include "SolverCholesky.h"
+#include "WeightedGram.h"
+
+namespace RegressionModels {
+    namespace {
+        /// <summary>
+        /// The fraction of the distance to the boundary taken by each interior point step.
+        /// </summary>
+        const double StepFraction = 0.99995;
+
+        /// <summary>
+        /// The number of times the observations whose signs a preprocessed solution contradicts are returned to the
+        /// program before the subsample is doubled instead.
+        /// </summary>
+        const int MaxFixups = 3;
+
+        /// <summary>
+        /// The role of an observation in a reduced linear program.
+        /// </summary>
+        enum Side : signed char {
+            Below = -1,
+            Kept = 0,
+            Above = 1,
+            Dropped = 2
+        };
+
+        struct Solution {
+            std::vector<double> Coefficients;
+
+            unsigned long Iterations = 0;
+
+            std::size_t ProgramSize = 0;
+        };
+
+        struct Program {
+            DesignMatrix Design;
+
+            std::vector<double> Response;
+        };
+
+        /// <summary>
+        /// The equilibrated Cholesky factorization of a Gram matrix, factored once and solved against several
+        /// right-hand sides.
+        /// </summary>
+        class NormalSolver {
+        public:
+            NormalSolver(const std::vector<double> &gram, const std::size_t k)
+                    : _equilibration(gram, k),
+                      _lower(decompositionCholesky(_equilibration.ApplyToMatrix(gram), k))
+            {
+            }
+
+            std::vector<double> Solve(const std::vector<double> &b) const
+            {
+                return _equilibration.ApplyToVector(solverCholesky(_lower, _equilibration.ApplyToVector(b)));
+            }
+
+            /// <summary>
+            /// The inverse of the Gram matrix, stored row-major.
+            /// </summary>
+            std::vector<double> Inverse() const
+            {
+                const std::size_t k = _equilibration.Scale().size();
+
+                std::vector<double> result(k * k);
+                std::vector<double> unit(k, 0.0);
+
+                for (std::size_t j = 0; j < k; j++) {
+                    unit[j] = 1.0;
+
+                    const std::vector<double> column = Solve(unit);
+
+                    for (std::size_t i = 0; i < k; i++) {
+                        result[i * k + j] = column[i];
+                    }
+
+                    unit[j] = 0.0;
+                }
+
+                return result;
+            }
+
+        private:
+
+            Equilibration _equilibration;
+
+            std::vector<double> _lower;
+        };
+
+        /// <summary>
+        /// Calculates Xᵀ * v in one pass over the design.
+        /// </summary>
+        std::vector<double> TransposedProduct(const DesignMatrix &design, const std::vector<double> &v)
+        {
+            const std::size_t k = design.ColumnCount();
+
+            std::vector<std::vector<double>> partials(design.Pool().WorkerCount(), std::vector<double>(k, 0.0));
+
+            design.ForEachPartition(
+                    [&](unsigned worker, std::size_t first, std::size_t last) {
+                        double *sum = partials[worker].data();
+
+                        std::vector<double> scratch;
+
+                        for (std::size_t block = first; block < last; block += DesignMatrix::BlockRows) {
+                            const std::size_t count = std::min(DesignMatrix::BlockRows, last - block);
+                            const double *x = design.Rows(block, count, scratch);
+
+                            for (std::size_t i = 0; i < count; i++) {
+                                const double value = v[block + i];
+
+                                for (std::size_t j = 0; j < k; j++) {
+                                    sum[j] += value * x[i * k + j];
+                                }
+                            }
+                        }
+                    });
+
+            std::vector<double> result(k, 0.0);
+
+            for (const std::vector<double> &partial : partials) {
+                for (std::size_t j = 0; j < k; j++) {
+                    result[j] += partial[j];
+                }
+            }
+
+            return result;
+        }
+
+        /// <summary>
+        /// The largest step in [0, 1] along d that keeps v nonnegative, shortened by <see cref="StepFraction"/>.
+        /// </summary>
+        double StepLength(const std::vector<double> &v, const std::vector<double> &d)
+        {
+            double step = 1e20;
+
+            for (std::size_t i = 0; i < v.size(); i++) {
+                if (d[i] < 0.0) {
+                    step = std::min(step, -v[i] / d[i]);
+                }
+            }
+
+            return std::min(StepFraction * step, 1.0);
+        }
+
+        /// <summary>
+        /// Solves the dual linear program by the Frisch-Newton interior point method (after the lp_fnm algorithm of
+        /// Portnoy and Koenker, 1997). The primal variable a starts at 1 - τ, where Xᵀ * a = (1 - τ) * Xᵀ * 1 holds,
+        /// and the dual variable at -β for the starting coefficients, or the least squares coefficients; both remain
+        /// feasible, so the duality gap alone measures convergence.
+        /// </summary>
+        Solution FrischNewton(const DesignMatrix &design, const std::vector<double> &response, const double tau, const std::vector<double> *start, const QuantileOptions &options)
+        {
+            const std::size_t n = design.RowCount();
+            const std::size_t k = design.ColumnCount();
+
+            std::vector<double> y(k);
+
+            if (start != nullptr) {
+                for (std::size_t j = 0; j < k; j++) {
+                    y[j] = -(*start)[j];
+                }
+            } else {
+                std::vector<double> negated(n);
+
+                for (std::size_t i = 0; i < n; i++) {
+                    negated[i] = -response[i];
+                }
+
+                const NormalEquations equations = weightedGram(design, std::vector<double>(n, 1.0), negated);
+
+                y = NormalSolver(equations.Gram, k).Solve(equations.Moment);
+            }
+
+            // x and s = 1 - x are the primal variables, z and w the dual slacks of their bounds; z - w = c - X * y
+            // with c = -response.
+            std::vector<double> x(n, 1.0 - tau);
+            std::vector<double> s(n, tau);
+            std::vector<double> z(n);
+            std::vector<double> w(n);
+
+            const std::vector<double> initial = matrixProduct(design, y);
+
+            double scale = 0.0;
+
+            for (std::size_t i = 0; i < n; i++) {
+                double slack = -response[i] - initial[i];
+
+                if (slack == 0.0) {
+                    slack = 0.001;
+                }
+
+                z[i] = std::max(slack, 0.0);
+                w[i] = z[i] - slack;
+                scale += std::abs(response[i]);
+            }
+
+            const double tolerance = options.Tolerance * std::max(scale, 1.0);
+
+            std::vector<double> q(n);
+            std::vector<double> r(n);
+            std::vector<double> dx(n);
+            std::vector<double> ds(n);
+            std::vector<double> dz(n);
+            std::vector<double> dw(n);
+            std::vector<double> dxdz(n);
+            std::vector<double> dsdw(n);
+            std::vector<double> correction(n);
+
+            auto gap = [&]() {
+                double sum = 0.0;
+
+                for (std::size_t i = 0; i < n; i++) {
+                    sum += z[i] * x[i] + w[i] * s[i];
+                }
+
+                return sum;
+            };
+
+            Solution solution;
+
+            while (solution.Iterations < options.MaxIterations && gap() > tolerance) {
+                solution.Iterations++;
+
+                for (std::size_t i = 0; i < n; i++) {
+                    q[i] = 1.0 / (z[i] / x[i] + w[i] / s[i]);
+                    r[i] = z[i] - w[i];
+                }
+
+                // The predictor (affine scaling) step. Close to the solution, Θ spans many orders of magnitude; if the
+                // normal equations are then numerically singular, the current iterate is as good as another step.
+                const NormalEquations equations = weightedGram(design, q, r);
+                std::unique_ptr<NormalSolver> factor;
+
+                try {
+                    factor = std::make_unique<NormalSolver>(equations.Gram, k);
+                } catch (const std::domain_error &) {
+                    if (solution.Iterations == 1) {
+                        throw;
+                    }
+
+                    break;
+                }
+
+                const NormalSolver &solver = *factor;
+
+                std::vector<double> dy = solver.Solve(equations.Moment);
+                std::vector<double> xdy = matrixProduct(design, dy);
+
+                for (std::size_t i = 0; i < n; i++) {
+                    dx[i] = q[i] * (xdy[i] - r[i]);
+                    ds[i] = -dx[i];
+                    dz[i] = -z[i] * (dx[i] / x[i] + 1.0);
+                    dw[i] = -w[i] * (ds[i] / s[i] + 1.0);
+                }
+
+                double primal = std::min(StepLength(x, dx), StepLength(s, ds));
+                double dual = std::min(StepLength(z, dz), StepLength(w, dw));
+
+                if (std::min(primal, dual) < 1.0) {
+                    // The corrector step, centred by Mehrotra's heuristic.
+                    double mu = 0.0;
+                    double predicted = 0.0;
+
+                    for (std::size_t i = 0; i < n; i++) {
+                        mu += z[i] * x[i] + w[i] * s[i];
+                        predicted += (z[i] + dual * dz[i]) * (x[i] + primal * dx[i]) + (w[i] + dual * dw[i]) * (s[i] + primal * ds[i]);
+                    }
+
+                    mu *= std::pow(predicted / mu, 3.0) / (2.0 * static_cast<double>(n));
+
+                    for (std::size_t i = 0; i < n; i++) {
+                        dxdz[i] = dx[i] * dz[i];
+                        dsdw[i] = ds[i] * dw[i];
+                        correction[i] = mu * (1.0 / x[i] - 1.0 / s[i]);
+                        r[i] = q[i] * (dxdz[i] - dsdw[i] - correction[i]);
+                    }
+
+                    std::vector<double> rhs = TransposedProduct(design, r);
+
+                    for (std::size_t j = 0; j < k; j++) {
+                        rhs[j] += equations.Moment[j];
+                    }
+
+                    dy = solver.Solve(rhs);
+                    xdy = matrixProduct(design, dy);
+
+                    for (std::size_t i = 0; i < n; i++) {
+                        dx[i] = q[i] * (xdy[i] + correction[i] - (z[i] - w[i]) - dxdz[i] + dsdw[i]);
+                        ds[i] = -dx[i];
+                        dz[i] = mu / x[i] - z[i] - z[i] * dx[i] / x[i] - dxdz[i];
+                        dw[i] = mu / s[i] - w[i] - w[i] * ds[i] / s[i] - dsdw[i];
+                    }
+
+                    primal = std::min(StepLength(x, dx), StepLength(s, ds));
+                    dual = std::min(StepLength(z, dz), StepLength(w, dw));
+                }
+
+                for (std::size_t i = 0; i < n; i++) {
+                    x[i] += primal * dx[i];
+                    s[i] += primal * ds[i];
+                    z[i] += dual * dz[i];
+                    w[i] += dual * dw[i];
+                }
+
+                for (std::size_t j = 0; j < k; j++) {
+                    y[j] += dual * dy[j];
+                }
+            }
+
+            solution.Coefficients.resize(k);
+
+            for (std::size_t j = 0; j < k; j++) {
+                solution.Coefficients[j] = -y[j];
+            }
+
+            solution.ProgramSize = n;
+
+            return solution;
+        }
+
+        /// <summary>
+        /// Copies the kept observations into a new program and appends one pseudo-observation for each nonempty set of
+        /// observations below and above the fit: the sums of their rows and responses.
+        /// </summary>
+        Program Reduce(const DesignMatrix &design, const std::vector<double> &response, const std::vector<signed char> &sides)
+        {
+            const std::size_t n = design.RowCount();
+            const std::size_t k = design.ColumnCount();
+
+            std::size_t kept = 0;
+            bool anyBelow = false;
+            bool anyAbove = false;
+
+            for (const signed char side : sides) {
+                kept += side == Kept;
+                anyBelow |= side == Below;
+                anyAbove |= side == Above;
+            }
+
+            const std::size_t rows = kept + anyBelow + anyAbove;
+
+            Program program{DesignMatrix(rows, k), std::vector<double>(rows)};
+
+            std::vector<double> below(k + 1, 0.0);
+            std::vector<double> above(k + 1, 0.0);
+            std::vector<double> scratch;
+            std::size_t row = 0;
+
+            for (std::size_t block = 0; block < n; block += DesignMatrix::BlockRows) {
+                const std::size_t count = std::min(DesignMatrix::BlockRows, n - block);
+                const double *x = design.Rows(block, count, scratch);
+
+                for (std::size_t i = 0; i < count; i++) {
+                    const signed char side = sides[block + i];
+
+                    if (side == Kept) {
+                        std::copy(x + i * k, x + (i + 1) * k, program.Design.Row(row));
+                        program.Response[row++] = response[block + i];
+                    } else if (side != Dropped) {
+                        std::vector<double> &glob = side == Below ? below : above;
+
+                        for (std::size_t j = 0; j < k; j++) {
+                            glob[j] += x[i * k + j];
+                        }
+
+                        glob[k] += response[block + i];
+                    }
+                }
+            }
+
+            for (const std::vector<double> *glob : {anyBelow ? &below : nullptr, anyAbove ? &above : nullptr}) {
+                if (glob != nullptr) {
+                    std::copy(glob->begin(), glob->begin() + k, program.Design.Row(row));
+                    program.Response[row++] = (*glob)[k];
+                }
+            }
+
+            return program;
+        }
+
+        /// <summary>
+        /// Returns the p-quantile of the values by selection, reordering them.
+        /// </summary>
+        double Select(std::vector<double> &values, const double p)
+        {
+            const double position = std::ceil(p * static_cast<double>(values.size())) - 1.0;
+            const std::size_t index = static_cast<std::size_t>(std::min(std::max(position, 0.0), static_cast<double>(values.size() - 1)));
+
+            std::nth_element(values.begin(), values.begin() + index, values.end());
+
+            return values[index];
+        }
+
+        /// <summary>
+        /// Solves the program after Portnoy and Koenker's preprocessing (the rq.fit.pfn algorithm), or directly once the
+        /// subsample would be as large as the data. Starting coefficients, fitted at another quantile, replace the
+        /// preliminary estimate until they contradict too many signs.
+        /// </summary>
+        Solution Preprocessed(const DesignMatrix &design, const std::vector<double> &response, const double tau, const std::vector<double> *start, const double startQuantile, const QuantileOptions &options)
+        {
+            const std::size_t n = design.RowCount();
+            const std::size_t k = design.ColumnCount();
+
+            std::size_t m = static_cast<std::size_t>(std::pow(static_cast<double>((k + 1) * n), 2.0 / 3.0));
+
+            std::vector<double> pilot = start != nullptr ? *start : std::vector<double>();
+            double pilotQuantile = start != nullptr ? startQuantile : tau;
+            std::mt19937_64 generator(options.Seed);
+            unsigned long iterations = 0;
+
+            std::vector<signed char> sides(n);
+            std::vector<double> work(n);
+            std::vector<std::size_t> wrong;
+
+            while (m < n) {
+                if (pilot.empty()) {
+                    // Selection sampling (Knuth's Algorithm S) picks exactly m rows, in order, in one pass.
+                    std::uniform_real_distribution<double> uniform;
+                    std::size_t chosen = 0;
+
+                    for (std::size_t i = 0; i < n; i++) {
+                        const bool choose = static_cast<double>(n - i) * uniform(generator) < static_cast<double>(m - chosen);
+
+                        sides[i] = choose ? Kept : Dropped;
+                        chosen += choose;
+                    }
+
+                    const Program sample = Reduce(design, response, sides);
+                    const Solution fit = FrischNewton(sample.Design, sample.Response, tau, start, options);
+
+                    pilot = fit.Coefficients;
+                    pilotQuantile = tau;
+                    iterations += fit.Iterations;
+                }
+
+                // The observations outside a band of about 0.8 * m residuals are globbed. With a constant in the
+                // design, the share of negative residuals at a solution is close to its quantile; without one, it need
+                // not be, so the band is centred on the pilot's own share, moved by the difference in quantiles.
+                const std::vector<double> pilotFit = matrixProduct(design, pilot);
+                const double band = 0.8 * static_cast<double>(m) / (2.0 * static_cast<double>(n));
+
+                std::size_t negative = 0;
+
+                for (std::size_t i = 0; i < n; i++) {
+                    work[i] = response[i] - pilotFit[i];
+                    negative += work[i] < 0.0;
+                }
+
+                const double centre = static_cast<double>(negative) / static_cast<double>(n) + tau - pilotQuantile;
+                const double lower = Select(work, std::max(centre - band, 1.0 / static_cast<double>(n)));
+                const double upper = Select(work, std::min(centre + band, static_cast<double>(n - 1) / static_cast<double>(n)));
+
+                for (std::size_t i = 0; i < n; i++) {
+                    const double residual = response[i] - pilotFit[i];
+
+                    sides[i] = residual < lower ? Below : residual > upper ? Above : Kept;
+                }
+
+                for (int fixup = 0; fixup <= MaxFixups; fixup++) {
+                    const Program program = Reduce(design, response, sides);
+
+                    Solution fit = FrischNewton(program.Design, program.Response, tau, &pilot, options);
+
+                    iterations += fit.Iterations;
+
+                    const std::vector<double> fitted = matrixProduct(design, fit.Coefficients);
+
+                    wrong.clear();
+
+                    for (std::size_t i = 0; i < n; i++) {
+                        const double residual = response[i] - fitted[i];
+
+                        if ((sides[i] == Below && residual > 0.0) || (sides[i] == Above && residual < 0.0)) {
+                            wrong.push_back(i);
+                        }
+                    }
+
+                    if (wrong.empty()) {
+                        fit.Iterations = iterations;
+                        return fit;
+                    }
+
+                    // Too many contradictions for the band: start again from a subsample, or, when the pilot was
+                    // already fitted at this quantile, from one twice the size.
+                    if (static_cast<double>(wrong.size()) > 0.1 * 0.8 * static_cast<double>(m)) {
+                        break;
+                    }
+
+                    pilot = fit.Coefficients;
+                    pilotQuantile = tau;
+
+                    for (const std::size_t i : wrong) {
+                        sides[i] = Kept;
+                    }
+                }
+
+                if (pilotQuantile == tau) {
+                    m *= 2;
+                }
+
+                pilot.clear();
+            }
+
+            Solution fit = FrischNewton(design, response, tau, start, options);
+
+            fit.Iterations += iterations;
+
+            return fit;
+        }
+    }
+
+    QuantileRegressionModel::QuantileRegressionModel(const DesignMatrix &design, const std::vector<double> &response, const double quantile, const QuantileOptions &options)
+            : QuantileRegressionModel(design, response, quantile, options, nullptr)
+    {
+    }
+
+    QuantileRegressionModel::QuantileRegressionModel(const DesignMatrix &design, const std::vector<double> &response, const double quantile, const QuantileOptions &options, const QuantileRegressionModel *neighbour)
+            : _quantile(quantile),
+              _observationCount(design.RowCount())
+    {
+        const std::size_t n = design.RowCount();
+        const std::size_t k = design.ColumnCount();
+
+        if (n != response.size()) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        if (design.IsMasked()) {
+            throw std::invalid_argument("Masked designs are not supported.");
+        }
+
+        if (!(quantile > 0.0 && quantile < 1.0)) {
+            throw std::out_of_range("Argument range: (0, 1).");
+        }
+
+        if (n <= k) {
+            throw std::invalid_argument("There must be more observations than variables.");
+        }
+
+        const std::vector<double> *start = neighbour != nullptr ? &neighbour->_coefficients : nullptr;
+
+        const Solution solution =
+                options.PreprocessingThreshold != 0 && n > options.PreprocessingThreshold
+                ? Preprocessed(design, response, quantile, start, neighbour != nullptr ? neighbour->_quantile : quantile, options)
+                : FrischNewton(design, response, quantile, start, options);
+
+        _coefficients = solution.Coefficients;
+        _iterations = solution.Iterations;
+        _programSize = solution.ProgramSize;
+
+        const std::vector<double> fitted = matrixProduct(design, _coefficients);
+
+        std::vector<double> residuals(n);
+
+        _sumSquaredErrors = 0.0;
+        _objective = 0.0;
+
+        double mean = 0.0;
+
+        for (std::size_t i = 0; i < n; i++) {
+            residuals[i] = response[i] - fitted[i];
+
+            _sumSquaredErrors += residuals[i] * residuals[i];
+            _objective += residuals[i] * (quantile - (residuals[i] < 0.0 ? 1.0 : 0.0));
+            mean += residuals[i];
+        }
+
+        mean /= static_cast<double>(n);
+
+        // The Hall-Sheather bandwidth, clipped to keep τ ± h inside the unit interval.
+        const double count = static_cast<double>(n);
+        const double location = SpecialFunctions::Normal::Quantile(quantile);
+        const double density = SpecialFunctions::Normal::Density(location);
+        const double bandwidth =
+                std::pow(count, -1.0 / 3.0)
+                * std::pow(SpecialFunctions::Normal::Quantile(0.975), 2.0 / 3.0)
+                * std::pow(1.5 * density * density / (2.0 * location * location + 1.0), 1.0 / 3.0);
+
+        const double lower = std::max(quantile - bandwidth, 1.0 / count);
+        const double upper = std::min(quantile + bandwidth, 1.0 - 1.0 / count);
+
+        std::vector<double> work(residuals);
+
+        const double sparsity = (Select(work, upper) - Select(work, lower)) / (upper - lower);
+        const double spread = std::min(
+                std::sqrt(std::inner_product(residuals.begin(), residuals.end(), residuals.begin(), 0.0) / count - mean * mean) * std::sqrt(count / (count - 1.0)),
+                (Select(work, 0.75) - Select(work, 0.25)) / 1.34);
+        const double kernelWidth = (SpecialFunctions::Normal::Quantile(upper) - SpecialFunctions::Normal::Quantile(lower)) * spread;
+
+        for (std::size_t i = 0; i < n; i++) {
+            work[i] = SpecialFunctions::Normal::Density(residuals[i] / kernelWidth) / kernelWidth;
+        }
+
+        const std::vector<double> zeros(n, 0.0);
+        const NormalEquations cross = weightedGram(design, std::vector<double>(n, 1.0), zeros);
+        const NormalEquations densities = weightedGram(design, work, zeros);
+
+        const std::vector<double> crossInverse = NormalSolver(cross.Gram, k).Inverse();
+        const std::vector<double> densityInverse = NormalSolver(densities.Gram, k).Inverse();
+
+        const double binomial = quantile * (1.0 - quantile);
+
+        _varianceOls.resize(k);
+        _varianceHC0.assign(k, 0.0);
+
+        for (std::size_t i = 0; i < k; i++) {
+            _varianceOls[i] = binomial * sparsity * sparsity * crossInverse[i * k + i];
+
+            for (std::size_t a = 0; a < k; a++) {
+                for (std::size_t b = 0; b < k; b++) {
+                    _varianceHC0[i] += densityInverse[i * k + a] * cross.Gram[a * k + b] * densityInverse[b * k + i];
+                }
+            }
+
+            _varianceHC0[i] *= binomial;
+        }
+    }
+
+    std::vector<QuantileRegressionModel> QuantileRegressionModel::FitMany(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &quantiles, const QuantileOptions &options)
+    {
+        if (design.IsMasked()) {
+            throw std::invalid_argument("Masked designs are not supported.");
+        }
+
+        const std::size_t count = quantiles.size();
+
+        std::vector<std::size_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return quantiles[a] < quantiles[b]; });
+
+        const std::size_t runs = std::min<std::size_t>(std::max(design.Pool().WorkerCount(), 1u), count);
+
+        std::vector<std::unique_ptr<QuantileRegressionModel>> models(count);
+
+        design.Pool().ParallelFor(
+                0,
+                runs,
+                1,
+                [&](std::size_t firstRun, std::size_t lastRun) {
+                    for (std::size_t run = firstRun; run < lastRun; run++) {
+                        const QuantileRegressionModel *previous = nullptr;
+
+                        for (std::size_t i = run * count / runs; i < (run + 1) * count / runs; i++) {
+                            const std::size_t index = order[i];
+
+                            models[index].reset(new QuantileRegressionModel(design, response, quantiles[index], options, previous));
+
+                            previous = models[index].get();
+                        }
+                    }
+                });
+
+        std::vector<QuantileRegressionModel> result;
+        result.reserve(count);
+
+        for (std::unique_ptr<QuantileRegressionModel> &model : models) {
+            result.push_back(std::move(*model));
+        }
+
+        return result;
+    }
+
+    const std::vector<double> QuantileRegressionModel::StandardErrorsOls() const
+    {
+        std::vector<double> result = VarianceOls();
+
+        for (double &value : result) {
+            value = std::sqrt(value);
+        }
+
+        return result;
+    }
+
+    const std::vector<double> QuantileRegressionModel::StandardErrorsHC0() const
+    {
+        std::vector<double> result = VarianceHC0();
+
+        for (double &value : result) {
+            value = std::sqrt(value);
+        }
+
+        return result;
+    }
+
+    const std::vector<double> QuantileRegressionModel::StandardErrorsHC1() const
+    {
+        std::vector<double> result = VarianceHC1();
+
+        for (double &value : result) {
+            value = std::sqrt(value);
+        }
+
+        return result;
+    }
+
+    const std::vector<double> QuantileRegressionModel::VarianceOls() const
+    {
+        return _varianceOls;
+    }
+
+    const std::vector<double> QuantileRegressionModel::VarianceHC0() const
+    {
+        return _varianceHC0;
+    }
+
+    const std::vector<double> QuantileRegressionModel::VarianceHC1() const
+    {
+        std::vector<double> result = _varianceHC0;
+
+        for (double &value : result) {
+            value *= static_cast<double>(_observationCount) / DegreesOfFreedom();
+        }
+
+        return result;
+    }
+
+    const double QuantileRegressionModel::Evaluate(const std::vector<double> &observation) const
+    {
+        if (observation.size() != _coefficients.size()) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        return std::inner_product(_coefficients.begin(), _coefficients.end(), observation.begin(), 0.0);
+    }
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DesignMatrix.h"
+#include "IRegressionModel.h"
+
+namespace RegressionModels {
+
+    /// <summary>
+    /// Controls the fit of a <see cref="QuantileRegressionModel"/>.
+    /// </summary>
+    struct QuantileOptions {
+        /// <summary>
+        /// The maximum number of interior point iterations per linear program.
+        /// </summary>
+        unsigned long MaxIterations = 100;
+
+        /// <summary>
+        /// The duality gap, relative to Σ |yᵢ|, below which the interior point method stops.
+        /// </summary>
+        double Tolerance = 1e-8;
+
+        /// <summary>
+        /// The number of observations above which the fit is preprocessed (see <see cref="QuantileRegressionModel"/>),
+        /// or zero to never preprocess.
+        /// </summary>
+        std::size_t PreprocessingThreshold = 100000;
+
+        /// <summary>
+        /// Seeds the subsample that gives the preliminary estimate of a preprocessed fit.
+        /// </summary>
+        std::uint64_t Seed = 0;
+    };
+
+    /// <summary>
+    /// A linear quantile regression, which minimizes Σ ρ_τ(yᵢ - xᵢᵀ * β) with ρ_τ(r) = r * (τ - 1(r &lt; 0)) (Koenker and
+    /// Bassett, 1978).
+    /// </summary>
+    /// <remarks>
+    /// The dual linear program, max yᵀ * a subject to Xᵀ * a = (1 - τ) * Xᵀ * 1 and 0 ≤ a ≤ 1, is solved by the
+    /// Frisch-Newton interior point method with Mehrotra's predictor-corrector steps (Portnoy and Koenker, 1997). Each
+    /// step solves normal equations Xᵀ * Θ * X with diagonal Θ, formed by <see cref="WeightedGram"/> and solved by an
+    /// equilibrated Cholesky factorization, so an iteration costs a few passes over the design, whatever the number of
+    /// observations.
+    ///
+    /// Above <see cref="QuantileOptions::PreprocessingThreshold"/> observations, the fit is preprocessed: a preliminary
+    /// estimate from a subsample of m = ((p + 1) * n)^(2/3) rows predicts which observations lie clearly above or below
+    /// the fitted hyperplane, and each of the two sets is replaced by a single pseudo-observation, its sum. The linear
+    /// program then has about m rows. Observations whose signs the solution contradicts are returned to the program and
+    /// it is solved again; when there are too many of them, m is doubled. The result solves the full problem.
+    /// </remarks>
+    class QuantileRegressionModel : public IRegressionModel {
+    public:
+
+        /// <param name="design">
+        /// The design, including a constant column if one is wanted.
+        /// </param>
+        /// <param name="response">
+        /// The response values.
+        /// </param>
+        /// <param name="quantile">
+        /// The quantile τ in (0, 1).
+        /// </param>
+        /// <param name="options">
+        /// The fit options.
+        /// </param>
+        /// <exception cref="std::invalid_argument">
+        /// The design is masked (see <see cref="DesignMatrix::SetMask"/>).
+        /// </exception>
+        QuantileRegressionModel(
+                const DesignMatrix &design,
+                const std::vector<double> &response,
+                double quantile = 0.5,
+                const QuantileOptions &options = QuantileOptions());
+
+        /// <summary>
+        /// Fits the same design and response at several quantiles.
+        /// </summary>
+        /// <remarks>
+        /// The quantiles are sorted and divided into one contiguous run per worker of the design's pool. Within a run,
+        /// each fit starts from the solution at the neighbouring quantile, which replaces the preliminary estimate of a
+        /// preprocessed fit and shortens the interior point path of an unpreprocessed one.
+        /// </remarks>
+        /// <returns>
+        /// The models, in the order of <paramref name="quantiles"/>.
+        /// </returns>
+        /// <exception cref="std::invalid_argument">
+        /// The design is masked (see <see cref="DesignMatrix::SetMask"/>).
+        /// </exception>
+        static std::vector<QuantileRegressionModel> FitMany(
+                const DesignMatrix &design,
+                const std::vector<double> &response,
+                const std::vector<double> &quantiles,
+                const QuantileOptions &options = QuantileOptions());
+
+        const unsigned long ObservationCount() const override
+        { return _observationCount; }
+
+        const unsigned long VariableCount() const override
+        { return _coefficients.size(); }
+
+        const long DegreesOfFreedom() const override
+        { return static_cast<long>(_observationCount) - static_cast<long>(_coefficients.size()); }
+
+        const std::vector<double> Coefficients() const override
+        { return _coefficients; }
+
+        const double SumSquaredErrors() const override
+        { return _sumSquaredErrors; }
+
+        const double MeanSquaredError() const override
+        { return _sumSquaredErrors / DegreesOfFreedom(); }
+
+        const double RootMeanSquaredError() const override
+        { return sqrt(MeanSquaredError()); }
+
+        /// <summary>
+        /// The quantile τ.
+        /// </summary>
+        const double Quantile() const
+        { return _quantile; }
+
+        /// <summary>
+        /// The minimized objective, Σ ρ_τ(yᵢ - xᵢᵀ * β).
+        /// </summary>
+        const double Objective() const
+        { return _objective; }
+
+        /// <summary>
+        /// The total number of interior point iterations, over every linear program solved.
+        /// </summary>
+        const unsigned long Iterations() const
+        { return _iterations; }
+
+        /// <summary>
+        /// The number of rows of the last linear program solved: the observation count, or the reduced size of a
+        /// preprocessed fit.
+        /// </summary>
+        const std::size_t ProgramSize() const
+        { return _programSize; }
+
+        const std::vector<double> StandardErrorsOls() const override;
+
+        const std::vector<double> StandardErrorsHC0() const override;
+
+        const std::vector<double> StandardErrorsHC1() const override;
+
+        /// <summary>
+        /// The variances under independent and identically distributed errors, τ * (1 - τ) * s² * (Xᵀ * X)⁻¹, where the
+        /// sparsity s = 1 / f(F⁻¹(τ)) is estimated by a difference quotient of the residual quantiles with the
+        /// Hall-Sheather bandwidth.
+        /// </summary>
+        const std::vector<double> VarianceOls() const override;
+
+        /// <summary>
+        /// The sandwich variances τ * (1 - τ) * J⁻¹ * Xᵀ * X * J⁻¹ (Powell, 1991), where J = Σ fᵢ * xᵢ * xᵢᵀ with each
+        /// conditional density fᵢ estimated by a Gaussian kernel on the residual.
+        /// </summary>
+        const std::vector<double> VarianceHC0() const override;
+
+        /// <summary>
+        /// The sandwich variances scaled by n / (n - p).
+        /// </summary>
+        const std::vector<double> VarianceHC1() const override;
+
+        /// <summary>
+        /// Calculates the conditional quantile xᵀ * β for an observation.
+        /// </summary>
+        const double Evaluate(const std::vector<double> &observation) const override;
+
+    private:
+
+        QuantileRegressionModel(
+                const DesignMatrix &design,
+                const std::vector<double> &response,
+                double quantile,
+                const QuantileOptions &options,
+                const QuantileRegressionModel *neighbour);
+
+        double _quantile;
+
+        unsigned long _observationCount;
+
+        std::vector<double> _coefficients;
+
+        std::vector<double> _varianceOls;
+
+        std::vector<double> _varianceHC0;
+
+        double _sumSquaredErrors;
+
+        double _objective;
+
+        unsigned long _iterations;
+
+        std::size_t _programSize;
+    };
+}
@@ -0,0 +1,115 @@
+#include <stdexcept>
+#include <utility>
+#include "ShardWorker.h"
+#include "GaussianDistribution.h"
+#include "MatrixProduct.h"
+#include "WeightedGram.h"
+
+namespace RegressionModels {
+    ShardWorker::ShardWorker(DesignMatrix design, std::vector<double> response, std::vector<double> weights, std::unique_ptr<IDistribution> distribution)
+            : _design(std::move(design)),
+              _response(std::move(response)),
+              _weights(std::move(weights)),
+              _distribution(distribution == nullptr ? std::make_unique<Distributions::GaussianDistribution>() : std::move(distribution))
+    {
+        if (_design.RowCount() != _response.size() || _design.RowCount() != _weights.size() || _design.RowCount() == 0) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        _valid = ValidityMask::Of(_response);
+        _valid &= ValidityMask::Of(_weights);
+
+        if (_design.IsMasked()) {
+            _valid &= _design.Mask();
+        }
+    }
+
+    void ShardWorker::Serve(IChannel &coordinator) const
+    {
+        coordinator.Send({static_cast<double>(_valid.ValidCount()), static_cast<double>(_design.ColumnCount())});
+
+        bool reproducible = false;
+
+        while (true) {
+            const std::vector<double> message = coordinator.Receive();
+
+            if (message.empty()) {
+                throw std::runtime_error("Received an empty command.");
+            }
+
+            switch (static_cast<ShardCommand>(message[0])) {
+                case ShardCommand::Start:
+                    reproducible = message.size() > 1 && message[1] != 0.0;
+                    coordinator.Send(Statistics(std::vector<double>(), reproducible));
+                    break;
+
+                case ShardCommand::Iterate:
+                    coordinator.Send(Statistics(std::vector<double>(message.begin() + 1, message.end()), reproducible));
+                    break;
+
+                case ShardCommand::Stop:
+                    return;
+
+                default:
+                    throw std::runtime_error("Received an unknown command.");
+            }
+        }
+    }
+
+    std::vector<double> ShardWorker::Statistics(const std::vector<double> &coefficients, const bool reproducible) const
+    {
+        const std::size_t n = _design.RowCount();
+        const std::size_t k = _design.ColumnCount();
+
+        if (!coefficients.empty() && coefficients.size() != k) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        std::vector<double> meanResponse;
+        std::vector<double> linearResponse;
+
+        if (coefficients.empty()) {
+            meanResponse = _distribution->InitialMean(_response, _valid);
+            linearResponse = _distribution->Predict(meanResponse);
+        }
+        else {
+            linearResponse = matrixProduct(_design, coefficients, _valid);
+            meanResponse = _distribution->Fit(linearResponse);
+        }
+
+        std::vector<double> wlsWeights = _distribution->Weight(meanResponse);
+        std::vector<double> wlsResponse(n);
+
+        const std::vector<double> derivative = _distribution->LinkFunction().FirstDerivative(meanResponse);
+
+        double sumSquaredErrors = 0.0;
+
+        for (std::size_t i = 0; i < n; i++) {
+            if (!_valid[i]) {
+                continue;
+            }
+
+            wlsWeights[i] *= _weights[i];
+            wlsResponse[i] = linearResponse[i] + derivative[i] * (_response[i] - meanResponse[i]);
+            sumSquaredErrors += (_response[i] - meanResponse[i]) * (_response[i] - meanResponse[i]);
+        }
+
+        const NormalEquations equations =
+                weightedGram(
+                        _design,
+                        wlsWeights,
+                        wlsResponse,
+                        reproducible ? ReductionMode::Reproducible : ReductionMode::Partitioned,
+                        _valid);
+
+        std::vector<double> statistics;
+        statistics.reserve(2 + k * k + k);
+
+        statistics.push_back(_distribution->Deviance(_response, meanResponse, _weights, 1.0, _valid));
+        statistics.push_back(sumSquaredErrors);
+        statistics.insert(statistics.end(), equations.Gram.begin(), equations.Gram.end());
+        statistics.insert(statistics.end(), equations.Moment.begin(), equations.Moment.end());
+
+        return statistics;
+    }
+}
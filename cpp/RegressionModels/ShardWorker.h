@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "DesignMatrix.h"
+#include "IChannel.h"
+#include "IDistribution.h"
+#include "ValidityMask.h"
+
+namespace RegressionModels {
+
+    /// <summary>
+    /// The commands a coordinator sends to its <see cref="ShardWorker"/> instances, as the first value of a message.
+    /// </summary>
+    enum class ShardCommand {
+        /// <summary>
+        /// { Start, reproducible }: compute the statistics at the initial means.
+        /// </summary>
+        Start = 1,
+
+        /// <summary>
+        /// { Iterate, b... }: compute the statistics at the coefficients b.
+        /// </summary>
+        Iterate = 2,
+
+        /// <summary>
+        /// { Stop }: the fit is complete.
+        /// </summary>
+        Stop = 3
+    };
+
+    /// <summary>
+    /// Holds one shard of the rows of a generalized linear model and answers a coordinator running
+    /// <see cref="GeneralizedLinearModel::FitSharded"/>.
+    /// </summary>
+    /// <remarks>
+    /// Everything an IRLS iteration needs from the data is additive over rows: the weighted Gram matrix X'WX, the
+    /// moment X'Wz and the deviance. A worker therefore answers each set of coefficients with its partial sums
+    /// { deviance, sum of squared errors, X'WX (row-major), X'Wz }, and only these k² + k + 2 values cross the
+    /// channel, whatever the number of rows.
+    /// </remarks>
+    class ShardWorker {
+    public:
+
+        ShardWorker(
+                DesignMatrix design,
+                std::vector<double> response,
+                std::vector<double> weights,
+                std::unique_ptr<IDistribution> distribution = nullptr);
+
+        /// <summary>
+        /// Announces the shard as { valid rows, columns } and answers commands until the coordinator sends
+        /// <see cref="ShardCommand::Stop"/>.
+        /// </summary>
+        void Serve(IChannel &coordinator) const;
+
+        /// <summary>
+        /// Computes the partial statistics of the shard.
+        /// </summary>
+        /// <param name="coefficients">
+        /// The current coefficients, or empty to start from the initial means of the distribution.
+        /// </param>
+        /// <param name="reproducible">
+        /// True to reduce the Gram matrix with <see cref="ReductionMode::Reproducible"/>.
+        /// </param>
+        std::vector<double> Statistics(const std::vector<double> &coefficients, bool reproducible) const;
+
+    private:
+
+        const DesignMatrix _design;
+
+        const std::vector<double> _response;
+
+        const std::vector<double> _weights;
+
+        const std::unique_ptr<IDistribution> _distribution;
+
+        /// <summary>
+        /// The rows not masked out of the design and with a response and weight, as in
+        /// <see cref="GeneralizedLinearModel"/>; the others contribute nothing to the statistics.
+        /// </summary>
+        ValidityMask _valid;
+    };
+}
@@ -0,0 +1,329 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include "WildClusterBootstrap.h"
+#include "DecompositionCholesky.h"
+#include "Equilibration.h"
+#include "MatrixProduct.h"
+#include "SolverCholesky.h"
+#include "ValidityMask.h"
+#include "WeightedGram.h"
+
+namespace RegressionModels {
+    namespace {
+        /// <summary>
+        /// The number of replicates drawn from one generator. Chunks are seeded by their index, so the draws do not
+        /// depend on how chunks are spread across threads.
+        /// </summary>
+        constexpr std::size_t ChunkReplicates = 256;
+
+        /// <summary>
+        /// Replicates are enumerated rather than drawn when there are at most this many clusters and 2^G replicates
+        /// fit the budget.
+        /// </summary>
+        constexpr std::size_t MaxEnumeratedClusters = 30;
+
+        /// <summary>
+        /// The relative margin within which a bootstrap statistic ties the statistic. Ties are structural: weights of
+        /// all ones reproduce the sample, and Rademacher weights v and -v give statistics of equal magnitude.
+        /// </summary>
+        constexpr double TieTolerance = 1e-10;
+    }
+
+    WildClusterBootstrap::WildClusterBootstrap(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, const std::vector<long> &clusters)
+    {
+        Prepare(design, response, weights, clusters);
+    }
+
+    WildClusterBootstrap::WildClusterBootstrap(const DesignMatrix &design, const GeneralizedLinearModel &model, const std::vector<double> &response, const std::vector<double> &weights, const std::vector<long> &clusters)
+    {
+        if (design.RowCount() != response.size() || design.RowCount() != weights.size() || design.ColumnCount() != model.VariableCount()) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        const IDistribution &distribution = model.Distribution();
+
+        const std::vector<double> linearResponse = matrixProduct(design, model.Coefficients());
+        const std::vector<double> meanResponse = distribution.Fit(linearResponse);
+        const std::vector<double> derivative = distribution.LinkFunction().FirstDerivative(meanResponse);
+
+        std::vector<double> wlsWeights = distribution.Weight(meanResponse);
+        std::vector<double> wlsResponse(design.RowCount());
+
+        for (std::size_t i = 0; i < wlsResponse.size(); i++) {
+            wlsWeights[i] *= weights[i];
+            wlsResponse[i] = linearResponse[i] + derivative[i] * (response[i] - meanResponse[i]);
+        }
+
+        Prepare(design, wlsResponse, wlsWeights, clusters);
+    }
+
+    void WildClusterBootstrap::Prepare(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, const std::vector<long> &clusters)
+    {
+        const std::size_t n = design.RowCount();
+        const std::size_t k = design.ColumnCount();
+
+        if (n != response.size() || n != weights.size() || n != clusters.size() || n == 0) {
+            throw std::out_of_range("Argument vectors differ in length.");
+        }
+
+        // Rows masked out of the design, or with a missing response or weight, belong to no cluster.
+        ValidityMask valid = ValidityMask::Of(response);
+        valid &= ValidityMask::Of(weights);
+
+        if (design.IsMasked()) {
+            valid &= design.Mask();
+        }
+
+        std::unordered_map<long, std::size_t> labels;
+        std::vector<std::size_t> index(n);
+
+        for (std::size_t i = 0; i < n; i++) {
+            if (valid[i]) {
+                index[i] = labels.emplace(clusters[i], labels.size()).first->second;
+            }
+        }
+
+        _observationCount = valid.ValidCount();
+        _variableCount = k;
+        _clusterCount = labels.size();
+
+        if (_clusterCount < 2) {
+            throw std::invalid_argument("At least two clusters are required.");
+        }
+
+        const std::size_t g = _clusterCount;
+
+        std::vector<double> clusterMoments(g * k, 0.0);
+
+        _clusterGrams.assign(g * k * k, 0.0);
+
+        std::vector<double> scratch;
+
+        for (std::size_t block = 0; block < n; block += DesignMatrix::BlockRows) {
+            const std::size_t count = std::min(DesignMatrix::BlockRows, n - block);
+
+            if (valid.CountValid(block, count) == 0) {
+                continue;
+            }
+
+            const double *x = design.Rows(block, count, scratch);
+
+            for (std::size_t r = 0; r < count; r++) {
+                if (!valid[block + r]) {
+                    continue;
+                }
+
+                const std::size_t c = index[block + r];
+
+                WeightedGram::AccumulateRow(x + r * k, k, weights[block + r], response[block + r], &_clusterGrams[c * k * k], &clusterMoments[c * k]);
+            }
+        }
+
+        std::vector<double> gram(k * k, 0.0);
+        std::vector<double> moment(k, 0.0);
+
+        for (std::size_t c = 0; c < g; c++) {
+            double *h = &_clusterGrams[c * k * k];
+
+            for (std::size_t a = 0; a < k; a++) {
+                for (std::size_t b = 0; b < a; b++) {
+                    h[a * k + b] = h[b * k + a];
+                }
+            }
+
+            for (std::size_t i = 0; i < k * k; i++) {
+                gram[i] += h[i];
+            }
+            for (std::size_t i = 0; i < k; i++) {
+                moment[i] += clusterMoments[c * k + i];
+            }
+        }
+
+        const Equilibration equilibration(gram, k);
+        const std::vector<double> lower = decompositionCholesky(equilibration.ApplyToMatrix(gram), k);
+
+        _coefficients = equilibration.ApplyToVector(solverCholesky(lower, equilibration.ApplyToVector(moment)));
+
+        _inverse.assign(k * k, 0.0);
+
+        std::vector<double> unit(k, 0.0);
+
+        for (std::size_t j = 0; j < k; j++) {
+            unit[j] = 1.0;
+
+            const std::vector<double> column = solverCholesky(lower, unit);
+
+            for (std::size_t i = 0; i < k; i++) {
+                _inverse[i * k + j] = column[i];
+            }
+
+            unit[j] = 0.0;
+        }
+
+        _inverse = equilibration.ApplyToMatrix(_inverse);
+
+        // Xgᵀ * Wg * ûg = Xgᵀ * Wg * zg - Hg * β̂.
+        _clusterScores = std::move(clusterMoments);
+
+        for (std::size_t c = 0; c < g; c++) {
+            for (std::size_t a = 0; a < k; a++) {
+                for (std::size_t b = 0; b < k; b++) {
+                    _clusterScores[c * k + a] -= _clusterGrams[c * k * k + a * k + b] * _coefficients[b];
+                }
+            }
+        }
+    }
+
+    BootstrapResult WildClusterBootstrap::Test(const std::size_t coefficient, const double value, const BootstrapOptions &options) const
+    {
+        const std::size_t k = _variableCount;
+        const std::size_t g = _clusterCount;
+
+        if (coefficient >= k) {
+            throw std::out_of_range("The coefficient index is out of range.");
+        }
+
+        // a = A * eⱼ is the j-th row (and column) of A = (Xᵀ * W * X)⁻¹.
+        const std::vector<double> a(_inverse.begin() + coefficient * k, _inverse.begin() + (coefficient + 1) * k);
+
+        // Imposing βⱼ = r moves the coefficients by -a * δ and the cluster scores by Hg * a * δ.
+        const double delta = (_coefficients[coefficient] - value) / a[coefficient];
+
+        const double smallSample =
+                static_cast<double>(g) / static_cast<double>(g - 1)
+                * static_cast<double>(_observationCount - 1) / static_cast<double>(_observationCount - k);
+
+        // For each cluster, the restricted score sg, its projection cg = aᵀ * sg, the projection of the unrestricted
+        // score, and fg = A * Hg * a, through which the refitted coefficients enter the bootstrap scores.
+        std::vector<double> scores(g * k);
+        std::vector<double> projections(g);
+        std::vector<double> feedback(g * k, 0.0);
+
+        double variance = 0.0;
+
+        for (std::size_t c = 0; c < g; c++) {
+            const double *h = &_clusterGrams[c * k * k];
+
+            std::vector<double> ha(k, 0.0);
+            double unrestricted = 0.0;
+
+            for (std::size_t i = 0; i < k; i++) {
+                for (std::size_t j = 0; j < k; j++) {
+                    ha[i] += h[i * k + j] * a[j];
+                }
+
+                unrestricted += a[i] * _clusterScores[c * k + i];
+            }
+
+            double projection = 0.0;
+
+            for (std::size_t i = 0; i < k; i++) {
+                scores[c * k + i] = _clusterScores[c * k + i] + ha[i] * delta;
+                projection += a[i] * scores[c * k + i];
+
+                for (std::size_t j = 0; j < k; j++) {
+                    feedback[c * k + i] += _inverse[i * k + j] * ha[j];
+                }
+            }
+
+            projections[c] = projection;
+            variance += unrestricted * unrestricted;
+        }
+
+        BootstrapResult result;
+        result.Statistic = (_coefficients[coefficient] - value) / std::sqrt(smallSample * variance);
+
+        const bool enumerate =
+                options.Weights == BootstrapWeights::Rademacher
+                && g <= MaxEnumeratedClusters
+                && (1ul << g) <= options.Replications;
+
+        const std::size_t replications = enumerate ? (1ul << g) : options.Replications;
+
+        if (replications == 0) {
+            throw std::invalid_argument("At least one replication is required.");
+        }
+
+        const double threshold = std::abs(result.Statistic);
+        const std::size_t chunks = (replications + ChunkReplicates - 1) / ChunkReplicates;
+
+        std::vector<std::size_t> exceedances(chunks, 0);
+
+        Threading::ThreadPool::Instance().ParallelFor(
+                0,
+                chunks,
+                1,
+                [&](std::size_t firstChunk, std::size_t lastChunk) {
+                    std::vector<double> v(g);
+                    std::vector<double> q(k);
+
+                    for (std::size_t chunk = firstChunk; chunk < lastChunk; chunk++) {
+                        std::seed_seq seed{static_cast<std::uint32_t>(options.Seed), static_cast<std::uint32_t>(options.Seed >> 32), static_cast<std::uint32_t>(chunk)};
+                        std::mt19937_64 generator(seed);
+                        std::uniform_int_distribution<int> draw(0, options.Weights == BootstrapWeights::Webb ? 5 : 1);
+
+                        const std::size_t last = std::min(replications, (chunk + 1) * ChunkReplicates);
+
+                        for (std::size_t replicate = chunk * ChunkReplicates; replicate < last; replicate++) {
+                            for (std::size_t c = 0; c < g; c++) {
+                                if (enumerate) {
+                                    v[c] = (replicate >> c & 1) != 0 ? -1.0 : 1.0;
+                                }
+                                else if (options.Weights == BootstrapWeights::Webb) {
+                                    static const double points[] = {-1.224744871391589, -1.0, -0.7071067811865476, 0.7071067811865476, 1.0, 1.224744871391589};
+                                    v[c] = points[draw(generator)];
+                                }
+                                else {
+                                    v[c] = draw(generator) == 0 ? -1.0 : 1.0;
+                                }
+                            }
+
+                            // q = Σ vg * sg, so that β̂*ⱼ - r = aᵀ * q and the bootstrap score of cluster g projects to
+                            // vg * cg - fgᵀ * q.
+                            std::fill(q.begin(), q.end(), 0.0);
+
+                            double numerator = 0.0;
+
+                            for (std::size_t c = 0; c < g; c++) {
+                                for (std::size_t i = 0; i < k; i++) {
+                                    q[i] += v[c] * scores[c * k + i];
+                                }
+
+                                numerator += v[c] * projections[c];
+                            }
+
+                            double bootstrapVariance = 0.0;
+
+                            for (std::size_t c = 0; c < g; c++) {
+                                double score = v[c] * projections[c];
+
+                                for (std::size_t i = 0; i < k; i++) {
+                                    score -= feedback[c * k + i] * q[i];
+                                }
+
+                                bootstrapVariance += score * score;
+                            }
+
+                            if (std::abs(numerator) >= threshold * std::sqrt(smallSample * bootstrapVariance) * (1.0 - TieTolerance)) {
+                                exceedances[chunk]++;
+                            }
+                        }
+                    }
+                });
+
+        std::size_t total = 0;
+
+        for (std::size_t count : exceedances) {
+            total += count;
+        }
+
+        result.PValue = static_cast<double>(total) / static_cast<double>(replications);
+        result.Replications = static_cast<unsigned long>(replications);
+
+        return result;
+    }
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DesignMatrix.h"
+#include "GeneralizedLinearModel.h"
+
+namespace RegressionModels {
+
+    /// <summary>
+    /// The auxiliary distribution of the wild bootstrap weights.
+    /// </summary>
+    enum class BootstrapWeights {
+        /// <summary>
+        /// ±1 with equal probability. With few clusters all 2^G sign patterns are enumerated instead of sampled.
+        /// </summary>
+        Rademacher,
+
+        /// <summary>
+        /// The six-point distribution ±√(1/2), ±1, ±√(3/2) of Webb (2014), which has more distinct patterns when
+        /// there are very few clusters.
+        /// </summary>
+        Webb
+    };
+
+    /// <summary>
+    /// Controls a wild cluster bootstrap test.
+    /// </summary>
+    struct BootstrapOptions {
+        /// <summary>
+        /// The number of bootstrap replications.
+        /// </summary>
+        unsigned long Replications = 9999;
+
+        /// <summary>
+        /// The distribution of the bootstrap weights.
+        /// </summary>
+        BootstrapWeights Weights = BootstrapWeights::Rademacher;
+
+        /// <summary>
+        /// Seeds the bootstrap weights. A test is reproducible for a given seed whatever the number of threads.
+        /// </summary>
+        std::uint64_t Seed = 0;
+    };
+
+    /// <summary>
+    /// The outcome of a wild cluster bootstrap test.
+    /// </summary>
+    struct BootstrapResult {
+        /// <summary>
+        /// The cluster-robust t statistic of the hypothesis.
+        /// </summary>
+        double Statistic = 0.0;
+
+        /// <summary>
+        /// The symmetric bootstrap p-value: the share of bootstrap statistics at least as large in magnitude as the
+        /// statistic.
+        /// </summary>
+        double PValue = 1.0;
+
+        /// <summary>
+        /// The number of bootstrap statistics computed, which is 2^G when Rademacher weights were enumerated.
+        /// </summary>
+        unsigned long Replications = 0;
+    };
+
+    /// <summary>
+    /// Restricted wild cluster bootstrap (WCR) tests of single coefficients of a weighted least squares fit.
+    /// </summary>
+    /// <remarks>
+    /// The constructor makes one pass over the rows, forming per-cluster Gram blocks Hg = Xgᵀ * Wg * Xg and score
+    /// vectors. A bootstrap replicate y* = X * β̃ + vg * ũ perturbs the restricted residuals ũ cluster by cluster, so its
+    /// coefficients and cluster-robust variance follow from those blocks alone: each replicate costs O(G * K) instead
+    /// of an O(N * K) refit, in the manner of boottest (Roodman et al., 2019).
+    ///
+    /// Generalized linear models are tested through their final IRLS step, the weighted regression of the working
+    /// response on the design, which gives the linearized (score) wild bootstrap.
+    /// </remarks>
+    class WildClusterBootstrap {
+    public:
+
+        /// <param name="design">
+        /// The design array. Rows masked out of it (see <see cref="DesignMatrix::SetMask"/>), and rows with a missing
+        /// response or weight, belong to no cluster and are not counted.
+        /// </param>
+        /// <param name="response">
+        /// The response values.
+        /// </param>
+        /// <param name="weights">
+        /// The observation weights.
+        /// </param>
+        /// <param name="clusters">
+        /// The cluster of each observation. Labels need not be contiguous.
+        /// </param>
+        WildClusterBootstrap(
+                const DesignMatrix &design,
+                const std::vector<double> &response,
+                const std::vector<double> &weights,
+                const std::vector<long> &clusters);
+
+        /// <summary>
+        /// Prepares tests of a fitted generalized linear model from its working weights and working response.
+        /// </summary>
+        /// <param name="design">
+        /// The design the model was fitted to. Rows masked out of it (see <see cref="DesignMatrix::SetMask"/>), and rows
+        /// with a missing response or weight, belong to no cluster and are not counted.
+        /// </param>
+        /// <param name="model">
+        /// The fitted model.
+        /// </param>
+        /// <param name="response">
+        /// The response values the model was fitted to.
+        /// </param>
+        /// <param name="weights">
+        /// The observation weights the model was fitted with.
+        /// </param>
+        /// <param name="clusters">
+        /// The cluster of each observation. Labels need not be contiguous.
+        /// </param>
+        WildClusterBootstrap(
+                const DesignMatrix &design,
+                const GeneralizedLinearModel &model,
+                const std::vector<double> &response,
+                const std::vector<double> &weights,
+                const std::vector<long> &clusters);
+
+        const std::size_t ClusterCount() const
+        { return _clusterCount; }
+
+        /// <summary>
+        /// The unrestricted weighted least squares coefficients.
+        /// </summary>
+        const std::vector<double> Coefficients() const
+        { return _coefficients; }
+
+        /// <summary>
+        /// Tests the hypothesis that a coefficient equals the given value.
+        /// </summary>
+        /// <param name="coefficient">
+        /// The index of the coefficient.
+        /// </param>
+        /// <param name="value">
+        /// The value of the coefficient under the null hypothesis.
+        /// </param>
+        /// <param name="options">
+        /// The bootstrap options.
+        /// </param>
+        BootstrapResult Test(std::size_t coefficient, double value = 0.0, const BootstrapOptions &options = BootstrapOptions()) const;
+
+    private:
+
+        void Prepare(const DesignMatrix &design, const std::vector<double> &response, const std::vector<double> &weights, const std::vector<long> &clusters);
+
+        std::size_t _observationCount;
+
+        std::size_t _variableCount;
+
+        std::size_t _clusterCount;
+
+        std::vector<double> _coefficients;
+
+        /// <summary>
+        /// (Xᵀ * W * X)⁻¹, stored row-major.
+        /// </summary>
+        std::vector<double> _inverse;
+
+        /// <summary>
+        /// The Gram block of each cluster, k x k row-major and stored consecutively.
+        /// </summary>
+        std::vector<double> _clusterGrams;
+
+        /// <summary>
+        /// The score Xgᵀ * Wg * ûg of each cluster at the unrestricted coefficients, stored consecutively.
+        /// </summary>
+        std::vector<double> _clusterScores;
+    };
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Serving {
+
+    /// <summary>
+    /// Controls how a <see cref="MicroBatcher"/> coalesces requests.
+    /// </summary>
+    struct BatchOptions {
+        /// <summary>
+        /// The longest a request may wait for others to join its batch.
+        /// </summary>
+        std::chrono::microseconds LatencyBudget{200};
+
+        /// <summary>
+        /// The largest number of requests processed as one batch.
+        /// </summary>
+        std::size_t MaxBatchSize = 256;
+
+        /// <summary>
+        /// The largest number of items waiting for a batch. <see cref="MicroBatcher::Submit"/> refuses more, so a
+        /// producer that outruns the handler cannot grow the queue without limit.
+        /// </summary>
+        std::size_t MaxQueueDepth = 1 << 16;
+    };
+
+    /// <summary>
+    /// Coalesces individually submitted items into batches processed on a dedicated thread.
+    /// </summary>
+    /// <remarks>
+    /// A batch opens when its first item arrives and closes when it is full, when the first item has waited for the
+    /// latency budget, or as soon as the recent arrival rate says the next item is not expected before the budget runs
+    /// out. Under light load items are therefore processed immediately, and under heavy load batches grow toward the
+    /// maximum size without exceeding the budget.
+    /// </remarks>
+    template<typename T>
+    class MicroBatcher {
+    public:
+
+        using Handler = std::function<void(std::vector<T> &batch)>;
+
+        MicroBatcher(const BatchOptions options, Handler handler)
+                : _options(options),
+                  _handler(std::move(handler)),
+                  _gap(std::chrono::hours(1)),
+                  _stopping(false),
+                  _thread(&MicroBatcher::Loop, this)
+        {
+        }
+
+        MicroBatcher(const MicroBatcher &) = delete;
+
+        MicroBatcher &operator=(const MicroBatcher &) = delete;
+
+        /// <summary>
+        /// Processes the items already submitted, then stops the batching thread.
+        /// </summary>
+        ~MicroBatcher()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+
+            _ready.notify_one();
+            _thread.join();
+        }
+
+        /// <summary>
+        /// Queues an item for the next batch.
+        /// </summary>
+        /// <returns>
+        /// False, and the item is dropped, if <see cref="BatchOptions::MaxQueueDepth"/> items are already waiting.
+        /// </returns>
+        bool Submit(T item)
+        {
+            const auto now = std::chrono::steady_clock::now();
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+
+                if (_queue.size() >= _options.MaxQueueDepth) {
+                    return false;
+                }
+
+                if (_last != std::chrono::steady_clock::time_point()) {
+                    // An exponentially weighted moving average of the time between arrivals.
+                    _gap = (_gap * 7 + (now - _last)) / 8;
+                }
+
+                _last = now;
+
+                _queue.push_back(Pending{std::move(item), now});
+            }
+
+            _ready.notify_one();
+
+            return true;
+        }
+
+    private:
+
+        struct Pending {
+            T item;
+
+            std::chrono::steady_clock::time_point arrival;
+        };
+
+        void Loop()
+        {
+            std::vector<T> batch;
+
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            while (true) {
+                _ready.wait(lock, [this]() { return _stopping || !_queue.empty(); });
+
+                if (_queue.empty()) {
+                    return;
+                }
+
+                const auto deadline = _queue.front().arrival + _options.LatencyBudget;
+
+                while (!_stopping && _queue.size() < _options.MaxBatchSize) {
+                    const auto now = std::chrono::steady_clock::now();
+
+                    if (now >= deadline || now + _gap > deadline) {
+                        break;
+                    }
+
+                    _ready.wait_until(lock, std::min(deadline, now + _gap));
+                }
+
+                const std::size_t count = std::min(_queue.size(), _options.MaxBatchSize);
+
+                batch.clear();
+
+                for (std::size_t i = 0; i < count; i++) {
+                    batch.push_back(std::move(_queue.front().item));
+                    _queue.pop_front();
+                }
+
+                lock.unlock();
+                _handler(batch);
+                lock.lock();
+            }
+        }
+
+        const BatchOptions _options;
+
+        const Handler _handler;
+
+        std::mutex _mutex;
+
+        std::condition_variable _ready;
+
+        std::deque<Pending> _queue;
+
+        std::chrono::steady_clock::duration _gap;
+
+        std::chrono::steady_clock::time_point _last;
+
+        bool _stopping;
+
+        std::thread _thread;
+    };
+}
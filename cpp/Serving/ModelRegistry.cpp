@@ -0,0 +1,88 @@
+#include <utility>
+#include "ModelRegistry.h"
+
+using RegressionModels::ModelSnapshot;
+
+namespace Serving {
+    const ModelSnapshot *ModelRegistry::View::Find(const std::string &name) const
+    {
+        const auto model = _table->models.find(name);
+
+        if (model == _table->models.end() || model->second.empty()) {
+            return nullptr;
+        }
+
+        return model->second.rbegin()->second.get();
+    }
+
+    const ModelSnapshot *ModelRegistry::View::Find(const std::string &name, const std::uint64_t version) const
+    {
+        const auto model = _table->models.find(name);
+
+        if (model == _table->models.end()) {
+            return nullptr;
+        }
+
+        const auto snapshot = model->second.find(version);
+
+        return snapshot == model->second.end() ? nullptr : snapshot->second.get();
+    }
+
+    ModelRegistry::ModelRegistry(const std::size_t retainedVersions)
+            : _retainedVersions(retainedVersions == 0 ? 1 : retainedVersions),
+              _table(new Table())
+    {
+    }
+
+    ModelRegistry::~ModelRegistry()
+    {
+        delete _table.load();
+    }
+
+    std::uint64_t ModelRegistry::Publish(const std::string &name, ModelSnapshot snapshot)
+    {
+        auto published = std::make_shared<const ModelSnapshot>(std::move(snapshot));
+
+        std::lock_guard<std::mutex> lock(_writer);
+
+        auto table = std::make_unique<Table>(*_table.load());
+
+        Versions &versions = table->models[name];
+
+        const std::uint64_t version = versions.empty() ? 1 : versions.rbegin()->first + 1;
+
+        versions.emplace(version, std::move(published));
+
+        while (versions.size() > _retainedVersions) {
+            versions.erase(versions.begin());
+        }
+
+        Swap(std::move(table));
+
+        return version;
+    }
+
+    bool ModelRegistry::Remove(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(_writer);
+
+        if (_table.load()->models.count(name) == 0) {
+            return false;
+        }
+
+        auto table = std::make_unique<Table>(*_table.load());
+
+        table->models.erase(name);
+
+        Swap(std::move(table));
+
+        return true;
+    }
+
+    void ModelRegistry::Swap(std::unique_ptr<Table> table)
+    {
+        const Table *previous = _table.exchange(table.release());
+
+        _domain.Retire([previous]() { delete previous; });
+    }
+}
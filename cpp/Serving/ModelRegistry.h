@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "EpochDomain.h"
+#include "ModelSnapshot.h"
+
+namespace Serving {
+
+    /// <summary>
+    /// A registry of immutable model snapshots, keyed by name and version, that scoring threads read without locks
+    /// while writers publish new versions.
+    /// </summary>
+    /// <remarks>
+    /// The registry is a single immutable table behind an atomic pointer. Publishing copies the table, adds the new
+    /// version, swaps the pointer and retires the previous table to an <see cref="Threading::EpochDomain"/>, so a reader
+    /// never waits for a writer and never observes a partially updated table. Snapshots are shared between successive
+    /// tables and are destroyed with the last table that holds them.
+    /// </remarks>
+    class ModelRegistry {
+        struct Table;
+
+    public:
+
+        /// <summary>
+        /// A pinned, consistent view of the registry. Pointers returned by <see cref="Find"/> stay valid for the
+        /// lifetime of the view.
+        /// </summary>
+        class View {
+        public:
+
+            View(const View &) = delete;
+
+            View &operator=(const View &) = delete;
+
+            /// <summary>
+            /// The latest version of the named model, or null.
+            /// </summary>
+            const RegressionModels::ModelSnapshot *Find(const std::string &name) const;
+
+            /// <summary>
+            /// The given version of the named model, or null if it was never published or is no longer retained.
+            /// </summary>
+            const RegressionModels::ModelSnapshot *Find(const std::string &name, std::uint64_t version) const;
+
+        private:
+
+            friend class ModelRegistry;
+
+            View(Threading::EpochDomain::Participant &participant, const std::atomic<const Table *> &table)
+                    : _guard(participant),
+                      _table(table.load())
+            {
+            }
+
+            Threading::EpochDomain::Guard _guard;
+
+            const Table *_table;
+        };
+
+        /// <summary>
+        /// A scoring thread's handle on the registry. Create one per thread and keep it for the thread's lifetime. Views
+        /// from one reader may be nested; each stays valid until it is destroyed.
+        /// </summary>
+        class Reader {
+        public:
+
+            explicit Reader(ModelRegistry &registry)
+                    : _registry(&registry),
+                      _participant(registry._domain)
+            {
+            }
+
+            /// <summary>
+            /// Pins the current table. Two atomic stores and an atomic load; no locks, no allocation.
+            /// </summary>
+            View Read()
+            { return View(_participant, _registry->_table); }
+
+        private:
+
+            ModelRegistry *_registry;
+
+            Threading::EpochDomain::Participant _participant;
+        };
+
+        /// <param name="retainedVersions">
+        /// The number of versions kept per model; older versions are dropped as new ones are published.
+        /// </param>
+        explicit ModelRegistry(std::size_t retainedVersions = 2);
+
+        ModelRegistry(const ModelRegistry &) = delete;
+
+        ModelRegistry &operator=(const ModelRegistry &) = delete;
+
+        ~ModelRegistry();
+
+        /// <summary>
+        /// Publishes a snapshot as the latest version of the named model.
+        /// </summary>
+        /// <returns>
+        /// The version assigned to the snapshot, starting at 1 for each name.
+        /// </returns>
+        std::uint64_t Publish(const std::string &name, RegressionModels::ModelSnapshot snapshot);
+
+        /// <summary>
+        /// Removes every version of the named model.
+        /// </summary>
+        /// <returns>
+        /// False if the name was not registered.
+        /// </returns>
+        bool Remove(const std::string &name);
+
+    private:
+
+        using Versions = std::map<std::uint64_t, std::shared_ptr<const RegressionModels::ModelSnapshot>>;
+
+        struct Table {
+            std::unordered_map<std::string, Versions> models;
+        };
+
+        void Swap(std::unique_ptr<Table> table);
+
+        const std::size_t _retainedVersions;
+
+        Threading::EpochDomain _domain;
+
+        std::atomic<const Table *> _table;
+
+        std::mutex _writer;
+    };
+}
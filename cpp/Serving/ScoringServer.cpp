@@ -0,0 +1,504 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "ScoringServer.h"
+
+namespace Serving {
+
+    namespace {
+        const std::size_t HeaderBytes = sizeof(std::uint64_t) + 2 * sizeof(std::uint16_t);
+
+        const std::size_t ReplyBytes = sizeof(std::uint64_t) + sizeof(std::uint8_t) + sizeof(double);
+
+        void AppendReply(std::vector<char> &buffer, const std::uint64_t id, const ScoreStatus status, const double value)
+        {
+            const std::size_t offset = buffer.size();
+
+            buffer.resize(offset + ReplyBytes);
+
+            std::memcpy(buffer.data() + offset, &id, sizeof(id));
+            buffer[offset + sizeof(id)] = static_cast<char>(status);
+            std::memcpy(buffer.data() + offset + sizeof(id) + 1, &value, sizeof(value));
+        }
+
+        const RegressionModels::ModelSnapshot *Resolve(const ModelRegistry::View &models, const std::string &name)
+        {
+            const std::size_t separator = name.rfind('@');
+
+            if (separator == std::string::npos) {
+                return models.Find(name);
+            }
+
+            char *end = nullptr;
+            const std::uint64_t version = std::strtoull(name.c_str() + separator + 1, &end, 10);
+
+            if (end == name.c_str() + separator + 1 || *end != '\0') {
+                return nullptr;
+            }
+
+            return models.Find(name.substr(0, separator), version);
+        }
+    }
+
+    struct ScoringServer::Connection {
+        explicit Connection(const int descriptor)
+                : descriptor(descriptor)
+        {
+        }
+
+        ~Connection()
+        {
+            close(descriptor);
+        }
+
+        /// <summary>
+        /// The requests counted against <see cref="MaxBufferedRequests"/>. The lock must be held.
+        /// </summary>
+        std::size_t Buffered() const
+        { return unanswered + (output.size() - written) / ReplyBytes; }
+
+        const int descriptor;
+
+        /// <summary>
+        /// Bytes received but not yet decoded. Used by the event loop only, as are the two fields below.
+        /// </summary>
+        std::vector<char> input;
+
+        /// <summary>
+        /// The events the loop is waiting for.
+        /// </summary>
+        std::uint32_t events = 0;
+
+        bool closed = false;
+
+        /// <summary>
+        /// Guards the fields below, which the batching thread appends to and the event loop drains.
+        /// </summary>
+        std::mutex lock;
+
+        /// <summary>
+        /// Replies, of which the first <see cref="written"/> bytes have been sent.
+        /// </summary>
+        std::vector<char> output;
+
+        std::size_t written = 0;
+
+        /// <summary>
+        /// Requests submitted to the batcher and not yet answered.
+        /// </summary>
+        std::size_t unanswered = 0;
+    };
+
+    ScoringServer::ScoringServer(std::string socketPath, ModelRegistry &registry, const BatchOptions options)
+            : _socketPath(std::move(socketPath)),
+              _options(options),
+              _reader(registry),
+              _listener(-1),
+              _epoll(-1),
+              _wake(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+              _replies(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+        if (_wake < 0 || _replies < 0) {
+            if (_wake >= 0) {
+                close(_wake);
+            }
+            if (_replies >= 0) {
+                close(_replies);
+            }
+
+            throw std::runtime_error("Unable to create the wake-up descriptor.");
+        }
+    }
+
+    ScoringServer::~ScoringServer()
+    {
+        _written.clear();
+        _connections.clear();
+
+        if (_listener >= 0) {
+            close(_listener);
+            unlink(_socketPath.c_str());
+        }
+        if (_epoll >= 0) {
+            close(_epoll);
+        }
+
+        close(_wake);
+        close(_replies);
+    }
+
+    void ScoringServer::Stop()
+    {
+        const std::uint64_t one = 1;
+
+        // write() is async-signal-safe, so this may be called from a signal handler.
+        (void) !write(_wake, &one, sizeof(one));
+    }
+
+    void ScoringServer::Run()
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+
+        if (_socketPath.size() >= sizeof(address.sun_path)) {
+            throw std::invalid_argument("Socket path is too long.");
+        }
+
+        std::strncpy(address.sun_path, _socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+        _listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        unlink(_socketPath.c_str());
+
+        if (_listener < 0
+            || bind(_listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0
+            || listen(_listener, SOMAXCONN) != 0) {
+            throw std::runtime_error("Unable to listen on " + _socketPath + ": " + std::strerror(errno));
+        }
+
+        _epoll = epoll_create1(EPOLL_CLOEXEC);
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+
+        for (const int descriptor : {_listener, _wake, _replies}) {
+            event.data.fd = descriptor;
+            epoll_ctl(_epoll, EPOLL_CTL_ADD, descriptor, &event);
+        }
+
+        MicroBatcher<Request> batcher(_options, [this](std::vector<Request> &batch) { Score(batch); });
+
+        // Writes what the connection can take, then decodes what it may now submit, then waits for whatever is next.
+        const auto service = [&](const std::shared_ptr<Connection> &connection) {
+            Flush(connection);
+
+            if (!connection->closed) {
+                Decode(connection, batcher);
+                Watch(connection);
+            }
+        };
+
+        std::vector<epoll_event> events(64);
+        std::vector<std::shared_ptr<Connection>> written;
+
+        while (true) {
+            const int ready = epoll_wait(_epoll, events.data(), static_cast<int>(events.size()), -1);
+
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready < 0) {
+                throw std::runtime_error(std::string("epoll_wait failed: ") + std::strerror(errno));
+            }
+
+            for (int i = 0; i < ready; i++) {
+                const int descriptor = events[i].data.fd;
+
+                if (descriptor == _wake) {
+                    return;
+                }
+                if (descriptor == _listener) {
+                    Accept();
+                    continue;
+                }
+                if (descriptor == _replies) {
+                    std::uint64_t count;
+                    (void) !read(_replies, &count, sizeof(count));
+
+                    {
+                        std::lock_guard<std::mutex> lock(_writtenLock);
+                        written.swap(_written);
+                    }
+
+                    for (const std::shared_ptr<Connection> &connection : written) {
+                        if (!connection->closed) {
+                            service(connection);
+                        }
+                    }
+
+                    written.clear();
+                    continue;
+                }
+
+                const auto connection = _connections.find(descriptor);
+
+                if (connection == _connections.end()) {
+                    continue;
+                }
+
+                const std::shared_ptr<Connection> current = connection->second;
+
+                if ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0) {
+                    Receive(current);
+                }
+
+                if (!current->closed) {
+                    service(current);
+                }
+            }
+        }
+    }
+
+    void ScoringServer::Accept()
+    {
+        while (true) {
+            const int descriptor = accept4(_listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+            if (descriptor < 0) {
+                return;
+            }
+
+            const auto connection = std::make_shared<Connection>(descriptor);
+
+            epoll_event event{};
+            event.events = connection->events = EPOLLIN | EPOLLRDHUP;
+            event.data.fd = descriptor;
+
+            epoll_ctl(_epoll, EPOLL_CTL_ADD, descriptor, &event);
+
+            _connections[descriptor] = connection;
+        }
+    }
+
+    void ScoringServer::Receive(const std::shared_ptr<Connection> &connection)
+    {
+        // A connection over its limit is not waiting for input, but a hang-up is still reported; it is not read then,
+        // so its input stays bounded.
+        if ((connection->events & EPOLLIN) == 0) {
+            std::lock_guard<std::mutex> lock(connection->lock);
+
+            if (connection->Buffered() >= MaxBufferedRequests) {
+                return;
+            }
+        }
+
+        char buffer[1 << 16];
+
+        const ssize_t count = recv(connection->descriptor, buffer, sizeof(buffer), MSG_DONTWAIT);
+
+        if (count > 0) {
+            connection->input.insert(connection->input.end(), buffer, buffer + count);
+            return;
+        }
+
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            return;
+        }
+
+        Drop(connection);
+    }
+
+    void ScoringServer::Decode(const std::shared_ptr<Connection> &connection, MicroBatcher<Request> &batcher)
+    {
+        std::vector<char> &input = connection->input;
+
+        std::size_t offset = 0;
+
+        while (input.size() - offset >= HeaderBytes) {
+            {
+                std::lock_guard<std::mutex> lock(connection->lock);
+
+                if (connection->Buffered() >= MaxBufferedRequests) {
+                    break;
+                }
+            }
+
+            const char *header = input.data() + offset;
+
+            std::uint64_t id;
+            std::uint16_t nameLength;
+            std::uint16_t valueCount;
+
+            std::memcpy(&id, header, sizeof(id));
+            std::memcpy(&nameLength, header + sizeof(id), sizeof(nameLength));
+            std::memcpy(&valueCount, header + sizeof(id) + sizeof(nameLength), sizeof(valueCount));
+
+            const std::size_t frameBytes = HeaderBytes + nameLength + valueCount * sizeof(double);
+
+            if (input.size() - offset < frameBytes) {
+                break;
+            }
+
+            Request request{connection, id, std::string(header + HeaderBytes, nameLength), std::vector<double>(valueCount)};
+
+            std::memcpy(request.values.data(), header + HeaderBytes + nameLength, valueCount * sizeof(double));
+
+            {
+                std::lock_guard<std::mutex> lock(connection->lock);
+                connection->unanswered++;
+            }
+
+            if (!batcher.Submit(std::move(request))) {
+                std::lock_guard<std::mutex> lock(connection->lock);
+
+                connection->unanswered--;
+                AppendReply(connection->output, id, ScoreStatus::Overloaded, 0.0);
+            }
+
+            offset += frameBytes;
+        }
+
+        input.erase(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(offset));
+    }
+
+    void ScoringServer::Flush(const std::shared_ptr<Connection> &connection)
+    {
+        bool failed = false;
+
+        {
+            std::lock_guard<std::mutex> lock(connection->lock);
+
+            std::vector<char> &output = connection->output;
+
+            while (connection->written < output.size()) {
+                const ssize_t count = send(connection->descriptor, output.data() + connection->written, output.size() - connection->written, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    break;
+                }
+                if (count <= 0) {
+                    failed = true;
+                    break;
+                }
+
+                connection->written += static_cast<std::size_t>(count);
+            }
+
+            if (connection->written == output.size()) {
+                output.clear();
+                connection->written = 0;
+            }
+        }
+
+        if (failed) {
+            Drop(connection);
+        }
+    }
+
+    void ScoringServer::Watch(const std::shared_ptr<Connection> &connection)
+    {
+        std::uint32_t events = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(connection->lock);
+
+            if (connection->Buffered() < MaxBufferedRequests) {
+                events |= EPOLLIN | EPOLLRDHUP;
+            }
+            if (connection->written < connection->output.size()) {
+                events |= EPOLLOUT;
+            }
+        }
+
+        if (events != connection->events) {
+            epoll_event event{};
+            event.events = connection->events = events;
+            event.data.fd = connection->descriptor;
+
+            epoll_ctl(_epoll, EPOLL_CTL_MOD, connection->descriptor, &event);
+        }
+    }
+
+    void ScoringServer::Drop(const std::shared_ptr<Connection> &connection)
+    {
+        // The descriptor closes once the batcher has released its last pending request for this connection.
+        epoll_ctl(_epoll, EPOLL_CTL_DEL, connection->descriptor, nullptr);
+        _connections.erase(connection->descriptor);
+        connection->closed = true;
+    }
+
+    void ScoringServer::Score(std::vector<Request> &batch)
+    {
+        std::sort(
+                batch.begin(),
+                batch.end(),
+                [](const Request &left, const Request &right) { return left.model < right.model; });
+
+        std::unordered_map<Connection *, std::vector<char>> replies;
+
+        // The batcher thread is the only user of the reader, and the view pins one table for the whole batch.
+        const ModelRegistry::View models = _reader.Read();
+
+        std::vector<double> rows;
+        std::vector<double> results;
+
+        for (std::size_t first = 0; first < batch.size();) {
+            std::size_t last = first + 1;
+
+            while (last < batch.size() && batch[last].model == batch[first].model) {
+                last++;
+            }
+
+            const RegressionModels::ModelSnapshot *model = Resolve(models, batch[first].model);
+
+            rows.clear();
+
+            for (std::size_t i = first; i < last; i++) {
+                if (model != nullptr && batch[i].values.size() == model->VariableCount()) {
+                    rows.insert(rows.end(), batch[i].values.begin(), batch[i].values.end());
+                }
+            }
+
+            if (model != nullptr) {
+                results.resize(rows.size() / std::max<std::size_t>(model->VariableCount(), 1));
+                model->Predict(rows.data(), results.size(), results.data());
+            }
+
+            for (std::size_t i = first, scored = 0; i < last; i++) {
+                std::vector<char> &reply = replies[batch[i].connection.get()];
+
+                if (model == nullptr) {
+                    AppendReply(reply, batch[i].id, ScoreStatus::UnknownModel, 0.0);
+                }
+                else if (batch[i].values.size() != model->VariableCount()) {
+                    AppendReply(reply, batch[i].id, ScoreStatus::WrongWidth, 0.0);
+                }
+                else {
+                    AppendReply(reply, batch[i].id, ScoreStatus::Ok, results[scored++]);
+                }
+            }
+
+            first = last;
+        }
+
+        // Replies are only appended here; the event loop writes them, so a slow client never holds up the batch.
+        std::vector<std::shared_ptr<Connection>> written;
+
+        for (const Request &request : batch) {
+            auto reply = replies.find(request.connection.get());
+
+            if (reply != replies.end()) {
+                Connection &connection = *request.connection;
+
+                {
+                    std::lock_guard<std::mutex> lock(connection.lock);
+
+                    connection.output.insert(connection.output.end(), reply->second.begin(), reply->second.end());
+                    connection.unanswered -= reply->second.size() / ReplyBytes;
+                }
+
+                written.push_back(request.connection);
+                replies.erase(reply);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_writtenLock);
+            _written.insert(_written.end(), written.begin(), written.end());
+        }
+
+        const std::uint64_t one = 1;
+        (void) !write(_replies, &one, sizeof(one));
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "MicroBatcher.h"
+#include "ModelRegistry.h"
+
+namespace Serving {
+
+    /// <summary>
+    /// The outcome of a scoring request.
+    /// </summary>
+    enum class ScoreStatus : std::uint8_t {
+        Ok = 0,
+
+        UnknownModel = 1,
+
+        WrongWidth = 2,
+
+        /// <summary>
+        /// The batching queue was full (see <see cref="BatchOptions::MaxQueueDepth"/>); the request was not scored.
+        /// </summary>
+        Overloaded = 3
+    };
+
+    /// <summary>
+    /// Answers scoring requests for fitted models over a Unix domain stream socket.
+    /// </summary>
+    /// <remarks>
+    /// All integers and values are in native byte order, and clients may pipeline any number of requests on one
+    /// connection. A request is a header { uint64 id; uint16 nameLength; uint16 valueCount; } followed by the model
+    /// name and valueCount doubles. Each request is answered with { uint64 id; uint8 status; double meanResponse; }
+    /// (17 bytes, unpadded). A model name of the form "name@version" selects a retained version; a bare name selects
+    /// the latest. Responses carry the request id because requests from one connection may be answered out
+    /// of order when they target different models.
+    ///
+    /// One thread multiplexes all connections with epoll over non-blocking sockets and decodes requests; a
+    /// <see cref="MicroBatcher"/> coalesces them, scores each model's share of a batch with a single call to
+    /// <see cref="ModelSnapshot::Predict"/>, and appends the replies to each connection's output buffer. The event loop
+    /// writes those buffers as the sockets accept them, so a client that reads slowly delays only its own replies.
+    /// Models are resolved through a <see cref="ModelRegistry"/> once per batch, so versions published while the
+    /// server runs take effect from the next batch without pausing it.
+    ///
+    /// Memory is bounded per connection and in total. A connection with <see cref="MaxBufferedRequests"/> requests
+    /// unanswered or replies unwritten is not read until its client catches up, which pushes back through the socket;
+    /// and a request that finds the batching queue full is answered at once with <see cref="ScoreStatus::Overloaded"/>.
+    /// </remarks>
+    class ScoringServer {
+    public:
+
+        ScoringServer(std::string socketPath, ModelRegistry &registry, BatchOptions options = BatchOptions());
+
+        ScoringServer(const ScoringServer &) = delete;
+
+        ScoringServer &operator=(const ScoringServer &) = delete;
+
+        ~ScoringServer();
+
+        /// <summary>
+        /// Serves requests until <see cref="Stop"/> is called.
+        /// </summary>
+        void Run();
+
+        /// <summary>
+        /// Asks <see cref="Run"/> to return. Safe to call from any thread or from a signal handler.
+        /// </summary>
+        void Stop();
+
+        /// <summary>
+        /// The most requests of one connection that may be unanswered or have replies unwritten before the server stops
+        /// reading it, which bounds its output buffer to this many replies.
+        /// </summary>
+        static constexpr std::size_t MaxBufferedRequests = 4096;
+
+    private:
+
+        struct Connection;
+
+        struct Request {
+            std::shared_ptr<Connection> connection;
+
+            std::uint64_t id;
+
+            std::string model;
+
+            std::vector<double> values;
+        };
+
+        void Accept();
+
+        void Receive(const std::shared_ptr<Connection> &connection);
+
+        /// <summary>
+        /// Submits the complete requests received on a connection, up to its limit.
+        /// </summary>
+        void Decode(const std::shared_ptr<Connection> &connection, MicroBatcher<Request> &batcher);
+
+        /// <summary>
+        /// Writes as much of a connection's output as its socket accepts without blocking.
+        /// </summary>
+        void Flush(const std::shared_ptr<Connection> &connection);
+
+        /// <summary>
+        /// Waits for input only while the connection is under its limit, and for writability only while output remains.
+        /// </summary>
+        void Watch(const std::shared_ptr<Connection> &connection);
+
+        void Drop(const std::shared_ptr<Connection> &connection);
+
+        void Score(std::vector<Request> &batch);
+
+        const std::string _socketPath;
+
+        const BatchOptions _options;
+
+        ModelRegistry::Reader _reader;
+
+        int _listener;
+
+        int _epoll;
+
+        int _wake;
+
+        /// <summary>
+        /// Signalled by the batching thread when it has appended replies to the connections in <see cref="_written"/>.
+        /// </summary>
+        int _replies;
+
+        std::mutex _writtenLock;
+
+        std::vector<std::shared_ptr<Connection>> _written;
+
+        std::unordered_map<int, std::shared_ptr<Connection>> _connections;
+    };
+}
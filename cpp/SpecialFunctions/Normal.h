@@ -0,0 +1,36 @@
+#pragma once
+
+namespace SpecialFunctions {
+
+    /// <summary>
+    /// The density and quantile functions of the standard normal distribution.
+    /// </summary>
+    class Normal {
+    public:
+        /// <summary>
+        /// Returns the standard normal density at x.
+        /// </summary>
+        /// <param name="x">
+        /// The point at which the density is evaluated.
+        /// </param>
+        /// <returns>
+        /// The density φ(x).
+        /// </returns>
+        static const double Density(double x);
+
+        /// <summary>
+        /// Returns the standard normal quantile of p in (0, 1).
+        /// </summary>
+        /// <param name="p">
+        /// The probability whose quantile is returned.
+        /// </param>
+        /// <returns>
+        /// The quantile Φ⁻¹(p).
+        /// </returns>
+        /// <remarks>
+        /// Acklam's rational approximation, refined by one step of Halley's method, which is accurate to full double
+        /// precision.
+        /// </remarks>
+        static const double Quantile(double p);
+    };
+}
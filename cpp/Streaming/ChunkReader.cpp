@@ -0,0 +1,60 @@
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ChunkReader.h"
+
+namespace Streaming {
+    ChunkReader::ChunkReader(const std::string &path)
+            : _descriptor(open(path.c_str(), O_RDONLY)),
+              _size(0)
+    {
+        if (_descriptor < 0) {
+            throw std::runtime_error("Unable to open " + path + ".");
+        }
+
+        struct stat status{};
+
+        if (fstat(_descriptor, &status) != 0) {
+            close(_descriptor);
+            throw std::runtime_error("Unable to stat " + path + ".");
+        }
+
+        _size = static_cast<std::size_t>(status.st_size);
+
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(_descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+    ChunkReader::~ChunkReader()
+    {
+        close(_descriptor);
+    }
+
+    void ChunkReader::Read(const std::size_t offset, const std::size_t count, std::vector<char> &buffer) const
+    {
+        buffer.resize(count);
+
+        std::size_t done = 0;
+
+        while (done < count) {
+            const ssize_t read = pread(_descriptor, buffer.data() + done, count - done, static_cast<off_t>(offset + done));
+
+            if (read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (read < 0) {
+                throw std::runtime_error("Read failed.");
+            }
+            if (read == 0) {
+                break;
+            }
+
+            done += static_cast<std::size_t>(read);
+        }
+
+        buffer.resize(done);
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Streaming {
+
+    /// <summary>
+    /// Reads a file in fixed-size chunks with positioned reads, so that no file offset is shared between readers.
+    /// </summary>
+    class ChunkReader {
+    public:
+
+        explicit ChunkReader(const std::string &path);
+
+        ChunkReader(const ChunkReader &) = delete;
+
+        ChunkReader &operator=(const ChunkReader &) = delete;
+
+        ~ChunkReader();
+
+        const std::size_t Size() const
+        { return _size; }
+
+        /// <summary>
+        /// Reads up to count bytes at the given offset into the buffer, resizing it to the number of bytes read.
+        /// </summary>
+        void Read(std::size_t offset, std::size_t count, std::vector<char> &buffer) const;
+
+    private:
+
+        int _descriptor;
+
+        std::size_t _size;
+    };
+}
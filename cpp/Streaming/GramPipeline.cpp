@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "BoundedQueue.h"
+#include "ChunkReader.h"
+#include "GramPipeline.h"
+#include "Kernels.h"
+#include "ThreadPool.h"
+
+namespace Streaming {
+
+    namespace {
+        struct Chunk {
+            std::size_t index = 0;
+
+            std::vector<char> bytes;
+        };
+
+        /// <summary>
+        /// The number of decoded records handed to the Gram kernel at once.
+        /// </summary>
+        const std::size_t BlockRows = 256;
+
+        void Accumulate(const RecordLayout &layout, const RowTransform &transform, const std::vector<char> &bytes, NormalEquations &partial)
+        {
+            const Kernels::KernelTable &kernels = Kernels::Active();
+
+            const std::size_t columns = layout.ColumnCount;
+            const std::size_t k = layout.DesignColumnCount();
+            const std::size_t records = bytes.size() / layout.RecordBytes();
+
+            std::vector<double> values(columns);
+            std::vector<double> design(BlockRows * k);
+            std::vector<double> weights(BlockRows);
+            std::vector<double> responses(BlockRows);
+
+            partial.Gram.assign(k * k, 0.0);
+            partial.Moment.assign(k, 0.0);
+
+            // Records are decoded a block at a time into row-major design rows, which the dispatched kernel accumulates
+            // exactly as it does the blocks of an in-memory design.
+            for (std::size_t first = 0; first < records; first += BlockRows) {
+                const std::size_t count = std::min(BlockRows, records - first);
+
+                for (std::size_t r = 0; r < count; r++) {
+                    const char *record = bytes.data() + (first + r) * layout.RecordBytes();
+
+                    if (layout.Precision == RecordPrecision::Float64) {
+                        std::memcpy(values.data(), record, columns * sizeof(double));
+                    }
+                    else {
+                        for (std::size_t c = 0; c < columns; c++) {
+                            float value;
+                            std::memcpy(&value, record + c * sizeof(float), sizeof(float));
+                            values[c] = value;
+                        }
+                    }
+
+                    double *row = design.data() + r * k;
+                    std::size_t j = 0;
+
+                    if (layout.AddConstant) {
+                        row[j++] = 1.0;
+                    }
+
+                    for (std::size_t c = 0; c < columns; c++) {
+                        if (c != layout.ResponseColumn && static_cast<long>(c) != layout.WeightColumn) {
+                            row[j++] = values[c];
+                        }
+                    }
+
+                    weights[r] = layout.WeightColumn >= 0 ? values[layout.WeightColumn] : 1.0;
+                    responses[r] = values[layout.ResponseColumn];
+
+                    if (transform) {
+                        transform(row, weights[r], responses[r]);
+                    }
+                }
+
+                kernels.AccumulateGram(design.data(), count, k, weights.data(), responses.data(), partial.Gram.data(), partial.Moment.data());
+            }
+        }
+    }
+
+    GramPipeline::GramPipeline(std::string path, const RecordLayout layout, const PipelineOptions options)
+            : _path(std::move(path)),
+              _layout(layout),
+              _options(options)
+    {
+        if (_layout.ColumnCount == 0 || _layout.ResponseColumn >= _layout.ColumnCount || _layout.WeightColumn >= static_cast<long>(_layout.ColumnCount)) {
+            throw std::out_of_range("Record columns are out of range.");
+        }
+        if (_layout.WeightColumn == static_cast<long>(_layout.ResponseColumn)) {
+            throw std::invalid_argument("The weight and response columns must differ.");
+        }
+    }
+
+    NormalEquations GramPipeline::Run(const RowTransform &transform) const
+    {
+        const ChunkReader reader(_path);
+
+        if (reader.Size() % _layout.RecordBytes() != 0) {
+            throw std::runtime_error("File size is not a multiple of the record size.");
+        }
+
+        const std::size_t chunkRows = std::max<std::size_t>(_options.ChunkRows, 1);
+        const std::size_t chunkBytes = chunkRows * _layout.RecordBytes();
+        const std::size_t rows = reader.Size() / _layout.RecordBytes();
+        const std::size_t chunkCount = (rows + chunkRows - 1) / chunkRows;
+        const std::size_t depth = std::max<std::size_t>(_options.QueueDepth, 1);
+
+        Threading::BoundedQueue<std::vector<char>> buffers(depth);
+        Threading::BoundedQueue<Chunk> filled(depth);
+
+        for (std::size_t i = 0; i < depth; i++) {
+            buffers.Push(std::vector<char>());
+        }
+
+        std::exception_ptr readFailure;
+
+        std::thread io(
+                [&]() {
+                    try {
+                        for (std::size_t index = 0; index < chunkCount; index++) {
+                            Chunk chunk;
+                            chunk.index = index;
+
+                            if (!buffers.Pop(chunk.bytes)) {
+                                break;
+                            }
+
+                            reader.Read(index * chunkBytes, chunkBytes, chunk.bytes);
+
+                            if (!filled.Push(std::move(chunk))) {
+                                break;
+                            }
+                        }
+                    }
+                    catch (...) {
+                        readFailure = std::current_exception();
+                    }
+
+                    filled.Close();
+                });
+
+        const std::size_t k = _layout.DesignColumnCount();
+
+        // Partials are folded into the total in file order as they complete. A chunk's buffer returns to the reader
+        // only once its partial is folded, so at most QueueDepth partials are ever pending.
+        NormalEquations total{std::vector<double>(k * k, 0.0), std::vector<double>(k, 0.0)};
+        std::map<std::size_t, std::pair<NormalEquations, std::vector<char>>> pending;
+        std::size_t next = 0;
+        std::mutex folding;
+
+        const auto fold = [&](const std::size_t index, NormalEquations partial, std::vector<char> bytes) {
+            std::lock_guard<std::mutex> lock(folding);
+
+            pending.emplace(index, std::make_pair(std::move(partial), std::move(bytes)));
+
+            for (auto first = pending.find(next); first != pending.end(); first = pending.find(next)) {
+                for (std::size_t i = 0; i < k * k; i++) {
+                    total.Gram[i] += first->second.first.Gram[i];
+                }
+                for (std::size_t i = 0; i < k; i++) {
+                    total.Moment[i] += first->second.first.Moment[i];
+                }
+
+                buffers.Push(std::move(first->second.second));
+                pending.erase(first);
+                next++;
+            }
+        };
+
+        Threading::ThreadPool &pool = Threading::ThreadPool::Instance();
+
+        try {
+            Threading::TaskGroup group(pool);
+
+            const auto dispatch = [&](Chunk chunk) {
+                group.Run(
+                        [&, chunk = std::move(chunk)]() mutable {
+                            try {
+                                NormalEquations partial;
+                                Accumulate(_layout, transform, chunk.bytes, partial);
+                                fold(chunk.index, std::move(partial), std::move(chunk.bytes));
+                            }
+                            catch (...) {
+                                // The chunk will never be folded, so nothing behind it can be either: stop both the
+                                // reader and the dispatch loop, and let the group report the failure.
+                                buffers.Close();
+                                filled.Close();
+                                throw;
+                            }
+                        });
+            };
+
+            Chunk chunk;
+
+            if (pool.CurrentWorker() < 0) {
+                while (filled.Pop(chunk)) {
+                    dispatch(std::move(chunk));
+                }
+            }
+            else {
+                // A worker must keep executing tasks while it waits, or the chunks it dispatched could never finish.
+                while (!filled.IsCompleted()) {
+                    if (filled.TryPop(chunk)) {
+                        dispatch(std::move(chunk));
+                    }
+                    else if (!pool.RunPendingTask()) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            group.Wait();
+        }
+        catch (...) {
+            buffers.Close();
+            filled.Close();
+            io.join();
+            throw;
+        }
+
+        io.join();
+
+        if (readFailure) {
+            std::rethrow_exception(readFailure);
+        }
+
+        return WeightedGram::Reduce({total}, k);
+    }
+}
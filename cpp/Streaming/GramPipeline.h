@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include "RecordLayout.h"
+#include "WeightedGram.h"
+
+namespace Streaming {
+
+    /// <summary>
+    /// Controls the chunking and buffering of a <see cref="GramPipeline"/>.
+    /// </summary>
+    struct PipelineOptions {
+        /// <summary>
+        /// The number of records read and accumulated as one unit.
+        /// </summary>
+        std::size_t ChunkRows = 1 << 16;
+
+        /// <summary>
+        /// The number of chunk buffers in flight, which bounds both memory use and read-ahead.
+        /// </summary>
+        std::size_t QueueDepth = 4;
+    };
+
+    /// <summary>
+    /// Maps a decoded observation (its design row, weight and response) to the weight and response that enter the
+    /// Gram matrix, e.g. the working weight and working response of an IRLS step.
+    /// </summary>
+    using RowTransform = std::function<void(const double *design, double &weight, double &response)>;
+
+    /// <summary>
+    /// Forms weighted normal equations from a record file that need not fit in memory.
+    /// </summary>
+    /// <remarks>
+    /// The pipeline has four stages connected by bounded queues: a dedicated I/O thread reads chunks with positioned
+    /// reads into a fixed set of buffers; each filled chunk is decoded a block of records at a time and accumulated into its own partial Gram by
+    /// the dispatched Gram kernel (see <see cref="Kernels::KernelTable::AccumulateGram"/>), in a task on the library
+    /// thread pool; the partials are folded into the total in file order as they complete; and each
+    /// buffer returns to the reader once its partial is folded. Reading the next chunk therefore overlaps with computing
+    /// on the current ones, memory holds at most QueueDepth chunks and partials whatever the size of the file, and the
+    /// result does not depend on scheduling. The first failure of a task stops the reader and is rethrown by Run.
+    /// </remarks>
+    class GramPipeline {
+    public:
+
+        GramPipeline(std::string path, RecordLayout layout, PipelineOptions options = PipelineOptions());
+
+        const RecordLayout &Layout() const
+        { return _layout; }
+
+        /// <summary>
+        /// Runs the pipeline over the whole file.
+        /// </summary>
+        /// <param name="transform">
+        /// An optional transform applied to each decoded observation.
+        /// </param>
+        /// <returns>
+        /// The normal equations of the (transformed) weighted least squares problem.
+        /// </returns>
+        NormalEquations Run(const RowTransform &transform = nullptr) const;
+
+    private:
+
+        const std::string _path;
+
+        const RecordLayout _layout;
+
+        const PipelineOptions _options;
+    };
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Streaming {
+
+    /// <summary>
+    /// The floating-point format of the values stored in a record file.
+    /// </summary>
+    enum class RecordPrecision {
+        Float32,
+
+        Float64
+    };
+
+    /// <summary>
+    /// Describes a binary file of fixed-width, row-major records in native byte order, one record per observation.
+    /// </summary>
+    struct RecordLayout {
+        /// <summary>
+        /// The number of values in each record.
+        /// </summary>
+        std::size_t ColumnCount = 0;
+
+        /// <summary>
+        /// The index of the response value in each record.
+        /// </summary>
+        std::size_t ResponseColumn = 0;
+
+        /// <summary>
+        /// The index of the observation weight in each record, or a negative value if every weight is one.
+        /// </summary>
+        long WeightColumn = -1;
+
+        /// <summary>
+        /// The format of the stored values.
+        /// </summary>
+        RecordPrecision Precision = RecordPrecision::Float64;
+
+        /// <summary>
+        /// True to prepend a constant to the design columns.
+        /// </summary>
+        bool AddConstant = false;
+
+        const std::size_t ValueBytes() const
+        { return Precision == RecordPrecision::Float32 ? sizeof(float) : sizeof(double); }
+
+        const std::size_t RecordBytes() const
+        { return ColumnCount * ValueBytes(); }
+
+        /// <summary>
+        /// The number of design columns: every stored column other than the response and weight, plus the constant.
+        /// </summary>
+        const std::size_t DesignColumnCount() const
+        { return ColumnCount - 1 - (WeightColumn >= 0 ? 1 : 0) + (AddConstant ? 1 : 0); }
+    };
+}
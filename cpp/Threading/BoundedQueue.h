@@ -0,0 +1,132 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace Threading {
+
+    /// <summary>
+    /// A blocking first-in-first-out queue with a fixed capacity, used to connect the stages of a pipeline so that a
+    /// fast producer cannot run arbitrarily far ahead of its consumer.
+    /// </summary>
+    template<typename T>
+    class BoundedQueue {
+    public:
+
+        explicit BoundedQueue(const std::size_t capacity)
+                : _capacity(capacity == 0 ? 1 : capacity),
+                  _closed(false)
+        {
+        }
+
+        /// <summary>
+        /// Appends an item, waiting while the queue is full.
+        /// </summary>
+        /// <returns>
+        /// False if the queue was closed; the item is then discarded.
+        /// </returns>
+        bool Push(T item)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _notFull.wait(lock, [this]() { return _closed || _items.size() < _capacity; });
+
+            if (_closed) {
+                return false;
+            }
+
+            _items.push_back(std::move(item));
+
+            lock.unlock();
+            _notEmpty.notify_one();
+
+            return true;
+        }
+
+        /// <summary>
+        /// Removes the oldest item, waiting while the queue is empty and open.
+        /// </summary>
+        /// <returns>
+        /// False once the queue is closed and drained.
+        /// </returns>
+        bool Pop(T &item)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _notEmpty.wait(lock, [this]() { return _closed || !_items.empty(); });
+
+            return Take(lock, item);
+        }
+
+        /// <summary>
+        /// Removes the oldest item if one is available, without waiting.
+        /// </summary>
+        bool TryPop(T &item)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            return Take(lock, item);
+        }
+
+        /// <summary>
+        /// Wakes all waiters. Subsequent pushes fail, while pops drain the remaining items.
+        /// </summary>
+        void Close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _closed = true;
+            }
+
+            _notEmpty.notify_all();
+            _notFull.notify_all();
+        }
+
+        const bool IsClosed() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _closed;
+        }
+
+        /// <summary>
+        /// True once the queue is closed and no items remain.
+        /// </summary>
+        const bool IsCompleted() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _closed && _items.empty();
+        }
+
+    private:
+
+        bool Take(std::unique_lock<std::mutex> &lock, T &item)
+        {
+            if (_items.empty()) {
+                return false;
+            }
+
+            item = std::move(_items.front());
+            _items.pop_front();
+
+            lock.unlock();
+            _notFull.notify_one();
+
+            return true;
+        }
+
+        const std::size_t _capacity;
+
+        mutable std::mutex _mutex;
+
+        std::condition_variable _notEmpty;
+
+        std::condition_variable _notFull;
+
+        std::deque<T> _items;
+
+        bool _closed;
+    };
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+namespace Threading {
+
+    /// <summary>
+    /// The exception thrown when an operation observes that its cancellation was requested.
+    /// </summary>
+    class OperationCanceledException : public std::runtime_error {
+    public:
+
+        OperationCanceledException()
+                : std::runtime_error("The operation was canceled.")
+        {
+        }
+    };
+
+    /// <summary>
+    /// A cooperative cancellation flag. Copies share the same flag, so a token handed to an operation can be
+    /// canceled through any other copy.
+    /// </summary>
+    class CancellationToken {
+    public:
+
+        CancellationToken()
+                : _canceled(std::make_shared<std::atomic<bool>>(false))
+        {
+        }
+
+        void Cancel() const
+        { _canceled->store(true, std::memory_order_relaxed); }
+
+        const bool IsCancellationRequested() const
+        { return _canceled->load(std::memory_order_relaxed); }
+
+        void ThrowIfCancellationRequested() const
+        {
+            if (IsCancellationRequested()) {
+                throw OperationCanceledException();
+            }
+        }
+
+    private:
+
+        std::shared_ptr<std::atomic<bool>> _canceled;
+    };
+}
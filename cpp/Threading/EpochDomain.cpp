@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <stdexcept>
+#include "EpochDomain.h"
+
+namespace Threading {
+    EpochDomain::Participant::Participant(EpochDomain &domain)
+            : _domain(&domain),
+              _slot(MaxParticipants),
+              _depth(0)
+    {
+        for (std::size_t i = 0; i < MaxParticipants; i++) {
+            bool expected = false;
+
+            if (domain._slots[i].claimed.compare_exchange_strong(expected, true)) {
+                _slot = i;
+                return;
+            }
+        }
+
+        throw std::runtime_error("Too many epoch participants.");
+    }
+
+    EpochDomain::Participant::Participant(Participant &&other) noexcept
+            : _domain(other._domain),
+              _slot(other._slot),
+              _depth(other._depth)
+    {
+        other._slot = MaxParticipants;
+    }
+
+    EpochDomain::Participant::~Participant()
+    {
+        if (_slot < MaxParticipants) {
+            _domain->_slots[_slot].epoch.store(Idle);
+            _domain->_slots[_slot].claimed.store(false, std::memory_order_release);
+        }
+    }
+
+    EpochDomain::EpochDomain()
+            : _epoch(1)
+    {
+    }
+
+    EpochDomain::~EpochDomain()
+    {
+        for (auto &retired : _retired) {
+            retired.second();
+        }
+    }
+
+    void EpochDomain::Retire(std::function<void()> reclaim)
+    {
+        // A reader that can still see the object announced an epoch no later than this one.
+        const std::uint64_t epoch = _epoch.fetch_add(1);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _retired.emplace_back(epoch, std::move(reclaim));
+        }
+
+        Collect();
+    }
+
+    void EpochDomain::Collect()
+    {
+        std::uint64_t oldest = Idle;
+
+        for (const Slot &slot : _slots) {
+            oldest = std::min(oldest, slot.epoch.load());
+        }
+
+        std::vector<std::function<void()>> ready;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            const auto pending = std::stable_partition(
+                    _retired.begin(),
+                    _retired.end(),
+                    [oldest](const std::pair<std::uint64_t, std::function<void()>> &retired) { return retired.first >= oldest; });
+
+            for (auto retired = pending; retired != _retired.end(); ++retired) {
+                ready.push_back(std::move(retired->second));
+            }
+
+            _retired.erase(pending, _retired.end());
+        }
+
+        // Destructors run outside the lock so that they may retire further objects.
+        for (const std::function<void()> &reclaim : ready) {
+            reclaim();
+        }
+    }
+
+    const std::size_t EpochDomain::PendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _retired.size();
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Threading {
+
+    /// <summary>
+    /// Epoch-based reclamation: defers the destruction of objects that have been unlinked from a shared structure until
+    /// no reader can still hold a pointer to them.
+    /// </summary>
+    /// <remarks>
+    /// Readers announce the global epoch in a private slot before loading a shared pointer and clear it afterwards; this
+    /// takes two atomic stores and never blocks. A writer first unlinks an object (for example by exchanging an atomic
+    /// pointer), then calls <see cref="Retire"/>, which advances the epoch and tags the object with the epoch it was
+    /// unlinked in. The object is destroyed once every active reader has announced a later epoch. Writers never wait
+    /// for readers; destruction is simply postponed to a later <see cref="Collect"/>.
+    /// </remarks>
+    class EpochDomain {
+    public:
+
+        /// <summary>
+        /// The largest number of participants registered at the same time.
+        /// </summary>
+        static constexpr std::size_t MaxParticipants = 128;
+
+        /// <summary>
+        /// A reader's registration with the domain. A participant must be used by one thread at a time, but its critical
+        /// sections may nest: the announced epoch is that of the outermost section and is cleared only when it ends.
+        /// </summary>
+        class Participant {
+        public:
+
+            /// <exception cref="std::runtime_error">
+            /// All <see cref="MaxParticipants"/> slots are in use.
+            /// </exception>
+            explicit Participant(EpochDomain &domain);
+
+            Participant(const Participant &) = delete;
+
+            Participant &operator=(const Participant &) = delete;
+
+            Participant(Participant &&other) noexcept;
+
+            ~Participant();
+
+            /// <summary>
+            /// Begins a read-side critical section. Objects loaded after this call stay alive until <see cref="Leave"/>.
+            /// </summary>
+            void Enter()
+            {
+                if (_depth++ == 0) {
+                    _domain->_slots[_slot].epoch.store(_domain->_epoch.load());
+                }
+            }
+
+            /// <summary>
+            /// Ends the innermost critical section. Objects loaded inside an enclosing section stay alive until it ends.
+            /// </summary>
+            void Leave()
+            {
+                if (--_depth == 0) {
+                    _domain->_slots[_slot].epoch.store(Idle, std::memory_order_release);
+                }
+            }
+
+        private:
+
+            EpochDomain *_domain;
+
+            std::size_t _slot;
+
+            /// <summary>
+            /// The number of critical sections entered and not yet left.
+            /// </summary>
+            std::size_t _depth;
+        };
+
+        /// <summary>
+        /// Holds a participant inside a read-side critical section for the lifetime of the guard.
+        /// </summary>
+        class Guard {
+        public:
+
+            explicit Guard(Participant &participant)
+                    : _participant(participant)
+            { _participant.Enter(); }
+
+            Guard(const Guard &) = delete;
+
+            Guard &operator=(const Guard &) = delete;
+
+            ~Guard()
+            { _participant.Leave(); }
+
+        private:
+
+            Participant &_participant;
+        };
+
+        EpochDomain();
+
+        EpochDomain(const EpochDomain &) = delete;
+
+        EpochDomain &operator=(const EpochDomain &) = delete;
+
+        /// <summary>
+        /// Runs every pending reclamation. No participant may be inside a critical section.
+        /// </summary>
+        ~EpochDomain();
+
+        /// <summary>
+        /// Schedules the destruction of an object that is no longer reachable by new readers.
+        /// </summary>
+        void Retire(std::function<void()> reclaim);
+
+        /// <summary>
+        /// Runs the reclamations that no active reader can observe any more.
+        /// </summary>
+        void Collect();
+
+        /// <summary>
+        /// The number of reclamations still pending.
+        /// </summary>
+        const std::size_t PendingCount() const;
+
+    private:
+
+        static constexpr std::uint64_t Idle = UINT64_MAX;
+
+        struct alignas(64) Slot {
+            std::atomic<std::uint64_t> epoch{Idle};
+
+            std::atomic<bool> claimed{false};
+        };
+
+        std::atomic<std::uint64_t> _epoch;
+
+        std::array<Slot, MaxParticipants> _slots;
+
+        mutable std::mutex _mutex;
+
+        std::vector<std::pair<std::uint64_t, std::function<void()>>> _retired;
+    };
+}
@@ -0,0 +1,327 @@
+#include <stdexcept>
+#include "ThreadPool.h"
+#include "Topology.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Threading {
+
+    namespace {
+        std::mutex instanceMutex;
+
+        std::unique_ptr<ThreadPool> instance;
+
+        unsigned configuredWorkerCount = 0;
+
+        WorkerAffinity configuredAffinity = WorkerAffinity::None;
+
+        thread_local const ThreadPool *currentPool = nullptr;
+
+        thread_local int currentWorker = -1;
+    }
+
+    ThreadPool::ThreadPool(const unsigned workerCount, const WorkerAffinity affinity)
+            : _affinity(affinity),
+              _pending(0),
+              _stopping(false)
+    {
+        const unsigned count = workerCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : workerCount;
+
+        const Topology &topology = Topology::Instance();
+
+        _workerNodes.resize(count, 0);
+        for (unsigned i = 0; i < count; i++) {
+            switch (_affinity) {
+                case WorkerAffinity::Core:
+                    _workerNodes[i] = topology.NodeOfCpu(topology.Cpus()[i % topology.Cpus().size()]);
+                    break;
+                case WorkerAffinity::Node:
+                    _workerNodes[i] = static_cast<unsigned>(static_cast<unsigned long>(i) * topology.NodeCount() / count);
+                    break;
+                case WorkerAffinity::None:
+                    break;
+            }
+        }
+
+        _queues.reserve(count);
+        for (unsigned i = 0; i < count; i++) {
+            _queues.push_back(std::make_unique<WorkerQueue>());
+        }
+
+        _workers.reserve(count);
+        for (unsigned i = 0; i < count; i++) {
+            _workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _stopping.store(true);
+        }
+
+        _sleep.notify_all();
+
+        for (std::thread &worker : _workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool &ThreadPool::Instance()
+    {
+        std::lock_guard<std::mutex> lock(instanceMutex);
+
+        if (instance == nullptr) {
+            instance = std::make_unique<ThreadPool>(configuredWorkerCount, configuredAffinity);
+        }
+
+        return *instance;
+    }
+
+    void ThreadPool::Configure(const unsigned workerCount, const WorkerAffinity affinity)
+    {
+        std::lock_guard<std::mutex> lock(instanceMutex);
+
+        if (currentPool != nullptr && currentPool == instance.get()) {
+            throw std::logic_error("The library thread pool cannot be reconfigured from one of its workers.");
+        }
+
+        configuredWorkerCount = workerCount;
+        configuredAffinity = affinity;
+
+        instance.reset();
+    }
+
+    const int ThreadPool::CurrentWorker() const
+    {
+        return currentPool == this ? currentWorker : -1;
+    }
+
+    void ThreadPool::Submit(Task task)
+    {
+        const int worker = CurrentWorker();
+
+        WorkerQueue &queue = worker < 0 ? _injected : *_queues[worker];
+
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+
+        _pending.fetch_add(1, std::memory_order_release);
+
+        {
+            // Taking the lock orders this notification after a sleeper's predicate check.
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+        }
+
+        _sleep.notify_one();
+    }
+
+    bool ThreadPool::RunPendingTask()
+    {
+        const int worker = CurrentWorker();
+
+        Task task;
+
+        if (worker >= 0 && TryPopPinned(static_cast<unsigned>(worker), task)) {
+            task();
+            return true;
+        }
+
+        if (worker >= 0 ? TryPop(static_cast<unsigned>(worker), task) || TrySteal(static_cast<unsigned>(worker), task)
+                        : TrySteal(WorkerCount(), task)) {
+            task();
+            return true;
+        }
+
+        return false;
+    }
+
+    void ThreadPool::ForEachWorker(const std::function<void(unsigned)> &body)
+    {
+        std::atomic<std::size_t> outstanding(_workers.size());
+        std::mutex exceptionMutex;
+        std::exception_ptr exception;
+
+        for (unsigned i = 0; i < WorkerCount(); i++) {
+            WorkerQueue &queue = *_queues[i];
+
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            queue.pinned.push_back(
+                    [&, i]() {
+                        try {
+                            body(i);
+                        }
+                        catch (...) {
+                            std::lock_guard<std::mutex> exceptionLock(exceptionMutex);
+                            if (!exception) {
+                                exception = std::current_exception();
+                            }
+                        }
+                        outstanding.fetch_sub(1, std::memory_order_release);
+                    });
+            queue.pinnedCount.fetch_add(1, std::memory_order_release);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+        }
+
+        _sleep.notify_all();
+
+        while (outstanding.load(std::memory_order_acquire) != 0) {
+            if (!RunPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    bool ThreadPool::TryPopPinned(const unsigned worker, Task &task)
+    {
+        WorkerQueue &queue = *_queues[worker];
+
+        if (queue.pinnedCount.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.pinned.empty()) {
+            return false;
+        }
+
+        task = std::move(queue.pinned.front());
+        queue.pinned.pop_front();
+
+        queue.pinnedCount.fetch_sub(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    bool ThreadPool::TryPop(const unsigned worker, Task &task)
+    {
+        WorkerQueue &queue = *_queues[worker];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty()) {
+            return false;
+        }
+
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+
+        _pending.fetch_sub(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    bool ThreadPool::TrySteal(const unsigned thief, Task &task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_injected.mutex);
+
+            if (!_injected.tasks.empty()) {
+                task = std::move(_injected.tasks.front());
+                _injected.tasks.pop_front();
+
+                _pending.fetch_sub(1, std::memory_order_relaxed);
+
+                return true;
+            }
+        }
+
+        const auto count = static_cast<unsigned>(_queues.size());
+
+        for (unsigned offset = 1; offset <= count; offset++) {
+            const unsigned victim = (thief + offset) % count;
+
+            if (victim == thief) {
+                continue;
+            }
+
+            WorkerQueue &queue = *_queues[victim];
+
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+
+                _pending.fetch_sub(1, std::memory_order_relaxed);
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::WorkerLoop(const unsigned worker)
+    {
+        currentPool = this;
+        currentWorker = static_cast<int>(worker);
+
+        Pin(worker);
+
+        while (true) {
+            Task task;
+
+            if (TryPopPinned(worker, task) || TryPop(worker, task) || TrySteal(worker, task)) {
+                task();
+                continue;
+            }
+
+            WorkerQueue &queue = *_queues[worker];
+
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+
+            _sleep.wait(
+                    lock,
+                    [this, &queue]() {
+                        return _stopping.load()
+                               || _pending.load(std::memory_order_acquire) != 0
+                               || queue.pinnedCount.load(std::memory_order_acquire) != 0;
+                    });
+
+            if (_stopping.load() && _pending.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    void ThreadPool::Pin(const unsigned worker)
+    {
+        if (_affinity == WorkerAffinity::None) {
+            return;
+        }
+
+#ifdef __linux__
+        const Topology &topology = Topology::Instance();
+
+        cpu_set_t pinned;
+        CPU_ZERO(&pinned);
+
+        if (_affinity == WorkerAffinity::Core) {
+            CPU_SET(topology.Cpus()[worker % topology.Cpus().size()], &pinned);
+        }
+        else {
+            for (int cpu : topology.NodeCpus(_workerNodes[worker])) {
+                CPU_SET(cpu, &pinned);
+            }
+        }
+
+        pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned);
+#endif
+    }
+}
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Threading {
+
+    /// <summary>
+    /// Describes how the workers of a <see cref="ThreadPool"/> are bound to processors.
+    /// </summary>
+    enum class WorkerAffinity {
+        /// <summary>
+        /// Workers float freely across processors.
+        /// </summary>
+        None,
+
+        /// <summary>
+        /// Worker i is pinned to the i-th available processor.
+        /// </summary>
+        Core,
+
+        /// <summary>
+        /// Workers are divided into contiguous blocks, one per NUMA node, and each block may run on any processor of
+        /// its node.
+        /// </summary>
+        Node
+    };
+
+    /// <summary>
+    /// A work-stealing scheduler shared by every parallel kernel in the library.
+    /// </summary>
+    /// <remarks>
+    /// Each worker owns a deque that it pushes and pops at the back, while idle workers steal from the front of the
+    /// other deques. Threads that wait on a <see cref="TaskGroup"/> execute pending tasks instead of blocking, so
+    /// parallel kernels may be nested without deadlocking or oversubscribing the machine.
+    /// </remarks>
+    class ThreadPool {
+    public:
+
+        using Task = std::function<void()>;
+
+        /// <summary>
+        /// The default number of elements processed by a single task in element-wise kernels.
+        /// </summary>
+        static constexpr std::size_t DefaultGrain = 1 << 14;
+
+        explicit ThreadPool(unsigned workerCount = 0, WorkerAffinity affinity = WorkerAffinity::None);
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        ~ThreadPool();
+
+        /// <summary>
+        /// Returns the library-wide pool, constructing it with the configured settings on first use.
+        /// </summary>
+        static ThreadPool &Instance();
+
+        /// <summary>
+        /// Replaces the library-wide pool. Must not be called while parallel work is in flight.
+        /// </summary>
+        /// <param name="workerCount">
+        /// The number of workers, or zero for the number of hardware threads.
+        /// </param>
+        /// <param name="affinity">
+        /// How the workers are bound to processors.
+        /// </param>
+        static void Configure(unsigned workerCount, WorkerAffinity affinity = WorkerAffinity::None);
+
+        const unsigned WorkerCount() const
+        { return static_cast<unsigned>(_workers.size()); }
+
+        const WorkerAffinity Affinity() const
+        { return _affinity; }
+
+        /// <summary>
+        /// The NUMA node the given worker is bound to. Workers that are not bound report node zero.
+        /// </summary>
+        const unsigned WorkerNode(unsigned worker) const
+        { return _workerNodes[worker]; }
+
+        /// <summary>
+        /// The index of the calling worker in this pool, or -1 if the caller is not one of its workers.
+        /// </summary>
+        const int CurrentWorker() const;
+
+        /// <summary>
+        /// Schedules a task. Tasks submitted from a worker go to that worker's deque; others go to the shared queue.
+        /// </summary>
+        void Submit(Task task);
+
+        /// <summary>
+        /// Executes one pending task on the calling thread, if any is available.
+        /// </summary>
+        /// <returns>
+        /// True if a task was executed; otherwise false.
+        /// </returns>
+        bool RunPendingTask();
+
+        /// <summary>
+        /// Invokes body(worker) exactly once on each worker of the pool and waits for all of them. These tasks are never
+        /// stolen, so kernels that partition data by worker index always touch their partition from the same thread.
+        /// </summary>
+        void ForEachWorker(const std::function<void(unsigned)> &body);
+
+        /// <summary>
+        /// Invokes body(first, last) over disjoint subranges covering [begin, end), splitting recursively down to the
+        /// given grain so that idle workers can steal the larger halves.
+        /// </summary>
+        /// <param name="begin">
+        /// The first index of the range.
+        /// </param>
+        /// <param name="end">
+        /// One past the last index of the range.
+        /// </param>
+        /// <param name="grain">
+        /// The largest subrange executed without further splitting.
+        /// </param>
+        /// <param name="body">
+        /// The callable invoked with each subrange.
+        /// </param>
+        template<typename TBody>
+        void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, const TBody &body);
+
+        /// <summary>
+        /// Reduces body(first, last) over disjoint subranges of [begin, end) with the given associative operation.
+        /// </summary>
+        template<typename T, typename TBody, typename TCombine>
+        T ParallelReduce(std::size_t begin, std::size_t end, std::size_t grain, T identity, const TBody &body, const TCombine &combine);
+
+    private:
+
+        struct WorkerQueue {
+            std::mutex mutex;
+
+            std::deque<Task> tasks;
+
+            std::deque<Task> pinned;
+
+            std::atomic<std::size_t> pinnedCount{0};
+        };
+
+        bool TryPopPinned(unsigned worker, Task &task);
+
+        bool TryPop(unsigned worker, Task &task);
+
+        bool TrySteal(unsigned thief, Task &task);
+
+        void WorkerLoop(unsigned worker);
+
+        void Pin(unsigned worker);
+
+        const WorkerAffinity _affinity;
+
+        std::vector<unsigned> _workerNodes;
+
+        std::vector<std::unique_ptr<WorkerQueue>> _queues;
+
+        WorkerQueue _injected;
+
+        std::vector<std::thread> _workers;
+
+        std::mutex _sleepMutex;
+
+        std::condition_variable _sleep;
+
+        std::atomic<std::size_t> _pending;
+
+        std::atomic<bool> _stopping;
+    };
+
+    /// <summary>
+    /// A fork-join scope over a <see cref="ThreadPool"/>. Tasks run through the group are joined by <see cref="Wait"/>,
+    /// which rethrows the first exception raised by any of them.
+    /// </summary>
+    class TaskGroup {
+    public:
+
+        explicit TaskGroup(ThreadPool &pool = ThreadPool::Instance())
+                : _pool(pool),
+                  _outstanding(0)
+        {
+        }
+
+        TaskGroup(const TaskGroup &) = delete;
+
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        ~TaskGroup()
+        {
+            // A group must never outlive the tasks that reference it.
+            Join();
+        }
+
+        ThreadPool &Pool() const
+        { return _pool; }
+
+        template<typename TTask>
+        void Run(TTask &&task)
+        {
+            _outstanding.fetch_add(1, std::memory_order_relaxed);
+
+            _pool.Submit(
+                    [this, task = std::forward<TTask>(task)]() mutable {
+                        try {
+                            task();
+                        }
+                        catch (...) {
+                            std::lock_guard<std::mutex> lock(_mutex);
+                            if (!_exception) {
+                                _exception = std::current_exception();
+                            }
+                        }
+                        _outstanding.fetch_sub(1, std::memory_order_release);
+                    });
+        }
+
+        void Wait()
+        {
+            Join();
+
+            if (_exception) {
+                std::exception_ptr exception = _exception;
+                _exception = nullptr;
+                std::rethrow_exception(exception);
+            }
+        }
+
+    private:
+
+        void Join()
+        {
+            while (_outstanding.load(std::memory_order_acquire) != 0) {
+                if (!_pool.RunPendingTask()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        ThreadPool &_pool;
+
+        std::atomic<std::size_t> _outstanding;
+
+        std::mutex _mutex;
+
+        std::exception_ptr _exception;
+    };
+
+    namespace Detail {
+        template<typename TBody>
+        void SplitRange(TaskGroup &group, std::size_t begin, std::size_t end, std::size_t grain, const TBody &body)
+        {
+            while (end - begin > grain) {
+                const std::size_t middle = begin + (end - begin) / 2;
+
+                group.Run([&group, middle, end, grain, &body]() { SplitRange(group, middle, end, grain, body); });
+
+                end = middle;
+            }
+
+            body(begin, end);
+        }
+    }
+
+    template<typename TBody>
+    void ThreadPool::ParallelFor(const std::size_t begin, const std::size_t end, std::size_t grain, const TBody &body)
+    {
+        if (end <= begin) {
+            return;
+        }
+
+        grain = std::max<std::size_t>(grain, 1);
+
+        if (end - begin <= grain || _workers.empty()) {
+            body(begin, end);
+            return;
+        }
+
+        TaskGroup group(*this);
+
+        Detail::SplitRange(group, begin, end, grain, body);
+
+        group.Wait();
+    }
+
+    template<typename T, typename TBody, typename TCombine>
+    T ThreadPool::ParallelReduce(const std::size_t begin, const std::size_t end, std::size_t grain, T identity, const TBody &body, const TCombine &combine)
+    {
+        if (end <= begin) {
+            return identity;
+        }
+
+        grain = std::max<std::size_t>(grain, 1);
+
+        const std::size_t chunks = (end - begin + grain - 1) / grain;
+
+        std::vector<T> partials(chunks, identity);
+
+        ParallelFor(
+                0,
+                chunks,
+                1,
+                [&](std::size_t first, std::size_t last) {
+                    for (std::size_t c = first; c < last; ++c) {
+                        partials[c] = body(begin + c * grain, std::min(end, begin + (c + 1) * grain));
+                    }
+                });
+
+        T result = identity;
+
+        for (const T &partial : partials) {
+            result = combine(result, partial);
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "Topology.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace Threading {
+
+    namespace {
+        std::vector<int> ParseCpuList(const std::string &list)
+        {
+            std::vector<int> cpus;
+
+            std::stringstream stream(list);
+            std::string range;
+
+            while (std::getline(stream, range, ',')) {
+                if (range.empty() || range == "\n") {
+                    continue;
+                }
+
+                const std::size_t dash = range.find('-');
+
+                const int first = std::stoi(range.substr(0, dash));
+                const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+
+                for (int cpu = first; cpu <= last; cpu++) {
+                    cpus.push_back(cpu);
+                }
+            }
+
+            return cpus;
+        }
+    }
+
+    const Topology &Topology::Instance()
+    {
+        static const Topology topology;
+
+        return topology;
+    }
+
+    Topology::Topology()
+    {
+#ifdef __linux__
+        cpu_set_t available;
+        CPU_ZERO(&available);
+
+        if (sched_getaffinity(0, sizeof(available), &available) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &available)) {
+                    _cpus.push_back(cpu);
+                }
+            }
+        }
+
+        for (unsigned node = 0;; node++) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+
+            if (!file) {
+                break;
+            }
+
+            std::string list;
+            std::getline(file, list);
+
+            std::vector<int> cpus;
+
+            for (int cpu : ParseCpuList(list)) {
+                if (std::binary_search(_cpus.begin(), _cpus.end(), cpu)) {
+                    cpus.push_back(cpu);
+                }
+            }
+
+            // Nodes without usable processors (e.g. memory-only nodes, or excluded by a cpuset) cannot host workers.
+            if (!cpus.empty()) {
+                _nodeCpus.push_back(cpus);
+            }
+        }
+#endif
+
+        if (_cpus.empty()) {
+            for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); cpu++) {
+                _cpus.push_back(static_cast<int>(cpu));
+            }
+        }
+
+        if (_nodeCpus.empty()) {
+            _nodeCpus.push_back(_cpus);
+        }
+    }
+
+    const unsigned Topology::NodeOfCpu(const int cpu) const
+    {
+        for (std::size_t node = 0; node < _nodeCpus.size(); node++) {
+            if (std::binary_search(_nodeCpus[node].begin(), _nodeCpus[node].end(), cpu)) {
+                return static_cast<unsigned>(node);
+            }
+        }
+
+        return 0;
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+namespace Threading {
+
+    /// <summary>
+    /// The NUMA layout of the processors available to this process, read once from the operating system.
+    /// </summary>
+    /// <remarks>
+    /// On systems that do not expose NUMA information every available processor is reported on a single node.
+    /// </remarks>
+    class Topology {
+    public:
+
+        /// <summary>
+        /// Returns the topology of the current machine.
+        /// </summary>
+        static const Topology &Instance();
+
+        const unsigned NodeCount() const
+        { return static_cast<unsigned>(_nodeCpus.size()); }
+
+        /// <summary>
+        /// The processors available to this process, ordered by index.
+        /// </summary>
+        const std::vector<int> &Cpus() const
+        { return _cpus; }
+
+        /// <summary>
+        /// The available processors that belong to the given node.
+        /// </summary>
+        const std::vector<int> &NodeCpus(unsigned node) const
+        { return _nodeCpus[node]; }
+
+        /// <summary>
+        /// The node that owns the given processor, or zero if it is unknown.
+        /// </summary>
+        const unsigned NodeOfCpu(int cpu) const;
+
+    private:
+
+        Topology();
+
+        std::vector<int> _cpus;
+
+        std::vector<std::vector<int>> _nodeCpus;
+    };
+}
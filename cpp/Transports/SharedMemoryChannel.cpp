@@ -0,0 +1,262 @@
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "SharedMemoryChannel.h"
+
+namespace Transports {
+    namespace {
+        const std::uint64_t Magic = 0x41444D5348434832ULL;
+
+        /// <summary>
+        /// How often a waiting end checks that its peer is still there, in milliseconds.
+        /// </summary>
+        const long LivenessInterval = 100;
+
+        /// <summary>
+        /// True if the process has exited. A child of this process that exited remains signalable until it is reaped,
+        /// so it is looked for among the exited children, without reaping it.
+        /// </summary>
+        bool HasExited(const pid_t process)
+        {
+            if (kill(process, 0) != 0 && errno == ESRCH) {
+                return true;
+            }
+
+            siginfo_t info{};
+
+            return waitid(P_PID, static_cast<id_t>(process), &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid == process;
+        }
+    }
+
+    struct SharedMemoryChannel::Mailbox {
+        sem_t full;
+
+        sem_t empty;
+
+        std::uint64_t length;
+    };
+
+    struct SharedMemoryChannel::Region {
+        std::uint64_t magic;
+
+        std::uint64_t capacity;
+
+        /// <summary>
+        /// Carries messages from the creating end to the opening end.
+        /// </summary>
+        Mailbox forward;
+
+        /// <summary>
+        /// Carries messages from the opening end to the creating end.
+        /// </summary>
+        Mailbox backward;
+
+        /// <summary>
+        /// The processes of the creating and the opening end, or zero for an end not yet opened.
+        /// </summary>
+        std::int64_t processes[2];
+
+        /// <summary>
+        /// Set by each end when it is destroyed.
+        /// </summary>
+        std::uint32_t closed[2];
+    };
+
+    SharedMemoryChannel::SharedMemoryChannel(std::string name, Region *region, const std::size_t bytes, const bool owner)
+            : _name(std::move(name)),
+              _region(region),
+              _bytes(bytes),
+              _owner(owner)
+    {
+    }
+
+    std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::Create(const std::string &name, const std::size_t capacity)
+    {
+        const std::size_t bytes = sizeof(Region) + 2 * capacity * sizeof(double);
+
+        const int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+
+        if (descriptor < 0) {
+            throw std::runtime_error("Unable to create " + name + ": " + std::strerror(errno));
+        }
+
+        void *address = ftruncate(descriptor, static_cast<off_t>(bytes)) == 0
+                        ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0)
+                        : MAP_FAILED;
+
+        close(descriptor);
+
+        if (address == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            throw std::runtime_error("Unable to map " + name + ".");
+        }
+
+        auto *region = static_cast<Region *>(address);
+
+        region->capacity = capacity;
+
+        for (Mailbox *mailbox : {&region->forward, &region->backward}) {
+            sem_init(&mailbox->full, 1, 0);
+            sem_init(&mailbox->empty, 1, 1);
+            mailbox->length = 0;
+        }
+
+        region->processes[0] = getpid();
+        region->processes[1] = 0;
+        region->closed[0] = 0;
+        region->closed[1] = 0;
+
+        // Published last, so an opener that sees the magic number sees initialized semaphores.
+        __atomic_store_n(&region->magic, Magic, __ATOMIC_RELEASE);
+
+        return std::unique_ptr<SharedMemoryChannel>(new SharedMemoryChannel(name, region, bytes, true));
+    }
+
+    std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::Open(const std::string &name)
+    {
+        const int descriptor = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+
+        if (descriptor < 0) {
+            throw std::runtime_error("Unable to open " + name + ": " + std::strerror(errno));
+        }
+
+        const off_t bytes = lseek(descriptor, 0, SEEK_END);
+
+        void *address = bytes >= static_cast<off_t>(sizeof(Region))
+                        ? mmap(nullptr, static_cast<std::size_t>(bytes), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0)
+                        : MAP_FAILED;
+
+        close(descriptor);
+
+        if (address == MAP_FAILED) {
+            throw std::runtime_error("Unable to map " + name + ".");
+        }
+
+        auto *region = static_cast<Region *>(address);
+
+        if (__atomic_load_n(&region->magic, __ATOMIC_ACQUIRE) != Magic) {
+            munmap(address, static_cast<std::size_t>(bytes));
+            throw std::runtime_error(name + " is not a channel.");
+        }
+
+        __atomic_store_n(&region->processes[1], static_cast<std::int64_t>(getpid()), __ATOMIC_RELEASE);
+
+        return std::unique_ptr<SharedMemoryChannel>(new SharedMemoryChannel(name, region, static_cast<std::size_t>(bytes), false));
+    }
+
+    SharedMemoryChannel::~SharedMemoryChannel()
+    {
+        __atomic_store_n(&_region->closed[_owner ? 0 : 1], 1u, __ATOMIC_RELEASE);
+
+        munmap(_region, _bytes);
+
+        if (_owner) {
+            shm_unlink(_name.c_str());
+        }
+    }
+
+    const std::size_t SharedMemoryChannel::Capacity() const
+    {
+        return _region->capacity;
+    }
+
+    void SharedMemoryChannel::Send(const std::vector<double> &message)
+    {
+        if (message.size() > Capacity()) {
+            throw std::invalid_argument("Message exceeds the channel capacity.");
+        }
+
+        Mailbox &mailbox = Outbox();
+
+        Wait(&mailbox.empty);
+
+        std::memcpy(Data(mailbox), message.data(), message.size() * sizeof(double));
+        mailbox.length = message.size();
+
+        sem_post(&mailbox.full);
+    }
+
+    std::vector<double> SharedMemoryChannel::Receive()
+    {
+        Mailbox &mailbox = Inbox();
+
+        Wait(&mailbox.full);
+
+        const double *data = Data(mailbox);
+        std::vector<double> message(data, data + mailbox.length);
+
+        sem_post(&mailbox.empty);
+
+        return message;
+    }
+
+    void SharedMemoryChannel::Wait(sem_t *semaphore) const
+    {
+        for (;;) {
+            timespec deadline{};
+            clock_gettime(CLOCK_REALTIME, &deadline);
+
+            deadline.tv_nsec += LivenessInterval * 1000000;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000;
+            deadline.tv_nsec %= 1000000000;
+
+            if (sem_timedwait(semaphore, &deadline) == 0) {
+                return;
+            }
+
+            if (errno == ETIMEDOUT) {
+                // The peer may have posted just before closing; what it sent is still delivered.
+                if (IsPeerClosed()) {
+                    if (sem_trywait(semaphore) == 0) {
+                        return;
+                    }
+
+                    throw std::runtime_error("The peer closed the channel.");
+                }
+            }
+            else if (errno != EINTR) {
+                throw std::runtime_error(std::string("Unable to wait on the channel: ") + std::strerror(errno));
+            }
+        }
+    }
+
+    bool SharedMemoryChannel::IsPeerClosed() const
+    {
+        const int peer = _owner ? 1 : 0;
+
+        if (__atomic_load_n(&_region->closed[peer], __ATOMIC_ACQUIRE) != 0) {
+            return true;
+        }
+
+        // A peer that has not opened its end yet is still expected.
+        const auto process = static_cast<pid_t>(__atomic_load_n(&_region->processes[peer], __ATOMIC_ACQUIRE));
+
+        return process != 0 && HasExited(process);
+    }
+
+    SharedMemoryChannel::Mailbox &SharedMemoryChannel::Outbox() const
+    {
+        return _owner ? _region->forward : _region->backward;
+    }
+
+    SharedMemoryChannel::Mailbox &SharedMemoryChannel::Inbox() const
+    {
+        return _owner ? _region->backward : _region->forward;
+    }
+
+    double *SharedMemoryChannel::Data(const Mailbox &mailbox) const
+    {
+        auto *data = reinterpret_cast<double *>(_region + 1);
+
+        return &mailbox == &_region->forward ? data : data + _region->capacity;
+    }
+}
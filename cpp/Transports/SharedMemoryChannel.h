@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <semaphore.h>
+#include "IChannel.h"
+
+namespace Transports {
+
+    /// <summary>
+    /// A channel between two processes on one machine through a named POSIX shared memory region.
+    /// </summary>
+    /// <remarks>
+    /// The region holds one mailbox per direction, each guarded by a pair of process-shared semaphores, so a message is
+    /// copied once into the region and once out of it. A mailbox holds one message of up to the capacity given at
+    /// creation; a sender waits until the previous message has been received.
+    ///
+    /// The region also records the process of each end. A waiting end checks every 100 ms whether its peer has
+    /// destroyed its end or exited, and if so throws rather than waiting forever, so a crashed peer is reported. Messages
+    /// sent before the peer went away are still received.
+    /// </remarks>
+    class SharedMemoryChannel : public IChannel {
+    public:
+
+        /// <summary>
+        /// Creates the region and returns the creating end. The name is removed when this end is destroyed.
+        /// </summary>
+        /// <param name="name">
+        /// The name of the region, starting with a slash (see shm_open).
+        /// </param>
+        /// <param name="capacity">
+        /// The largest message, in values.
+        /// </param>
+        static std::unique_ptr<SharedMemoryChannel> Create(const std::string &name, std::size_t capacity);
+
+        /// <summary>
+        /// Opens a region created by <see cref="Create"/> and returns the other end.
+        /// </summary>
+        static std::unique_ptr<SharedMemoryChannel> Open(const std::string &name);
+
+        SharedMemoryChannel(const SharedMemoryChannel &) = delete;
+
+        SharedMemoryChannel &operator=(const SharedMemoryChannel &) = delete;
+
+        ~SharedMemoryChannel() override;
+
+        const std::size_t Capacity() const;
+
+        /// <exception cref="std::invalid_argument">
+        /// The message exceeds the <see cref="Capacity"/>.
+        /// </exception>
+        /// <exception cref="std::runtime_error">
+        /// The peer closed the channel before receiving the previous message.
+        /// </exception>
+        void Send(const std::vector<double> &message) override;
+
+        std::vector<double> Receive() override;
+
+    private:
+
+        struct Region;
+
+        struct Mailbox;
+
+        SharedMemoryChannel(std::string name, Region *region, std::size_t bytes, bool owner);
+
+        Mailbox &Outbox() const;
+
+        Mailbox &Inbox() const;
+
+        double *Data(const Mailbox &mailbox) const;
+
+        /// <summary>
+        /// Waits on a semaphore of the region, throwing once the peer has closed the channel.
+        /// </summary>
+        void Wait(sem_t *semaphore) const;
+
+        bool IsPeerClosed() const;
+
+        const std::string _name;
+
+        Region *_region;
+
+        const std::size_t _bytes;
+
+        const bool _owner;
+    };
+}
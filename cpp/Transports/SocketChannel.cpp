@@ -0,0 +1,188 @@
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "SocketChannel.h"
+
+namespace Transports {
+    namespace {
+        void Write(const int descriptor, const void *data, std::size_t length)
+        {
+            const auto *bytes = static_cast<const char *>(data);
+
+            while (length > 0) {
+                const ssize_t count = send(descriptor, bytes, length, MSG_NOSIGNAL);
+
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count <= 0) {
+                    throw std::runtime_error(std::string("Unable to send: ") + std::strerror(errno));
+                }
+
+                bytes += count;
+                length -= static_cast<std::size_t>(count);
+            }
+        }
+
+        void Read(const int descriptor, void *data, std::size_t length)
+        {
+            auto *bytes = static_cast<char *>(data);
+
+            while (length > 0) {
+                const ssize_t count = recv(descriptor, bytes, length, 0);
+
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count == 0) {
+                    throw std::runtime_error("The channel was closed by its peer.");
+                }
+                if (count < 0) {
+                    throw std::runtime_error(std::string("Unable to receive: ") + std::strerror(errno));
+                }
+
+                bytes += count;
+                length -= static_cast<std::size_t>(count);
+            }
+        }
+
+        void DisableDelay(const int descriptor)
+        {
+            // Messages are request/response; waiting to coalesce small frames only adds latency.
+            const int enabled = 1;
+            setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+        }
+    }
+
+    SocketChannel::SocketChannel(const int descriptor)
+            : _descriptor(descriptor)
+    {
+        if (_descriptor < 0) {
+            throw std::invalid_argument("The socket is not valid.");
+        }
+    }
+
+    std::unique_ptr<SocketChannel> SocketChannel::Connect(const std::string &host, const std::uint16_t port)
+    {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo *addresses = nullptr;
+
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+            throw std::runtime_error("Unable to resolve " + host + ".");
+        }
+
+        for (const addrinfo *address = addresses; address != nullptr; address = address->ai_next) {
+            const int descriptor = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+
+            if (descriptor < 0) {
+                continue;
+            }
+
+            if (connect(descriptor, address->ai_addr, address->ai_addrlen) == 0) {
+                freeaddrinfo(addresses);
+                DisableDelay(descriptor);
+                return std::make_unique<SocketChannel>(descriptor);
+            }
+
+            close(descriptor);
+        }
+
+        freeaddrinfo(addresses);
+
+        throw std::runtime_error("Unable to connect to " + host + ":" + std::to_string(port) + ".");
+    }
+
+    SocketChannel::~SocketChannel()
+    {
+        close(_descriptor);
+    }
+
+    void SocketChannel::Send(const std::vector<double> &message)
+    {
+        if (message.size() > MaxMessage) {
+            throw std::invalid_argument("Message exceeds the channel capacity.");
+        }
+
+        const auto count = static_cast<std::uint64_t>(message.size());
+
+        Write(_descriptor, &count, sizeof(count));
+        Write(_descriptor, message.data(), message.size() * sizeof(double));
+    }
+
+    std::vector<double> SocketChannel::Receive()
+    {
+        std::uint64_t count = 0;
+
+        Read(_descriptor, &count, sizeof(count));
+
+        // The length comes from the peer; a corrupt frame must not turn into an arbitrary allocation.
+        if (count > MaxMessage) {
+            throw std::runtime_error("Received a message longer than the channel allows.");
+        }
+
+        std::vector<double> message(count);
+
+        Read(_descriptor, message.data(), message.size() * sizeof(double));
+
+        return message;
+    }
+
+    SocketListener::SocketListener(const std::uint16_t port, const std::string &host)
+            : _descriptor(socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0)),
+              _port(port)
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+
+        const int enabled = 1;
+        setsockopt(_descriptor, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+
+        socklen_t length = sizeof(address);
+
+        if (_descriptor < 0
+            || inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1
+            || bind(_descriptor, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0
+            || listen(_descriptor, SOMAXCONN) != 0
+            || getsockname(_descriptor, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+            const std::string reason = std::strerror(errno);
+
+            if (_descriptor >= 0) {
+                close(_descriptor);
+            }
+
+            throw std::runtime_error("Unable to listen on " + host + ": " + reason);
+        }
+
+        _port = ntohs(address.sin_port);
+    }
+
+    SocketListener::~SocketListener()
+    {
+        close(_descriptor);
+    }
+
+    std::unique_ptr<SocketChannel> SocketListener::Accept()
+    {
+        while (true) {
+            const int descriptor = accept4(_descriptor, nullptr, nullptr, SOCK_CLOEXEC);
+
+            if (descriptor >= 0) {
+                DisableDelay(descriptor);
+                return std::make_unique<SocketChannel>(descriptor);
+            }
+            if (errno != EINTR) {
+                throw std::runtime_error(std::string("Unable to accept: ") + std::strerror(errno));
+            }
+        }
+    }
+}
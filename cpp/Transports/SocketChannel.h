@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "IChannel.h"
+
+namespace Transports {
+
+    /// <summary>
+    /// A channel over a connected stream socket. Each message is framed by its length.
+    /// </summary>
+    class SocketChannel : public IChannel {
+    public:
+
+        /// <summary>
+        /// Takes ownership of a connected socket.
+        /// </summary>
+        explicit SocketChannel(int descriptor);
+
+        /// <summary>
+        /// The largest message, in values: 512 MiB, enough for the normal equations of about 8000 variables.
+        /// </summary>
+        static constexpr std::size_t MaxMessage = std::size_t(1) << 26;
+
+        /// <summary>
+        /// Connects to a <see cref="SocketListener"/> over TCP.
+        /// </summary>
+        static std::unique_ptr<SocketChannel> Connect(const std::string &host, std::uint16_t port);
+
+        SocketChannel(const SocketChannel &) = delete;
+
+        SocketChannel &operator=(const SocketChannel &) = delete;
+
+        ~SocketChannel() override;
+
+        /// <exception cref="std::invalid_argument">
+        /// The message exceeds <see cref="MaxMessage"/>.
+        /// </exception>
+        void Send(const std::vector<double> &message) override;
+
+        /// <exception cref="std::runtime_error">
+        /// The peer closed the channel, or announced a message longer than <see cref="MaxMessage"/>.
+        /// </exception>
+        std::vector<double> Receive() override;
+
+    private:
+
+        const int _descriptor;
+    };
+
+    /// <summary>
+    /// Accepts TCP connections as <see cref="SocketChannel"/> instances.
+    /// </summary>
+    class SocketListener {
+    public:
+
+        /// <param name="port">
+        /// The port to listen on, or 0 to let the system choose one (see <see cref="Port"/>).
+        /// </param>
+        /// <param name="host">
+        /// The local address to bind.
+        /// </param>
+        explicit SocketListener(std::uint16_t port = 0, const std::string &host = "127.0.0.1");
+
+        SocketListener(const SocketListener &) = delete;
+
+        SocketListener &operator=(const SocketListener &) = delete;
+
+        ~SocketListener();
+
+        const std::uint16_t Port() const
+        { return _port; }
+
+        /// <summary>
+        /// Waits for the next connection.
+        /// </summary>
+        std::unique_ptr<SocketChannel> Accept();
+
+    private:
+
+        int _descriptor;
+
+        std::uint16_t _port;
+    };
+}
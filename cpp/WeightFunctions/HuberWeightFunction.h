@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "IWeightFunction.h"
+
+namespace WeightFunctions {
+
+    /// <summary>
+    /// Huber's weight function: least squares for standardized residuals within c of zero, least absolute deviations
+    /// beyond. The default c = 1.345 is 95% efficient for Gaussian errors.
+    /// </summary>
+    class HuberWeightFunction : public IWeightFunction {
+    public:
+
+        explicit HuberWeightFunction(const double tuning = 1.345)
+                : _tuning(tuning)
+        {
+        }
+
+        const double Tuning() const override
+        { return _tuning; }
+
+        const std::vector<double> Psi(const std::vector<double> &residuals) const override
+        {
+            std::vector<double> result(residuals.size());
+
+            std::transform(
+                    residuals.begin(),
+                    residuals.end(),
+                    result.begin(),
+                    [c = _tuning](double u) -> double { return std::min(std::max(u, -c), c); });
+
+            return result;
+        }
+
+        const std::vector<double> PsiDerivative(const std::vector<double> &residuals) const override
+        {
+            std::vector<double> result(residuals.size());
+
+            std::transform(
+                    residuals.begin(),
+                    residuals.end(),
+                    result.begin(),
+                    [c = _tuning](double u) -> double { return std::abs(u) <= c ? 1.0 : 0.0; });
+
+            return result;
+        }
+
+        const std::vector<double> Weight(const std::vector<double> &residuals) const override
+        {
+            std::vector<double> result(residuals.size());
+
+            std::transform(
+                    residuals.begin(),
+                    residuals.end(),
+                    result.begin(),
+                    [c = _tuning](double u) -> double { return std::abs(u) <= c ? 1.0 : c / std::abs(u); });
+
+            return result;
+        }
+
+    private:
+
+        double _tuning;
+    };
+}
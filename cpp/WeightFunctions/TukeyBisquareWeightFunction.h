@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "IWeightFunction.h"
+
+namespace WeightFunctions {
+
+    /// <summary>
+    /// Tukey's bisquare weight function, which gives standardized residuals beyond c no weight at all. The default
+    /// c = 4.685 is 95% efficient for Gaussian errors. The objective is not convex, so a fit may converge to a local
+    /// minimum near its least squares start.
+    /// </summary>
+    class TukeyBisquareWeightFunction : public IWeightFunction {
+    public:
+
+        explicit TukeyBisquareWeightFunction(const double tuning = 4.685)
+                : _tuning(tuning)
+        {
+        }
+
+        const double Tuning() const override
+        { return _tuning; }
+
+        const std::vector<double> Psi(const std::vector<double> &residuals) const override
+        {
+            std::vector<double> result(residuals.size());
+
+            std::transform(
+                    residuals.begin(),
+                    residuals.end(),
+                    result.begin(),
+                    [c = _tuning](double u) -> double {
+                        const double t = 1.0 - (u / c) * (u / c);
+                        return std::abs(u) <= c ? u * t * t : 0.0;
+                    });
+
+            return result;
+        }
+
+        const std::vector<double> PsiDerivative(const std::vector<double> &residuals) const override
+        {
+            std::vector<double> result(residuals.size());
+
+            std::transform(
+                    residuals.begin(),
+                    residuals.end(),
+                    result.begin(),
+                    [c = _tuning](double u) -> double {
+                        const double r = (u / c) * (u / c);
+                        return std::abs(u) <= c ? (1.0 - r) * (1.0 - 5.0 * r) : 0.0;
+                    });
+
+            return result;
+        }
+
+        const std::vector<double> Weight(const std::vector<double> &residuals) const override
+        {
+            std::vector<double> result(residuals.size());
+
+            std::transform(
+                    residuals.begin(),
+                    residuals.end(),
+                    result.begin(),
+                    [c = _tuning](double u) -> double {
+                        const double t = 1.0 - (u / c) * (u / c);
+                        return std::abs(u) <= c ? t * t : 0.0;
+                    });
+
+            return result;
+        }
+
+    private:
+
+        double _tuning;
+    };
+}
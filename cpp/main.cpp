@@ -1,7 +1,48 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "c_caller.h"
+#include "ColumnPlan.h"
+#include "CompiledScorer.h"
+#include "Equilibration.h"
+#include "FitCache.h"
 #include "GeneralizedLinearModel.h"
+#include "GramPipeline.h"
+#include "HuberWeightFunction.h"
+#include "InteractionColumns.h"
+#include "Kernels.h"
+#include "LinearMixedModel.h"
+#include "ModelRegistry.h"
+#include "PanelLinearModel.h"
 #include "PoissonDistribution.h"
+#include "QuantileRegressionModel.h"
+#if defined(__linux__)
+#include "ScoringServer.h"
+#endif
+#include "ShardWorker.h"
+#include "SharedMemoryChannel.h"
+#include "SolverMixedPrecision.h"
+#include "SocketChannel.h"
+#include "SplineBasis.h"
+#include "TukeyBisquareWeightFunction.h"
+#include "WeightedGram.h"
+#include "WildClusterBootstrap.h"
 #include "Factorial.h"
 
 using RegressionModels::GeneralizedLinearModel;
@@ -9,31 +50,1096 @@ using Distributions::PoissonDistribution;
 
 int main()
 {
+    // A Poisson model fitted by three forked loopback workers over each transport, against the single-process fit. A
+    // forked child has none of its parent's threads, so this runs before anything starts the library thread pool.
+    std::mt19937_64 shardGenerator(20180102);
+    std::normal_distribution<double> shardNormal;
+
+    const std::size_t shardRows = 30000;
+    const std::size_t shardCount = 3;
+
+    std::vector<std::vector<double>> shardDesign(shardRows);
+    std::vector<double> shardResponse(shardRows);
+    std::vector<double> shardWeights(shardRows, 1.0);
+
+    for (std::size_t i = 0; i < shardRows; i++) {
+        shardDesign[i] = {shardNormal(shardGenerator), shardNormal(shardGenerator), shardNormal(shardGenerator)};
+        shardResponse[i] = std::poisson_distribution<int>(std::exp(0.5 + 0.3 * shardDesign[i][0] - 0.2 * shardDesign[i][1]))(shardGenerator);
+    }
+
+    // Serves rows [shard * n / count, (shard + 1) * n / count) over a channel opened in the child, then exits. A masked
+    // worker masks every seventh row out of its design.
+    const auto forkWorker = [&](const std::size_t shard, const bool masked, const std::function<std::unique_ptr<IChannel>()> &open) {
+        std::cout.flush();
+
+        const pid_t child = fork();
+
+        if (child != 0) {
+            return child;
+        }
+
+        int status = 0;
+
+        try {
+            const std::size_t first = shard * shardRows / shardCount;
+            const std::size_t last = (shard + 1) * shardRows / shardCount;
+
+            DesignMatrix workerDesign(std::vector<std::vector<double>>(shardDesign.begin() + first, shardDesign.begin() + last), true);
+
+            if (masked) {
+                ValidityMask workerRows(last - first);
+
+                for (std::size_t i = first; i < last; i++) {
+                    if (i % 7 == 0) {
+                        workerRows.Clear(i - first);
+                    }
+                }
+
+                workerDesign.SetMask(workerRows);
+            }
+
+            const RegressionModels::ShardWorker worker(
+                    std::move(workerDesign),
+                    std::vector<double>(shardResponse.begin() + first, shardResponse.begin() + last),
+                    std::vector<double>(shardWeights.begin() + first, shardWeights.begin() + last),
+                    std::make_unique<PoissonDistribution>());
+
+            worker.Serve(*open());
+        }
+        catch (...) {
+            status = 1;
+        }
+
+        _exit(status);
+    };
+
+    std::vector<pid_t> shardProcesses;
+    std::vector<std::unique_ptr<IChannel>> memoryChannels;
+    std::vector<std::unique_ptr<IChannel>> socketChannels;
+
+    for (std::size_t shard = 0; shard < shardCount; shard++) {
+        const std::string name = "/adm_shard_" + std::to_string(getpid()) + "_" + std::to_string(shard);
+
+        memoryChannels.push_back(Transports::SharedMemoryChannel::Create(name, 64));
+        shardProcesses.push_back(forkWorker(shard, false, [name]() { return std::unique_ptr<IChannel>(Transports::SharedMemoryChannel::Open(name)); }));
+    }
+
+    // Forked now, before the library thread pool starts, since a child inherits none of its threads.
+    std::vector<std::unique_ptr<IChannel>> maskedChannels;
+
+    for (std::size_t shard = 0; shard < shardCount; shard++) {
+        const std::string name = "/adm_shard_" + std::to_string(getpid()) + "_masked_" + std::to_string(shard);
+
+        maskedChannels.push_back(Transports::SharedMemoryChannel::Create(name, 64));
+        shardProcesses.push_back(forkWorker(shard, true, [name]() { return std::unique_ptr<IChannel>(Transports::SharedMemoryChannel::Open(name)); }));
+    }
+
+    Transports::SocketListener shardListener;
+
+    for (std::size_t shard = 0; shard < shardCount; shard++) {
+        const std::uint16_t port = shardListener.Port();
+
+        shardProcesses.push_back(forkWorker(shard, false, [port]() { return std::unique_ptr<IChannel>(Transports::SocketChannel::Connect("127.0.0.1", port)); }));
+        socketChannels.push_back(shardListener.Accept());
+    }
+
+    // A worker that dies before answering, which the coordinator must report rather than wait for.
+    const std::string crashedName = "/adm_shard_" + std::to_string(getpid()) + "_crashed";
+    std::unique_ptr<IChannel> crashedChannel = Transports::SharedMemoryChannel::Create(crashedName, 64);
+
+    std::cout.flush();
+
+    const pid_t crashedProcess = fork();
+
+    if (crashedProcess == 0) {
+        Transports::SharedMemoryChannel::Open(crashedName).release();
+        _exit(1);
+    }
+
+    const auto toShards = [](const std::vector<std::unique_ptr<IChannel>> &channels) {
+        std::vector<IChannel *> shards;
+
+        for (const std::unique_ptr<IChannel> &channel : channels) {
+            shards.push_back(channel.get());
+        }
+
+        return shards;
+    };
+
+    const GeneralizedLinearModel memoryShardedModel = GeneralizedLinearModel::FitSharded(toShards(memoryChannels), std::make_unique<PoissonDistribution>());
+    const GeneralizedLinearModel socketShardedModel = GeneralizedLinearModel::FitSharded(toShards(socketChannels), std::make_unique<PoissonDistribution>());
+    const GeneralizedLinearModel maskedShardedModel = GeneralizedLinearModel::FitSharded(toShards(maskedChannels), std::make_unique<PoissonDistribution>());
+
+    std::string crashReport = "not reported";
+
+    try {
+        GeneralizedLinearModel::FitSharded({crashedChannel.get()}, std::make_unique<PoissonDistribution>());
+    }
+    catch (const std::runtime_error &error) {
+        crashReport = error.what();
+    }
+
+    shardProcesses.push_back(crashedProcess);
+
+    int failedWorkers = 0;
+
+    for (const pid_t process : shardProcesses) {
+        int status = 0;
+        waitpid(process, &status, 0);
+        failedWorkers += WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1;
+    }
+
+    const GeneralizedLinearModel unshardedModel(shardDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>(), true);
+
+    double memoryDifference = 0.0;
+    double socketDifference = 0.0;
+
+    for (std::size_t j = 0; j < unshardedModel.VariableCount(); j++) {
+        memoryDifference = std::max(memoryDifference, std::abs(memoryShardedModel.Coefficients()[j] - unshardedModel.Coefficients()[j]));
+        socketDifference = std::max(socketDifference, std::abs(socketShardedModel.Coefficients()[j] - unshardedModel.Coefficients()[j]));
+    }
+
+    std::cout << "sharded fit: shared memory " << memoryDifference << ", sockets " << socketDifference << " from the single-process fit, "
+              << "crashed worker: " << crashReport << " (" << failedWorkers << " worker failed)" << std::endl;
+
+    // The same fit with missing responses, scattered and in a run of whole blocks, is the fit of the compacted data.
+    std::vector<double> missingResponse(shardResponse);
+    std::vector<std::vector<double>> compactedDesign;
+    std::vector<double> compactedResponse;
+
+    for (std::size_t i = 0; i < shardRows; i++) {
+        if (i % 7 == 3 || (i >= 4096 && i < 6144)) {
+            missingResponse[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+        else {
+            compactedDesign.push_back(shardDesign[i]);
+            compactedResponse.push_back(shardResponse[i]);
+        }
+    }
+
+    const GeneralizedLinearModel missingModel(shardDesign, missingResponse, shardWeights, std::make_unique<PoissonDistribution>(), true);
+    const GeneralizedLinearModel compactedModel(compactedDesign, compactedResponse, std::vector<double>(compactedResponse.size(), 1.0), std::make_unique<PoissonDistribution>(), true);
+
+    double missingDifference = 0.0;
+
+    for (std::size_t j = 0; j < compactedModel.VariableCount(); j++) {
+        missingDifference = std::max(missingDifference, std::abs(missingModel.Coefficients()[j] - compactedModel.Coefficients()[j]));
+    }
+
+    std::cout << "missing responses: " << missingModel.ObservationCount() << " of " << shardRows << " observations valid, "
+              << missingDifference << " from the compacted fit (deviance " << missingModel.Deviance() << " vs " << compactedModel.Deviance() << ")" << std::endl;
+
+    // A cache of two fits. A repeat is a hit; masking rows out is a new key, even against a design whose rows there
+    // really are zero; and a third fit evicts the least recently used, so fitting the first design again is a miss.
+    RegressionModels::FitCache fitCache(std::string(), 2);
+
+    const DesignMatrix cachedDesign(shardDesign);
+
+    DesignMatrix maskedDesign(shardDesign);
+    ValidityMask keptRows(shardRows);
+    std::vector<std::vector<double>> zeroedRows(shardDesign);
+
+    for (std::size_t i = 0; i < shardRows; i += 7) {
+        keptRows.Clear(i);
+        zeroedRows[i].assign(zeroedRows[i].size(), 0.0);
+    }
+
+    maskedDesign.SetMask(keptRows);
+
+    const DesignMatrix zeroedDesign(zeroedRows);
+
+    fitCache.Fit(cachedDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>());
+    fitCache.Fit(cachedDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>());
+    fitCache.Fit(maskedDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>());
+    fitCache.Fit(zeroedDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>());
+    fitCache.Fit(cachedDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>());
+
+    const PoissonDistribution cachedDistribution;
+    const bool keysDiffer =
+            RegressionModels::FitCache::Key(maskedDesign, shardResponse, shardWeights, cachedDistribution, RegressionModels::FitOptions())
+            != RegressionModels::FitCache::Key(zeroedDesign, shardResponse, shardWeights, cachedDistribution, RegressionModels::FitOptions());
+
+    std::cout << "fit cache: " << fitCache.Hits() << " hit, " << fitCache.Misses() << " misses (expected 1 and 4), masked and zeroed keys "
+              << (keysDiffer ? "differ" : "collide") << std::endl;
+
+    // The same rows masked out of the shards of a sharded fit, of a bootstrap and of a panel are the fits of the kept
+    // rows: none may count, label or accumulate a masked row.
+    std::vector<std::vector<double>> keptDesign;
+    std::vector<double> keptResponse;
+    std::vector<long> maskedClusters(shardRows);
+    std::vector<long> keptClusters;
+    std::vector<long> maskedEntities(shardRows);
+    std::vector<long> keptEntities;
+
+    for (std::size_t i = 0; i < shardRows; i++) {
+        maskedClusters[i] = static_cast<long>(i % 40);
+        maskedEntities[i] = static_cast<long>(i / 16);
+
+        if (keptRows[i]) {
+            keptDesign.push_back(shardDesign[i]);
+            keptResponse.push_back(shardResponse[i]);
+            keptClusters.push_back(maskedClusters[i]);
+            keptEntities.push_back(maskedEntities[i]);
+        }
+    }
+
+    const std::vector<double> keptWeights(keptResponse.size(), 1.0);
+
+    const GeneralizedLinearModel keptModel(keptDesign, keptResponse, keptWeights, std::make_unique<PoissonDistribution>(), true);
+
+    DesignMatrix maskedBootstrapDesign(shardDesign, true);
+    maskedBootstrapDesign.SetMask(keptRows);
+
+    const RegressionModels::BootstrapResult maskedBootstrap =
+            RegressionModels::WildClusterBootstrap(maskedBootstrapDesign, shardResponse, shardWeights, maskedClusters).Test(1, 0.0, RegressionModels::BootstrapOptions{999});
+    const RegressionModels::BootstrapResult keptBootstrap =
+            RegressionModels::WildClusterBootstrap(DesignMatrix(keptDesign, true), keptResponse, keptWeights, keptClusters).Test(1, 0.0, RegressionModels::BootstrapOptions{999});
+
+    const RegressionModels::PanelLinearModel maskedPanel(maskedDesign, shardResponse, maskedEntities, RegressionModels::PanelEstimator::RandomEffects);
+    const RegressionModels::PanelLinearModel keptPanel(DesignMatrix(keptDesign), keptResponse, keptEntities, RegressionModels::PanelEstimator::RandomEffects);
+
+    double maskedShardedDifference = 0.0;
+    double maskedPanelDifference = 0.0;
+
+    for (std::size_t j = 0; j < keptModel.VariableCount(); j++) {
+        maskedShardedDifference = std::max(maskedShardedDifference, std::abs(maskedShardedModel.Coefficients()[j] - keptModel.Coefficients()[j]));
+        maskedPanelDifference = std::max(maskedPanelDifference, std::abs(maskedPanel.Coefficients()[j] - keptPanel.Coefficients()[j]));
+    }
+
+    std::cout << "masked rows: sharded fit " << maskedShardedDifference << " from the kept rows (" << maskedShardedModel.ObservationCount() << " vs "
+              << keptModel.ObservationCount() << " observations, " << maskedShardedModel.DegreesOfFreedom() << " vs " << keptModel.DegreesOfFreedom()
+              << " degrees of freedom), bootstrap t = " << maskedBootstrap.Statistic << " vs " << keptBootstrap.Statistic << " (p = " << maskedBootstrap.PValue
+              << " vs " << keptBootstrap.PValue << "), panel " << maskedPanelDifference << " (" << maskedPanel.ObservationCount() << " vs "
+              << keptPanel.ObservationCount() << " observations, " << maskedPanel.EntityCount() << " vs " << keptPanel.EntityCount() << " entities)" << std::endl;
+
+    std::string maskedRejection = "accepted";
+
+    try {
+        const RegressionModels::QuantileRegressionModel rejected(maskedBootstrapDesign, shardResponse);
+    }
+    catch (const std::invalid_argument &error) {
+        maskedRejection = error.what();
+    }
+
+    std::cout << "masked quantile regression: " << maskedRejection << std::endl;
+
+    // A fit canceled after its second iteration and resumed from its checkpoint ends where the uninterrupted fit does.
+    // Resuming the checkpoint of a fit that ran out of iterations runs none, but must still leave a covariance.
+    const DesignMatrix resumableDesign(shardDesign, true);
+    const GeneralizedLinearModel uninterruptedModel(resumableDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>());
+
+    RegressionModels::FitOptions checkpointOptions;
+    checkpointOptions.CheckpointPath = "/tmp/ad_mathematics_" + std::to_string(getpid()) + ".admc";
+
+    // Copies of a token share its state, so the interrupted fit gets its own.
+    RegressionModels::FitOptions interruptedOptions(checkpointOptions);
+    interruptedOptions.Cancellation = Threading::CancellationToken();
+    interruptedOptions.Progress = [token = interruptedOptions.Cancellation](const RegressionModels::FitProgress &progress) {
+        if (progress.Iteration == 2) {
+            token.Cancel();
+        }
+    };
+
+    std::string interruption = "not canceled";
+
+    try {
+        GeneralizedLinearModel(resumableDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>(), interruptedOptions);
+    }
+    catch (const Threading::OperationCanceledException &) {
+        interruption = "canceled";
+    }
+
+    const GeneralizedLinearModel resumedModel(resumableDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>(), checkpointOptions);
+
+    double resumedDifference = 0.0;
+
+    for (std::size_t j = 0; j < resumedModel.VariableCount(); j++) {
+        resumedDifference = std::max(resumedDifference, std::abs(resumedModel.Coefficients()[j] - uninterruptedModel.Coefficients()[j]));
+        resumedDifference = std::max(resumedDifference, std::abs(resumedModel.StandardErrorsOls()[j] - uninterruptedModel.StandardErrorsOls()[j]));
+    }
+
+    RegressionModels::FitOptions exhaustedOptions(checkpointOptions);
+    exhaustedOptions.MaxIterations = 2;
+
+    const GeneralizedLinearModel exhaustedModel(resumableDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>(), exhaustedOptions);
+    const GeneralizedLinearModel reloadedModel(resumableDesign, shardResponse, shardWeights, std::make_unique<PoissonDistribution>(), exhaustedOptions);
+
+    std::remove(checkpointOptions.CheckpointPath.c_str());
+
+    std::cout << "resumed fit: " << interruption << " after 2 of " << uninterruptedModel.Iterations() << " iterations, resumed to "
+              << resumedModel.Iterations() << ", " << resumedDifference << " from the uninterrupted fit; exhausted fit reloaded after "
+              << exhaustedModel.Iterations() << " iterations with a " << reloadedModel.Covariance().size() << "-entry covariance" << std::endl;
+
+    // The same Poisson fit through the C interface, called from C on a row-major copy of the design.
+    std::vector<double> rowMajorDesign;
+
+    for (const std::vector<double> &row : shardDesign) {
+        rowMajorDesign.insert(rowMajorDesign.end(), row.begin(), row.end());
+    }
+
+    const std::size_t cColumns = shardDesign[0].size();
+
+    std::vector<double> cCoefficients(cColumns + 1);
+    std::vector<double> cStandardErrors(cColumns + 1);
+    std::vector<double> cCovariance((cColumns + 1) * (cColumns + 1));
+
+    const adm_status cStatus = c_caller_fit(rowMajorDesign.data(), shardRows, cColumns, shardResponse.data(), ADM_FAMILY_POISSON, cCoefficients.data(), cStandardErrors.data(), cCovariance.data());
+
+    double cDifference = 0.0;
+
+    for (std::size_t j = 0; cStatus == ADM_OK && j <= cColumns; j++) {
+        cDifference = std::max(cDifference, std::abs(cCoefficients[j] - unshardedModel.Coefficients()[j]));
+        cDifference = std::max(cDifference, std::abs(cStandardErrors[j] - unshardedModel.StandardErrorsOls()[j]));
+    }
+
+    std::cout << "C interface: " << (cStatus == ADM_OK ? "ok" : adm_last_error()) << ", " << cDifference
+              << " from the C++ coefficients and standard errors" << std::endl;
+
+#if defined(__linux__)
+    // The scoring server end to end over its socket: round trips of single requests, first alone and then while a
+    // second client floods the server without reading any reply, which must stall only that client.
+    Serving::ModelRegistry servingRegistry;
+    servingRegistry.Publish("poisson", unshardedModel.Snapshot());
+
+    const RegressionModels::ModelSnapshot servingSnapshot = unshardedModel.Snapshot();
+    const std::string servingPath = "/tmp/adm_scoring_" + std::to_string(getpid()) + ".sock";
+
+    Serving::ScoringServer scoringServer(servingPath, servingRegistry);
+    std::thread servingThread([&]() { scoringServer.Run(); });
+
+    const auto connectClient = [&]() {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, servingPath.c_str(), sizeof(address.sun_path) - 1);
+
+        for (int attempt = 0; attempt < 1000; attempt++) {
+            const int client = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+            if (connect(client, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0) {
+                return client;
+            }
+
+            close(client);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return -1;
+    };
+
+    const auto encodeRequest = [](std::vector<char> &frame, const std::uint64_t id, const std::string &name, const std::vector<double> &values) {
+        const auto nameLength = static_cast<std::uint16_t>(name.size());
+        const auto valueCount = static_cast<std::uint16_t>(values.size());
+        const std::size_t offset = frame.size();
+
+        frame.resize(offset + 12 + name.size() + values.size() * sizeof(double));
+
+        std::memcpy(frame.data() + offset, &id, 8);
+        std::memcpy(frame.data() + offset + 8, &nameLength, 2);
+        std::memcpy(frame.data() + offset + 10, &valueCount, 2);
+        std::memcpy(frame.data() + offset + 12, name.data(), name.size());
+        std::memcpy(frame.data() + offset + 12 + name.size(), values.data(), values.size() * sizeof(double));
+    };
+
+    // Scores rows one request at a time, returning the sorted round-trip times in microseconds and the largest error.
+    const auto roundTrips = [&](const int client, const std::size_t count, double &error) {
+        std::vector<double> times;
+        std::vector<char> frame;
+
+        for (std::size_t i = 0; i < count; i++) {
+            const std::vector<double> observation = {1.0, shardDesign[i][0], shardDesign[i][1], shardDesign[i][2]};
+
+            frame.clear();
+            encodeRequest(frame, i, "poisson", observation);
+
+            const auto start = std::chrono::steady_clock::now();
+
+            char reply[17];
+            std::size_t received = 0;
+
+            if (send(client, frame.data(), frame.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(frame.size())) {
+                break;
+            }
+
+            while (received < sizeof(reply)) {
+                const ssize_t bytes = recv(client, reply + received, sizeof(reply) - received, 0);
+
+                if (bytes <= 0) {
+                    return times;
+                }
+
+                received += static_cast<std::size_t>(bytes);
+            }
+
+            times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+
+            double value;
+            std::memcpy(&value, reply + 9, sizeof(value));
+
+            error = std::max(error, reply[8] == 0 ? std::abs(value - servingSnapshot.Predict(observation.data())) : std::numeric_limits<double>::infinity());
+        }
+
+        std::sort(times.begin(), times.end());
+
+        return times;
+    };
+
+    const int servingClient = connectClient();
+
+    double servingError = 0.0;
+    const std::vector<double> quietTimes = roundTrips(servingClient, 2000, servingError);
+
+    // The flooding client writes without blocking until its socket is full, so the server has stopped reading it.
+    const int floodingClient = connectClient();
+    fcntl(floodingClient, F_SETFL, O_NONBLOCK);
+
+    std::vector<char> flood;
+
+    for (std::size_t i = 0; i < 200000; i++) {
+        encodeRequest(flood, i, "poisson", {1.0, 0.1, 0.2, 0.3});
+    }
+
+    std::size_t flooded = 0;
+
+    for (int stalls = 0; stalls < 100 && flooded < flood.size(); ) {
+        const ssize_t bytes = send(floodingClient, flood.data() + flooded, flood.size() - flooded, MSG_NOSIGNAL);
+
+        if (bytes > 0) {
+            flooded += static_cast<std::size_t>(bytes);
+        }
+        else {
+            stalls++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    const std::vector<double> floodedTimes = roundTrips(servingClient, 2000, servingError);
+
+    close(floodingClient);
+    close(servingClient);
+
+    scoringServer.Stop();
+    servingThread.join();
+
+    const auto percentile = [](const std::vector<double> &times, const double p) {
+        return times.empty() ? std::numeric_limits<double>::quiet_NaN() : times[static_cast<std::size_t>(p * (times.size() - 1))];
+    };
+
+    std::cout << "scoring server: p50 " << percentile(quietTimes, 0.5) << " us, p99 " << percentile(quietTimes, 0.99) << " us; "
+              << "beside a client that wrote " << flooded / (12 + 7 + 32) << " requests and read no reply: p50 "
+              << percentile(floodedTimes, 0.5) << " us, p99 " << percentile(floodedTimes, 0.99) << " us ("
+              << quietTimes.size() + floodedTimes.size() << " replies, largest error " << servingError << ")" << std::endl;
+#endif
+
+    // Readers pin the registry, with a nested view inside each outer one, while a writer publishes version after version.
+    // Every snapshot has equal coefficients, so a reclaimed one read through a stale pointer would show up as a mismatch.
+    Serving::ModelRegistry swappingRegistry;
+    swappingRegistry.Publish("m", RegressionModels::ModelSnapshot(RegressionModels::LinkKind::Identity, {0.0, 0.0}));
+
+    std::atomic<bool> swapping(true);
+    std::atomic<std::size_t> swappingReads(0);
+    std::atomic<std::size_t> swappingMismatches(0);
+    std::vector<std::thread> swappingReaders;
+
+    for (int t = 0; t < 4; t++) {
+        swappingReaders.emplace_back(
+                [&]() {
+                    Serving::ModelRegistry::Reader reader(swappingRegistry);
+
+                    const double first[] = {1.0, 0.0};
+                    const double second[] = {0.0, 1.0};
+
+                    while (swapping.load()) {
+                        const Serving::ModelRegistry::View outer = reader.Read();
+                        const RegressionModels::ModelSnapshot *pinned = outer.Find("m");
+
+                        {
+                            const Serving::ModelRegistry::View inner = reader.Read();
+                            const RegressionModels::ModelSnapshot *latest = inner.Find("m");
+
+                            swappingMismatches += latest->Predict(first) != latest->Predict(second) ? 1 : 0;
+                        }
+
+                        // The outer view is still open, so its snapshot must survive the inner view and any publishing.
+                        std::this_thread::yield();
+
+                        swappingMismatches += pinned->Predict(first) != pinned->Predict(second) ? 1 : 0;
+                        swappingReads++;
+                    }
+                });
+    }
+
+    std::size_t swappingPublishes = 0;
+
+    for (std::size_t v = 1; v <= 20000 || swappingReads.load() < 20000; v++, swappingPublishes++) {
+        swappingRegistry.Publish("m", RegressionModels::ModelSnapshot(RegressionModels::LinkKind::Identity, {static_cast<double>(v), static_cast<double>(v)}));
+
+        // Lets the readers run between publishes even on a single core.
+        std::this_thread::yield();
+    }
+
+    swapping = false;
+
+    for (std::thread &reader : swappingReaders) {
+        reader.join();
+    }
+
+    std::cout << "registry hot swap: " << swappingPublishes << " publishes during " << swappingReads.load() << " nested reads, "
+              << swappingMismatches.load() << " mismatches" << std::endl;
+
     const std::vector<std::vector<double>> design =
             {
-                    std::vector<double> {1, 2, 3},
-                    std::vector<double> {4, 5, 6},
-                    std::vector<double> {7, 8, 9}
+                    std::vector<double> {1, 2},
+                    std::vector<double> {2, 1},
+                    std::vector<double> {3, 5},
+                    std::vector<double> {4, 3},
+                    std::vector<double> {5, 8},
+                    std::vector<double> {6, 4}
             };
 
     const std::vector<double> response =
             {
+                    2,
+                    3,
                     7,
-                    8,
+                    6,
+                    12,
                     9
             };
 
     const std::vector<double> weights =
             {
+                    1,
+                    1,
+                    1,
                     1,
                     1,
                     1
             };
 
-    GeneralizedLinearModel linearModel(design, response, weights);
+    GeneralizedLinearModel linearModel(design, response, weights, nullptr, true);
 
     GeneralizedLinearModel poissonModel(design, response, weights, std::make_unique<PoissonDistribution>(), true);
 
+    for (double coefficient : linearModel.Coefficients()) {
+        std::cout << coefficient << std::endl;
+    }
+
+    for (double coefficient : poissonModel.Coefficients()) {
+        std::cout << coefficient << std::endl;
+    }
+
+    RegressionModels::AsyncFit<GeneralizedLinearModel> pending =
+            GeneralizedLinearModel::FitAsync(
+                    DesignMatrix(design, true),
+                    response,
+                    weights,
+                    std::make_unique<PoissonDistribution>());
+
+    std::unique_ptr<GeneralizedLinearModel> asyncModel = pending.Get();
+
+    std::cout << asyncModel->Iterations() << " " << asyncModel->Deviance() << std::endl;
+
+    // The vector exp and log against the extended-precision library functions, in units in the last place of the
+    // correctly rounded result, over arguments spanning the whole finite range of each.
+    std::mt19937_64 ulpGenerator(11);
+    std::vector<double> ulpArguments(1 << 20);
+    std::vector<double> ulpResults(ulpArguments.size());
+
+    const auto ulpError = [&](long double (*reference)(long double)) {
+        double worst = 0.0;
+
+        for (std::size_t i = 0; i < ulpArguments.size(); i++) {
+            const long double exact = reference(ulpArguments[i]);
+            const double rounded = std::abs(static_cast<double>(exact));
+            const double ulp = std::max(std::nextafter(rounded, std::numeric_limits<double>::infinity()) - rounded, std::numeric_limits<double>::denorm_min());
+
+            if (rounded != 0.0) {
+                worst = std::max(worst, static_cast<double>(std::abs(ulpResults[i] - exact) / ulp));
+            }
+        }
+
+        return worst;
+    };
+
+    for (double &argument : ulpArguments) {
+        argument = std::uniform_real_distribution<double>(-745.0, 709.0)(ulpGenerator);
+    }
+
+    Kernels::Active().Exponentiate(ulpArguments.data(), ulpArguments.size(), ulpResults.data());
+    const double expError = ulpError(expl);
+
+    for (double &argument : ulpArguments) {
+        argument = std::exp(std::uniform_real_distribution<double>(-744.0, 709.0)(ulpGenerator));
+    }
+
+    Kernels::Active().Logarithm(ulpArguments.data(), ulpArguments.size(), ulpResults.data());
+    const double logError = ulpError(logl);
+
+    std::cout << "kernels: " << Kernels::Name(Kernels::Active().Set) << " (exp within " << expError << " ulp, log within " << logError << " ulp)" << std::endl;
+
+    const RegressionModels::CompiledScorer<RegressionModels::LinkKind::Log> scorer(poissonModel.Snapshot());
+
+    const std::size_t scoringIterations = 10000000;
+
+    double scoringSink = 0.0;
+
+    const auto scoringStart = std::chrono::steady_clock::now();
+
+    for (std::size_t i = 0; i < scoringIterations; i++) {
+        const double observation[] = {1.0, static_cast<double>(i & 7), static_cast<double>(i & 3)};
+        scoringSink += scorer(observation);
+    }
+
+    const std::chrono::duration<double, std::nano> scoringElapsed = std::chrono::steady_clock::now() - scoringStart;
+
+    std::cout << "single-row scoring: " << scoringElapsed.count() / scoringIterations << " ns (" << scoringSink << ")" << std::endl;
+
+    std::mt19937_64 generator(20180101);
+    std::normal_distribution<double> normal;
+
+    DesignMatrix largeDesign(1 << 20, 8);
+    std::vector<double> largeWeights(largeDesign.RowCount());
+    std::vector<double> largeResponse(largeDesign.RowCount());
+
+    for (std::size_t i = 0; i < largeDesign.RowCount(); i++) {
+        for (std::size_t j = 0; j < largeDesign.ColumnCount(); j++) {
+            largeDesign(i, j) = normal(generator);
+        }
+
+        largeWeights[i] = std::abs(normal(generator));
+        largeResponse[i] = normal(generator);
+    }
+
+    for (const ReductionMode mode : {ReductionMode::Partitioned, ReductionMode::Reproducible}) {
+        const auto gramStart = std::chrono::steady_clock::now();
+
+        const NormalEquations equations = weightedGram(largeDesign, largeWeights, largeResponse, mode);
+
+        const std::chrono::duration<double, std::milli> gramElapsed = std::chrono::steady_clock::now() - gramStart;
+
+        std::cout << (mode == ReductionMode::Reproducible ? "reproducible" : "partitioned") << " gram: " << gramElapsed.count() << " ms (" << equations.Gram[1] << ")" << std::endl;
+    }
+
+    // The same normal equations streamed from a record file of (design, weight, response) with four chunks in flight.
+    const std::string recordPath = "gram_pipeline.records";
+
+    {
+        std::ofstream records(recordPath, std::ios::binary | std::ios::trunc);
+
+        for (std::size_t i = 0; i < largeDesign.RowCount(); i++) {
+            records.write(reinterpret_cast<const char *>(largeDesign.Row(i)), static_cast<std::streamsize>(largeDesign.ColumnCount() * sizeof(double)));
+            records.write(reinterpret_cast<const char *>(&largeWeights[i]), sizeof(double));
+            records.write(reinterpret_cast<const char *>(&largeResponse[i]), sizeof(double));
+        }
+    }
+
+    Streaming::RecordLayout recordLayout;
+    recordLayout.ColumnCount = largeDesign.ColumnCount() + 2;
+    recordLayout.WeightColumn = static_cast<long>(largeDesign.ColumnCount());
+    recordLayout.ResponseColumn = largeDesign.ColumnCount() + 1;
+
+    const Streaming::GramPipeline pipeline(recordPath, recordLayout);
+
+    const auto pipelineStart = std::chrono::steady_clock::now();
+    const NormalEquations streamed = pipeline.Run();
+    const std::chrono::duration<double, std::milli> pipelineElapsed = std::chrono::steady_clock::now() - pipelineStart;
+    const NormalEquations inMemory = weightedGram(largeDesign, largeWeights, largeResponse, ReductionMode::Reproducible);
+
+    std::cout << "streamed gram: " << pipelineElapsed.count() << " ms (" << streamed.Gram[1] - inMemory.Gram[1] << ")" << std::endl;
+
+    // A transform that fails part way through is reported by Run rather than stalling the pipeline.
+    try {
+        std::atomic<std::size_t> transformed(0);
+
+        pipeline.Run(
+                [&transformed](const double *, double &, double &) {
+                    if (++transformed == 300000) {
+                        throw std::runtime_error("transform failed");
+                    }
+                });
+    }
+    catch (const std::runtime_error &error) {
+        std::cout << "streamed gram: " << error.what() << std::endl;
+    }
+
+    std::remove(recordPath.c_str());
+
+    const std::size_t wide = 400;
+
+    std::vector<double> wideGram(wide * wide, 0.0);
+    std::vector<double> wideMoment(wide, 1.0);
+
+    for (std::size_t i = 0; i < 2 * wide; i++) {
+        std::vector<double> row(wide);
+
+        for (double &value : row) {
+            value = normal(generator);
+        }
+
+        WeightedGram::AccumulateRow(row.data(), wide, 1.0, 0.0, wideGram.data(), wideMoment.data());
+    }
+
+    for (std::size_t a = 0; a < wide; a++) {
+        for (std::size_t b = 0; b < a; b++) {
+            wideGram[a * wide + b] = wideGram[b * wide + a];
+        }
+    }
+
+    const auto doubleStart = std::chrono::steady_clock::now();
+    const std::vector<double> doubleSolution = solverCholesky(decompositionCholesky(wideGram, wide), wideMoment);
+    const auto mixedStart = std::chrono::steady_clock::now();
+    const std::vector<double> mixedSolution = solverMixedPrecision(wideGram, wideMoment);
+    const auto mixedEnd = std::chrono::steady_clock::now();
+
+    std::cout << "double solve: " << std::chrono::duration<double, std::milli>(mixedStart - doubleStart).count() << " ms, "
+              << "mixed solve: " << std::chrono::duration<double, std::milli>(mixedEnd - mixedStart).count() << " ms ("
+              << doubleSolution[0] - mixedSolution[0] << ")" << std::endl;
+
+    // The same system for a design whose columns range over twenty orders of magnitude, as when trade values in
+    // dollars sit next to indicators. Unscaled, the Gram matrix overflows single precision.
+    std::vector<double> scaledGram(wideGram);
+    std::vector<double> scaledMoment(wideMoment);
+
+    for (std::size_t a = 0; a < wide; a++) {
+        scaledMoment[a] *= std::pow(10.0, static_cast<double>(a % 20));
+
+        for (std::size_t b = 0; b < wide; b++) {
+            scaledGram[a * wide + b] *= std::pow(10.0, static_cast<double>(a % 20 + b % 20));
+        }
+    }
+
+    const auto unscaledStart = std::chrono::steady_clock::now();
+    const std::vector<double> unscaledSolution = solverMixedPrecision(scaledGram, scaledMoment);
+    const auto equilibratedStart = std::chrono::steady_clock::now();
+    const Equilibration equilibration(scaledGram, wide);
+    const std::vector<double> equilibratedSolution = equilibration.ApplyToVector(solverMixedPrecision(equilibration.ApplyToMatrix(scaledGram), equilibration.ApplyToVector(scaledMoment)));
+    const auto equilibratedEnd = std::chrono::steady_clock::now();
+
+    std::cout << "unscaled mixed solve: " << std::chrono::duration<double, std::milli>(equilibratedStart - unscaledStart).count() << " ms, "
+              << "equilibrated mixed solve: " << std::chrono::duration<double, std::milli>(equilibratedEnd - equilibratedStart).count() << " ms ("
+              << unscaledSolution[0] - equilibratedSolution[0] << ")" << std::endl;
+
+    // A single column, whose 1 x 1 Gram matrix is as long as its moment vector. Least squares gives b = 2.053333.
+    const std::vector<std::vector<double>> slopeDesign = {{1.0}, {2.0}, {3.0}, {4.0}};
+    const std::vector<double> slopeResponse = {2.0, 4.0, 6.0, 8.4};
+    const std::vector<double> slopeWeights(slopeResponse.size(), 1.0);
+
+    RegressionModels::FitOptions unequilibrated;
+    unequilibrated.Equilibrate = false;
+
+    const GeneralizedLinearModel slopeModel(DesignMatrix(slopeDesign), slopeResponse, slopeWeights);
+    const GeneralizedLinearModel unequilibratedSlopeModel(DesignMatrix(slopeDesign), slopeResponse, slopeWeights, nullptr, unequilibrated);
+
+    std::cout << "one-column fit: " << slopeModel.Coefficients()[0] << " equilibrated, "
+              << unequilibratedSlopeModel.Coefficients()[0] << " unequilibrated (2.053333)" << std::endl;
+
+    // Robust fits of the large design after one response in a hundred is replaced by a gross error.
+    std::vector<double> contaminatedResponse(largeResponse);
+
+    for (std::size_t i = 0; i < contaminatedResponse.size(); i += 100) {
+        contaminatedResponse[i] += 1000.0;
+    }
+
+    for (const std::shared_ptr<const IWeightFunction> &robust : {std::shared_ptr<const IWeightFunction>(std::make_shared<WeightFunctions::HuberWeightFunction>()), std::shared_ptr<const IWeightFunction>(std::make_shared<WeightFunctions::TukeyBisquareWeightFunction>())}) {
+        RegressionModels::FitOptions robustOptions;
+        robustOptions.Robust = robust;
+
+        const auto robustStart = std::chrono::steady_clock::now();
+        const GeneralizedLinearModel robustModel(largeDesign, contaminatedResponse, largeWeights, nullptr, robustOptions);
+        const std::chrono::duration<double, std::milli> robustElapsed = std::chrono::steady_clock::now() - robustStart;
+
+        std::cout << "robust fit (c = " << robust->Tuning() << "): " << robustElapsed.count() << " ms, " << robustModel.Iterations() << " iterations (scale " << robustModel.Scale() << ")" << std::endl;
+    }
+
+    std::vector<long> largeClusters(largeDesign.RowCount());
+
+    for (std::size_t i = 0; i < largeClusters.size(); i++) {
+        largeClusters[i] = static_cast<long>(i % 40);
+    }
+
+    const auto bootstrapStart = std::chrono::steady_clock::now();
+    const RegressionModels::WildClusterBootstrap bootstrap(largeDesign, largeResponse, largeWeights, largeClusters);
+    const auto replicatesStart = std::chrono::steady_clock::now();
+    const RegressionModels::BootstrapResult bootstrapResult = bootstrap.Test(1, 0.0, RegressionModels::BootstrapOptions{99999});
+    const auto bootstrapEnd = std::chrono::steady_clock::now();
+
+    std::cout << "wild cluster bootstrap: " << std::chrono::duration<double, std::milli>(replicatesStart - bootstrapStart).count() << " ms precomputation, "
+              << std::chrono::duration<double, std::milli>(bootstrapEnd - replicatesStart).count() << " ms for " << bootstrapResult.Replications << " replicates "
+              << "(t = " << bootstrapResult.Statistic << ", p = " << bootstrapResult.PValue << ")" << std::endl;
+
+    std::vector<long> largeEntities(largeDesign.RowCount());
+
+    for (std::size_t i = 0; i < largeEntities.size(); i++) {
+        largeEntities[i] = static_cast<long>(i / 16);
+    }
+
+    for (RegressionModels::PanelEstimator estimator : {RegressionModels::PanelEstimator::Within, RegressionModels::PanelEstimator::Between, RegressionModels::PanelEstimator::RandomEffects}) {
+        const auto panelStart = std::chrono::steady_clock::now();
+        const RegressionModels::PanelLinearModel panelModel(largeDesign, largeResponse, largeEntities, estimator);
+        const std::chrono::duration<double, std::milli> panelElapsed = std::chrono::steady_clock::now() - panelStart;
+
+        std::cout << "panel estimator " << static_cast<int>(estimator) << ": " << panelElapsed.count() << " ms (" << panelModel.Coefficients()[1] << ")" << std::endl;
+    }
+
+    // Six entities over four periods with a single regressor, so the within regression is one-dimensional.
+    std::vector<std::vector<double>> smallPanelDesign;
+    std::vector<double> smallPanelResponse;
+    std::vector<long> smallPanelEntities;
+
+    for (long entity = 0; entity < 6; entity++) {
+        for (long period = 0; period < 4; period++) {
+            const double x = static_cast<double>((entity * 7 + period * 3) % 5) + 0.5 * static_cast<double>(period);
+
+            smallPanelDesign.push_back({x});
+            smallPanelResponse.push_back(3.0 * static_cast<double>(entity) + 2.5 * x + 0.01 * static_cast<double>((entity + period) % 3 - 1));
+            smallPanelEntities.push_back(entity);
+        }
+    }
+
+    const RegressionModels::PanelLinearModel smallPanelModel(DesignMatrix(smallPanelDesign), smallPanelResponse, smallPanelEntities);
+
+    std::cout << "one-regressor within estimator: " << smallPanelModel.Coefficients()[1] << " (true slope 2.5)" << std::endl;
+
+    // Firms observed over ten years, with a random intercept and slope by firm crossed with a random intercept by year.
+    const std::size_t firms = 2000;
+    const std::size_t years = 10;
+
+    DesignMatrix mixedDesign(firms * years, 2);
+    std::vector<double> mixedResponse(firms * years);
+    std::vector<long> mixedFirms(firms * years);
+    std::vector<long> mixedYears(firms * years);
+
+    for (std::size_t firm = 0; firm < firms; firm++) {
+        const double intercept = normal(generator);
+        const double slope = 0.5 * normal(generator);
+
+        for (std::size_t year = 0; year < years; year++) {
+            const std::size_t row = firm * years + year;
+
+            mixedDesign(row, 0) = 1.0;
+            mixedDesign(row, 1) = normal(generator);
+            mixedFirms[row] = static_cast<long>(firm);
+            mixedYears[row] = static_cast<long>(2000 + year);
+            mixedResponse[row] = 1.0 + intercept + (2.0 + slope) * mixedDesign(row, 1) + 0.1 * static_cast<double>(year) + normal(generator);
+        }
+    }
+
+    const auto lmmStart = std::chrono::steady_clock::now();
+    const RegressionModels::LinearMixedModel mixedModel(
+            mixedDesign,
+            mixedResponse,
+            {RegressionModels::RandomEffect{CategoricalColumn(mixedFirms), true, {1}}, RegressionModels::RandomEffect{CategoricalColumn(mixedYears), true, {}}});
+    const std::chrono::duration<double, std::milli> lmmElapsed = std::chrono::steady_clock::now() - lmmStart;
+
+    std::cout << "mixed model: " << lmmElapsed.count() << " ms, " << mixedModel.Evaluations() << " evaluations (" << mixedModel.Coefficients()[1] << ", " << mixedModel.ResidualVariance() << ")" << std::endl;
+
+    const auto quantileStart = std::chrono::steady_clock::now();
+    const RegressionModels::QuantileRegressionModel medianModel(largeDesign, largeResponse);
+    const auto quantilesStart = std::chrono::steady_clock::now();
+    const std::vector<RegressionModels::QuantileRegressionModel> quantileModels = RegressionModels::QuantileRegressionModel::FitMany(largeDesign, largeResponse, {0.1, 0.25, 0.5, 0.75, 0.9});
+    const auto quantilesEnd = std::chrono::steady_clock::now();
+
+    std::cout << "median regression: " << std::chrono::duration<double, std::milli>(quantilesStart - quantileStart).count() << " ms, "
+              << medianModel.ProgramSize() << " rows in the program (" << medianModel.Coefficients()[0] << "), "
+              << "five quantiles: " << std::chrono::duration<double, std::milli>(quantilesEnd - quantilesStart).count() << " ms" << std::endl;
+
+    // An intercept-only median regression, whose normal equations are 1 x 1: the estimate is the sample median.
+    const std::vector<std::vector<double>> interceptDesign(101, std::vector<double>{1.0});
+    std::vector<double> interceptResponse(interceptDesign.size());
+
+    for (std::size_t i = 0; i < interceptResponse.size(); i++) {
+        interceptResponse[i] = 100.0 + static_cast<double>((i * 37) % interceptResponse.size());
+    }
+
+    const RegressionModels::QuantileRegressionModel interceptModel(DesignMatrix(interceptDesign), interceptResponse);
+
+    RegressionModels::FitOptions mixedPrecision;
+    mixedPrecision.MixedPrecision = true;
+
+    const GeneralizedLinearModel mixedSlopeModel(DesignMatrix(slopeDesign), slopeResponse, slopeWeights, nullptr, mixedPrecision);
+
+    std::cout << "intercept-only median: " << interceptModel.Coefficients()[0] << " (150), "
+              << "one-column mixed precision fit: " << mixedSlopeModel.Coefficients()[0] << " (2.053333)" << std::endl;
+
+    // A smooth effect of distance through a cubic B-spline with twenty columns, generated block by block, against the
+    // same columns materialized.
+    std::uniform_real_distribution<double> distances(1.0, 100.0);
+    std::vector<double> distance(largeDesign.RowCount());
+    std::vector<double> smoothResponse(largeDesign.RowCount());
+
+    for (std::size_t i = 0; i < distance.size(); i++) {
+        distance[i] = distances(generator);
+        smoothResponse[i] = sin(distance[i] / 10.0) + log(distance[i]) + normal(generator);
+    }
+
+    std::vector<double> splineKnots;
+
+    for (std::size_t k = 1; k <= 17; k++) {
+        splineKnots.push_back(1.0 + 99.0 * static_cast<double>(k) / 18.0);
+    }
+
+    const DesignMatrix splineDesign = DesignMatrix::Wrap(
+            distance.size(),
+            {},
+            {},
+            {std::make_shared<BSplineBasis>(distance.data(), 1, splineKnots, 1.0, 100.0)},
+            true);
+
+    DesignMatrix materializedSplineDesign(splineDesign.RowCount(), splineDesign.ColumnCount());
+
+    for (std::size_t i = 0; i < splineDesign.RowCount(); i++) {
+        for (std::size_t j = 0; j < splineDesign.ColumnCount(); j++) {
+            materializedSplineDesign(i, j) = splineDesign(i, j);
+        }
+    }
+
+    const auto splineStart = std::chrono::steady_clock::now();
+    const GeneralizedLinearModel splineModel(splineDesign, smoothResponse, largeWeights);
+    const auto materializedStart = std::chrono::steady_clock::now();
+    const GeneralizedLinearModel materializedSplineModel(materializedSplineDesign, smoothResponse, largeWeights);
+    const auto materializedEnd = std::chrono::steady_clock::now();
+
+    std::cout << "generated spline fit: " << std::chrono::duration<double, std::milli>(materializedStart - splineStart).count() << " ms, "
+              << "materialized spline fit: " << std::chrono::duration<double, std::milli>(materializedEnd - materializedStart).count() << " ms ("
+              << splineModel.Coefficients()[1] - materializedSplineModel.Coefficients()[1] << ", "
+              << materializedSplineDesign.RowCount() * materializedSplineDesign.ColumnCount() * sizeof(double) / (1 << 20) << " MB not materialized)" << std::endl;
+
+    // Distance by year and exporter by sector, generated block by block from the codes of the factors.
+    std::vector<long> tradeYears(distance.size());
+    std::vector<long> tradeExporters(distance.size());
+    std::vector<long> tradeSectors(distance.size());
+
+    for (std::size_t i = 0; i < distance.size(); i++) {
+        tradeYears[i] = static_cast<long>(2000 + generator() % 10);
+        tradeExporters[i] = static_cast<long>(generator() % 12);
+        tradeSectors[i] = static_cast<long>(generator() % 6);
+    }
+
+    const DesignMatrix interactionDesign = DesignMatrix::Wrap(
+            distance.size(),
+            {},
+            {},
+            {std::make_shared<InteractionColumns>(distance.data(), 1, std::vector<CategoricalColumn>{CategoricalColumn(tradeYears)}),
+             std::make_shared<InteractionColumns>(std::vector<CategoricalColumn>{CategoricalColumn(tradeExporters), CategoricalColumn(tradeSectors)}, true)},
+            true);
+
+    const auto interactionStart = std::chrono::steady_clock::now();
+    const GeneralizedLinearModel interactionModel(interactionDesign, smoothResponse, largeWeights);
+    const std::chrono::duration<double, std::milli> interactionElapsed = std::chrono::steady_clock::now() - interactionStart;
+
+    // The same interactions over the first rows, against their columns materialized. The generated design is read
+    // through the spans of its cells, so its normal equations must still equal those of the dense columns.
+    const std::size_t interactionCheckRows = 1 << 17;
+
+    const DesignMatrix interactionCheckDesign = DesignMatrix::Wrap(
+            interactionCheckRows,
+            {},
+            {},
+            {std::make_shared<InteractionColumns>(distance.data(), 1, std::vector<CategoricalColumn>{CategoricalColumn(std::vector<long>(tradeYears.begin(), tradeYears.begin() + interactionCheckRows))}),
+             std::make_shared<InteractionColumns>(
+                     std::vector<CategoricalColumn>{
+                             CategoricalColumn(std::vector<long>(tradeExporters.begin(), tradeExporters.begin() + interactionCheckRows)),
+                             CategoricalColumn(std::vector<long>(tradeSectors.begin(), tradeSectors.begin() + interactionCheckRows))},
+                     true)},
+            true);
+
+    DesignMatrix materializedInteractionDesign(interactionCheckRows, interactionCheckDesign.ColumnCount());
+
+    for (std::size_t i = 0; i < interactionCheckRows; i++) {
+        for (std::size_t j = 0; j < interactionCheckDesign.ColumnCount(); j++) {
+            materializedInteractionDesign(i, j) = interactionCheckDesign(i, j);
+        }
+    }
+
+    const std::vector<double> interactionCheckResponse(smoothResponse.begin(), smoothResponse.begin() + interactionCheckRows);
+    const std::vector<double> interactionCheckWeights(interactionCheckRows, 1.0);
+
+    const GeneralizedLinearModel interactionCheckModel(interactionCheckDesign, interactionCheckResponse, interactionCheckWeights);
+    const GeneralizedLinearModel materializedInteractionModel(materializedInteractionDesign, interactionCheckResponse, interactionCheckWeights);
+
+    double interactionDifference = 0.0;
+
+    for (std::size_t j = 0; j < interactionCheckModel.VariableCount(); j++) {
+        interactionDifference = std::max(interactionDifference, std::abs(interactionCheckModel.Coefficients()[j] - materializedInteractionModel.Coefficients()[j]));
+    }
+
+    std::cout << "generated interaction fit: " << interactionElapsed.count() << " ms, " << interactionDesign.ColumnCount() << " columns ("
+              << interactionDesign.RowCount() * interactionDesign.ColumnCount() * sizeof(double) / (1 << 20) << " MB not materialized), "
+              << interactionDifference << " from the materialized fit of the first " << interactionCheckRows << " rows" << std::endl;
+
+    // A gravity equation compiled from a formula, with the pair fixed effects absorbed.
+    Formulas::Dataset gravity;
+    std::vector<double> gravityTrade(distance.size());
+    std::vector<double> gravityContiguity(distance.size());
+    std::vector<long> gravityPairs(distance.size());
+
+    for (std::size_t i = 0; i < distance.size(); i++) {
+        const long importer = static_cast<long>(generator() % 50);
+
+        gravityPairs[i] = tradeExporters[i] * 100 + importer;
+        gravityContiguity[i] = importer % 7 == 0 ? 1.0 : 0.0;
+        gravityTrade[i] = exp(2.0 - 0.8 * log(distance[i]) + 0.5 * gravityContiguity[i] + 0.01 * static_cast<double>(importer) + normal(generator));
+    }
+
+    gravity.Add("trade", std::move(gravityTrade));
+    gravity.Add("dist", distance);
+    gravity.Add("contig", std::move(gravityContiguity));
+    gravity.Add("exp", CategoricalColumn(tradeExporters));
+    gravity.Add("year", CategoricalColumn(tradeYears));
+    gravity.Add("pair", CategoricalColumn(gravityPairs));
+
+    const auto planStart = std::chrono::steady_clock::now();
+    const Formulas::ColumnPlan gravityPlan("log(trade) ~ log(dist) + contig + i.exp#i.year, absorb(pair)", gravity);
+    const auto gravityStart = std::chrono::steady_clock::now();
+    const GeneralizedLinearModel gravityModel = gravityPlan.Fit();
+    const auto gravityEnd = std::chrono::steady_clock::now();
+
+    std::cout << "formula plan: " << std::chrono::duration<double, std::milli>(gravityStart - planStart).count() << " ms, "
+              << "fit: " << std::chrono::duration<double, std::milli>(gravityEnd - gravityStart).count() << " ms, "
+              << gravityPlan.ColumnNames().size() << " columns, " << gravityPlan.AbsorbedLevels() << " absorbed levels ("
+              << gravityPlan.ColumnNames()[0] << " = " << gravityModel.Coefficients()[0] << ")" << std::endl;
+
+    // The same panel with missing distances and zero trade flows, deleted listwise by the validity masks.
+    Formulas::Dataset panel;
+    std::vector<double> panelTrade(gravity.Numeric("trade"));
+    std::vector<double> panelDistance(distance);
+
+    for (std::size_t i = 0; i < distance.size(); i++) {
+        if (generator() % 20 == 0) {
+            panelDistance[i] = std::numeric_limits<double>::quiet_NaN();
+        }
+
+        if (generator() % 25 == 0) {
+            panelTrade[i] = 0.0;
+        }
+    }
+
+    panel.Add("trade", std::move(panelTrade));
+    panel.Add("dist", std::move(panelDistance));
+    panel.Add("contig", gravity.Numeric("contig"));
+    panel.Add("exp", CategoricalColumn(tradeExporters));
+    panel.Add("year", CategoricalColumn(tradeYears));
+    panel.Add("pair", CategoricalColumn(gravityPairs));
+
+    const auto panelStart = std::chrono::steady_clock::now();
+    const Formulas::ColumnPlan panelPlan("log(trade) ~ log(dist) + contig + i.exp#i.year, absorb(pair)", panel);
+    const GeneralizedLinearModel panelModel = panelPlan.Fit();
+    const auto panelEnd = std::chrono::steady_clock::now();
+
+    std::cout << "missing values: " << std::chrono::duration<double, std::milli>(panelEnd - panelStart).count() << " ms, "
+              << panelModel.ObservationCount() << " of " << distance.size() << " observations valid ("
+              << panelPlan.ColumnNames()[0] << " = " << panelModel.Coefficients()[0] << ")" << std::endl;
+
+    // Collinearity diagnostics of the gravity fit, from its factorization rather than one auxiliary regression per
+    // column.
+    const auto diagnosticsStart = std::chrono::steady_clock::now();
+    const std::vector<double> inflation = gravityModel.VarianceInflationFactors();
+    const std::vector<double> conditionIndices = gravityModel.ConditionIndices();
+    const auto diagnosticsEnd = std::chrono::steady_clock::now();
+
+    std::cout << "collinearity diagnostics: " << std::chrono::duration<double, std::milli>(diagnosticsEnd - diagnosticsStart).count() << " ms ("
+              << gravityPlan.ColumnNames()[0] << " VIF = " << inflation[0] << ", condition number = " << conditionIndices.back() << ")" << std::endl;
+
     for (auto item : SpecialFunctions::FactorialTemplate<170>{}.create_values()) {
         std::cout << item << std::endl;
     }
@@ -52,4 +1158,4 @@ int main()
 
     std::cout << "Hello, World!" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
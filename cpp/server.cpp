@@ -0,0 +1,105 @@
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <pthread.h>
+#include "ModelRegistry.h"
+#include "ModelSnapshot.h"
+#include "ScoringServer.h"
+
+using RegressionModels::ModelSnapshot;
+using Serving::ModelRegistry;
+using Serving::ScoringServer;
+
+namespace {
+    void PublishAll(ModelRegistry &registry, const std::vector<std::pair<std::string, std::string>> &models)
+    {
+        for (const auto &model : models) {
+            try {
+                const std::uint64_t version = registry.Publish(model.first, ModelSnapshot::Load(model.second));
+                std::cerr << "published " << model.first << "@" << version << std::endl;
+            }
+            catch (const std::exception &exception) {
+                std::cerr << "unable to load " << model.second << ": " << exception.what() << std::endl;
+            }
+        }
+    }
+}
+
+/// <summary>
+/// Serves the given snapshot files. SIGHUP reloads every file and publishes it as a new version without interrupting
+/// scoring; SIGINT and SIGTERM stop the server.
+/// </summary>
+int main(int argc, char **argv)
+{
+    if (argc < 3) {
+        std::cerr << "usage: server <socket> <name>=<snapshot>... [--budget-us N] [--max-batch N]" << std::endl;
+        return 2;
+    }
+
+    Serving::BatchOptions options;
+
+    std::vector<std::pair<std::string, std::string>> models;
+
+    for (int i = 2; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument == "--budget-us" && i + 1 < argc) {
+            options.LatencyBudget = std::chrono::microseconds(std::strtol(argv[++i], nullptr, 10));
+        }
+        else if (argument == "--max-batch" && i + 1 < argc) {
+            options.MaxBatchSize = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (argument.find('=') != std::string::npos) {
+            models.emplace_back(argument.substr(0, argument.find('=')), argument.substr(argument.find('=') + 1));
+        }
+        else {
+            std::cerr << "unrecognized argument: " << argument << std::endl;
+            return 2;
+        }
+    }
+
+    // Signals are taken synchronously by a dedicated thread, so every other thread must block them.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGHUP);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    ModelRegistry registry;
+
+    PublishAll(registry, models);
+
+    ScoringServer server(argv[1], registry, options);
+
+    std::thread control(
+            [&]() {
+                while (true) {
+                    int signal = 0;
+
+                    if (sigwait(&signals, &signal) != 0 || signal != SIGHUP) {
+                        server.Stop();
+                        return;
+                    }
+
+                    PublishAll(registry, models);
+                }
+            });
+
+    try {
+        server.Run();
+    }
+    catch (...) {
+        pthread_kill(control.native_handle(), SIGTERM);
+        control.join();
+        throw;
+    }
+
+    control.join();
+
+    return 0;
+}